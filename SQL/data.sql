@@ -2,9 +2,11 @@
 -- Sample Data for Project Templates
 -- =================================================================
 
--- Note: The content in these INSERT statements should be a single line.
--- C++ string literals in the original generator were multi-line for readability,
--- but here they are represented as a single string with newline characters (\n).
+-- Note: Statements may span several lines and may insert several rows at once,
+-- but each template body is a single string literal. C++ string literals in the
+-- original generator were multi-line for readability, but here they are
+-- represented as a single string with newline characters (\n).
+-- Templates may use {{#if}}, {{#each}} and {{> partial}} tags; see TemplateProgram.h.
 
 -- Template for LICENSE file
 INSERT INTO templates (project_name, file_path, content) VALUES (
@@ -20,6 +22,55 @@ INSERT INTO templates (project_name, file_path, content) VALUES (
     '# {{project_name}}\n\n## Description\n{{description}}\n\n## Goal\n{{goal}}\n\n## Building\n\n### Using Makefile\n```bash\nmake\n```\n\n## Author\n{{author}}\n'
 );
 
+-- Template for CMakeLists.txt; branches on project type, tests and the Likert Scale module
+INSERT INTO templates (project_name, file_path, content) VALUES (
+    'generic',
+    'CMakeLists.txt',
+    'cmake_minimum_required(VERSION 3.12)\nproject({{name}} VERSION {{version}})\n\nset(CMAKE_CXX_STANDARD 17)\nset(CMAKE_CXX_STANDARD_REQUIRED ON)\n\n{{> partials/cmake_profiles}}# Include directories\ninclude_directories(include)\n\n{{#if executable}}# Executable\nadd_executable({{name}}\n    src/main.cpp\n{{> partials/cmake_sources}})\n\n{{else if static_library}}# Static Library\nadd_library({{name}} STATIC\n{{> partials/cmake_sources}})\n\n{{else if shared_library}}# Shared Library\nadd_library({{name}} SHARED\n{{> partials/cmake_sources}})\n# Calls within the library bind locally instead of going through the PLT\nif(CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang" AND NOT APPLE)\n    target_compile_options({{name}} PRIVATE -fno-plt -fno-semantic-interposition)\nendif()\n\n{{else if header_only}}# Header-only Library\nadd_library({{name}} INTERFACE)\ntarget_include_directories({{name}} INTERFACE include)\n\n{{else if unit_test}}# Test Executable\nenable_testing()\nadd_executable({{name}}\n    src/main.cpp\n{{> partials/cmake_sources}})\nadd_test(NAME {{name}} COMMAND {{name}})\n\n{{/if}}{{#if includeTests}}{{#unless unit_test}}# Tests\nenable_testing()\nadd_executable({{name}}_tests\n    tests/test_{{name}}.cpp\n)\n{{#if library}}target_link_libraries({{name}}_tests PRIVATE {{name}})\n{{/if}}add_test(NAME {{name}}_tests COMMAND {{name}}_tests)\n\n{{/unless}}{{/if}}{{#if dependencies}}# Dependencies\ntarget_link_libraries({{name}} {{#if header_only}}INTERFACE{{else}}PRIVATE{{/if}}{{#each dependencies}} {{this}}{{/each}})\n\n{{/if}}{{#unless header_only}}# Compiler flags\ntarget_compile_options({{name}} PRIVATE\n    -Wall -Wextra -Wpedantic\n)\n\n{{/unless}}# Installation\n{{#unless header_only}}install(TARGETS {{name}} DESTINATION {{#if library}}lib{{else}}bin{{/if}})\n{{/unless}}install(FILES include/{{name}}.h DESTINATION include)\n'
+);
+
+-- Partial: build profiles (LTO, -march=native, two-phase PGO) selected by CMakePresets.json
+INSERT INTO templates (project_name, file_path, content) VALUES (
+    'generic',
+    'partials/cmake_profiles',
+    '# Build profiles. Without a preset this is a Release build with link-time\n# optimization; CMakePresets.json selects the others:\n#   cmake --preset native        Release tuned for this machine (-march=native)\n#   cmake --preset pgo-generate  Instrumented build: build it, run a typical workload,\n#   cmake --preset pgo-use       then rebuild in the same directory with the profile\nif(NOT CMAKE_BUILD_TYPE AND NOT CMAKE_CONFIGURATION_TYPES)\n    set(CMAKE_BUILD_TYPE Release CACHE STRING "Build type" FORCE)\nendif()\noption(ENABLE_LTO "Link-time optimization outside Debug builds" ON)\noption(ENABLE_NATIVE_ARCH "Tune for the building machine (-march=native)" OFF)\nset(PGO_PHASE OFF CACHE STRING "Profile-guided optimization: OFF, GENERATE or USE")\nset_property(CACHE PGO_PHASE PROPERTY STRINGS OFF GENERATE USE)\nset(PGO_DIR "${CMAKE_BINARY_DIR}/pgo-profiles" CACHE PATH "Where PGO profiles are written and read")\n\nif(ENABLE_LTO AND NOT CMAKE_BUILD_TYPE STREQUAL "Debug")\n    include(CheckIPOSupported)\n    check_ipo_supported(RESULT lto_supported OUTPUT lto_error)\n    if(lto_supported)\n        set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)\n    else()\n        message(WARNING "Link-time optimization is not available: ${lto_error}")\n    endif()\nendif()\nif(CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang")\n    if(ENABLE_NATIVE_ARCH)\n        add_compile_options(-march=native)\n    endif()\n    if(PGO_PHASE STREQUAL "GENERATE")\n        add_compile_options(-fprofile-generate=${PGO_DIR})\n        string(APPEND CMAKE_EXE_LINKER_FLAGS " -fprofile-generate=${PGO_DIR}")\n        string(APPEND CMAKE_SHARED_LINKER_FLAGS " -fprofile-generate=${PGO_DIR}")\n    elseif(PGO_PHASE STREQUAL "USE")\n        # Clang needs the raw profiles merged first:\n        #   llvm-profdata merge -o ${PGO_DIR}/default.profdata ${PGO_DIR}/*.profraw\n        add_compile_options(-fprofile-use=${PGO_DIR})\n        if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")\n            add_compile_options(-fprofile-correction -Wno-missing-profile)\n        endif()\n    endif()\nendif()\n\n'
+);
+
+-- Template for CMakePresets.json; one preset per build profile
+INSERT INTO templates (project_name, file_path, content) VALUES (
+    'generic',
+    'CMakePresets.json',
+    '{\n    "version": 3,\n    "cmakeMinimumRequired": {\n        "major": 3,\n        "minor": 21,\n        "patch": 0\n    },\n    "configurePresets": [\n        {\n            "name": "release",\n            "displayName": "Release with link-time optimization",\n            "binaryDir": "${sourceDir}/build/release",\n            "cacheVariables": {\n                "CMAKE_BUILD_TYPE": "Release",\n                "ENABLE_LTO": "ON"\n            }\n        },\n        {\n            "name": "debug",\n            "displayName": "Debug",\n            "binaryDir": "${sourceDir}/build/debug",\n            "cacheVariables": {\n                "CMAKE_BUILD_TYPE": "Debug",\n                "ENABLE_LTO": "OFF"\n            }\n        },\n        {\n            "name": "native",\n            "inherits": "release",\n            "displayName": "Release tuned for this machine",\n            "binaryDir": "${sourceDir}/build/native",\n            "cacheVariables": {\n                "ENABLE_NATIVE_ARCH": "ON"\n            }\n        },\n        {\n            "name": "pgo-generate",\n            "inherits": "release",\n            "displayName": "PGO step 1: instrumented build",\n            "binaryDir": "${sourceDir}/build/pgo",\n            "cacheVariables": {\n                "PGO_PHASE": "GENERATE"\n            }\n        },\n        {\n            "name": "pgo-use",\n            "inherits": "pgo-generate",\n            "displayName": "PGO step 2: optimized with the recorded profile",\n            "cacheVariables": {\n                "PGO_PHASE": "USE"\n            }\n        }\n    ],\n    "buildPresets": [\n        { "name": "release", "configurePreset": "release" },\n        { "name": "debug", "configurePreset": "debug" },\n        { "name": "native", "configurePreset": "native" },\n        { "name": "pgo-generate", "configurePreset": "pgo-generate" },\n        { "name": "pgo-use", "configurePreset": "pgo-use" }\n    ]\n}\n'
+);
+
+-- Partial: source list shared by every CMake target kind
+INSERT INTO templates (project_name, file_path, content) VALUES (
+    'generic',
+    'partials/cmake_sources',
+    '    src/{{name}}.cpp\n{{#if includeLikertScale}}    src/LikertScale.cpp\n{{/if}}'
+);
+
+-- Template for Makefile; release (the default), debug, NATIVE=1 and pgo profiles
+INSERT INTO templates (project_name, file_path, content) VALUES (
+    'generic',
+    'Makefile',
+    '# Makefile for {{name}}\n{{#if header_only}}#\n# {{name}} is header-only: `make` checks that the header compiles on its own\n# and `make install` copies it.\n\nCXX = g++\nCXXFLAGS = -std=c++17 -Wall -Wextra -Wpedantic -Iinclude\nHEADER = include/{{name}}.h\n\n.PHONY: all clean install\n\nall:\n\t$(CXX) $(CXXFLAGS) -fsyntax-only -x c++ $(HEADER)\n\nclean:\n\ninstall:\n\tcp $(HEADER) /usr/local/include/\n{{else}}#\n# `make` builds the release profile: -O3 with link-time optimization.\n#   make debug           Unoptimized, with debug information\n#   make NATIVE=1        Release tuned for this machine (-march=native)\n{{#if library}}#   make pgo PGO_TRAIN=<command>\n#                        Instrumented build, a training run of <command>, then\n#                        a rebuild optimized with the recorded profile. The\n#                        command must run a program that uses the instrumented\n#                        library{{#if static_library}} and is linked with -fprofile-generate{{/if}}.\n{{else}}#   make pgo             Instrumented build, a training run of PGO_TRAIN, then\n#                        a rebuild optimized with the recorded profile\n{{/if}}\nCXX = g++\n{{#if static_library}}AR = gcc-ar\n{{/if}}CXXFLAGS = -std=c++17 -Wall -Wextra -Wpedantic -Iinclude\n{{#if shared_library}}# Calls within the library bind locally instead of going through the PLT\nCXXFLAGS += -fPIC -fno-plt -fno-semantic-interposition\n{{/if}}LDFLAGS =\nSRCDIR = src\nOBJDIR = obj\nSOURCES = $(wildcard $(SRCDIR)/*.cpp)\nOBJECTS = $(SOURCES:$(SRCDIR)/%.cpp=$(OBJDIR)/%.o)\nTARGET = {{#if static_library}}lib{{name}}.a{{else if shared_library}}lib{{name}}.so{{else}}{{name}}{{/if}}\n{{#if dependencies}}LDLIBS ={{#each dependencies}} -l{{this}}{{/each}}\n{{/if}}\nRELEASE_FLAGS = -O3 -DNDEBUG -flto=auto\nifeq ($(NATIVE),1)\nRELEASE_FLAGS += -march=native\nendif\nPGO_DIR = $(CURDIR)/pgo-profiles\n{{#unless library}}PGO_TRAIN = ./$(TARGET)\n{{/unless}}\n.PHONY: all clean debug release pgo pgo-generate pgo-use\n\nall: release\n\n$(TARGET): $(OBJECTS)\n{{#if static_library}}\t$(AR) rcs $@ $(OBJECTS)\n{{else}}\t$(CXX){{#if shared_library}} -shared{{/if}} $(LDFLAGS) $(OBJECTS) -o $@{{#if dependencies}} $(LDLIBS){{/if}}\n{{/if}}\n$(OBJDIR)/%.o: $(SRCDIR)/%.cpp | $(OBJDIR)\n\t$(CXX) $(CXXFLAGS) -c $< -o $@\n\n$(OBJDIR):\n\tmkdir -p $(OBJDIR)\n\ndebug: CXXFLAGS += -g -DDEBUG\ndebug: $(TARGET)\n\nrelease: CXXFLAGS += $(RELEASE_FLAGS)\nrelease: LDFLAGS += $(RELEASE_FLAGS)\nrelease: $(TARGET)\n\npgo-generate: CXXFLAGS += $(RELEASE_FLAGS) -fprofile-generate=$(PGO_DIR)\npgo-generate: LDFLAGS += $(RELEASE_FLAGS) -fprofile-generate=$(PGO_DIR)\npgo-generate: $(TARGET)\n\npgo-use: CXXFLAGS += $(RELEASE_FLAGS) -fprofile-use=$(PGO_DIR) -fprofile-correction -Wno-missing-profile\npgo-use: LDFLAGS += $(RELEASE_FLAGS) -fprofile-use=$(PGO_DIR)\npgo-use: $(TARGET)\n\n# Both phases build in $(OBJDIR), so the profile matches the objects it describes\npgo:\n{{#if library}}\t$(if $(PGO_TRAIN),,$(error Set PGO_TRAIN to a command that exercises the library: make pgo PGO_TRAIN=./bench))\n{{/if}}\trm -rf $(PGO_DIR)\n\t$(MAKE) clean\n\t$(MAKE) pgo-generate\n\t$(PGO_TRAIN)\n\t$(MAKE) clean\n\t$(MAKE) pgo-use\n\nclean:\n\trm -rf $(OBJDIR) $(TARGET)\n\ninstall: $(TARGET)\n{{#if library}}\tcp $(TARGET) /usr/local/lib/\n\tcp include/{{name}}.h /usr/local/include/\n{{else}}\tcp $(TARGET) /usr/local/bin/\n{{/if}}{{/if}}'
+);
+
+-- Template for .gitignore file
+INSERT INTO templates (project_name, file_path, content) VALUES (
+    'generic',
+    '.gitignore',
+    '# Compiled Object files\n*.slo\n*.lo\n*.o\n*.obj\n\n# Precompiled Headers\n*.gch\n*.pch\n\n# Compiled Dynamic libraries\n*.so\n*.dylib\n*.dll\n\n# Fortran module files\n*.mod\n*.smod\n\n# Compiled Static libraries\n*.lai\n*.la\n*.a\n*.lib\n\n# Executables\n*.exe\n*.out\n*.app\n\n# Build directories\nbuild/\nobj/\nbin/\npgo-profiles/\n\n# IDE files\n.vscode/\n.vs/\n*.vcxproj*\n*.sln\n\n# CMake\nCMakeCache.txt\nCMakeFiles/\ncmake_install.cmake\nMakefile\n\n# Debug files\n*.dSYM/\n*.su\n*.idb\n*.pdb\n\n# Generator manifest\n.template-manifest\n\n# Project specific\n{{name}}\n{{name}}_tests\n'
+);
+
+-- Template for the Likert Scale module header
+INSERT INTO templates (project_name, file_path, content) VALUES (
+    'generic',
+    'include/LikertScale.h',
+    '#ifndef LIKERT_SCALE_H\n#define LIKERT_SCALE_H\n\n#include <string>\n#include <vector>\n\n/**\n * @class LikertScale\n * @brief A simple class to display a Likert scale question and get a response.\n */\nclass LikertScale {\npublic:\n    /**\n     * @brief Construct a new Likert Scale object\n     * @param question The question to ask the user.\n     * @param options The list of options for the scale (e.g., "Strongly Disagree" to "Strongly Agree").\n     */\n    LikertScale(const std::string& question, const std::vector<std::string>& options);\n\n    /**\n     * @brief Displays the question and options, then waits for and validates user input.\n     * @return The user''s choice as an integer (1-based index).\n     */\n    int displayAndGetResponse();\n\nprivate:\n    std::string question_;\n    std::vector<std::string> options_;\n};\n\n#endif // LIKERT_SCALE_H\n'
+);
+
 -- =================================================================
 -- End of Sample Data
 -- =================================================================
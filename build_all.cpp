@@ -23,6 +23,7 @@ struct BuildTarget {
     std::string output_name;
     std::string description;
     std::vector<std::string> dependencies;
+    std::string post_build{};  // Command run after a successful build, e.g. to generate sources
 };
 
 class ProjectBuilder {
@@ -33,12 +34,35 @@ private:
     
     void initializeTargets() {
         targets = {
+            {
+                "template_embedder",
+                "src/template_embedder.cpp",
+                "template_embedder",
+                "Template Embedder (SQL -> constexpr header)",
+                {"src/TemplateLoader.cpp", "src/MappedFile.cpp", "src/CompiledTemplate.cpp", "src/TemplateSink.cpp", "src/TemplateBundle.cpp", "src/SqlScanner.cpp", "src/SqlDecode.cpp", "src/TemplateIndex.cpp", "src/ThreadPool.cpp", "src/TemplateMetrics.cpp", "src/ContentPool.cpp", "src/RenderCache.cpp", "src/TemplateProgram.cpp", "src/EmbeddedTemplates.cpp", "src/GeneratedSource.cpp"},
+                "./template_embedder SQL/data.sql src/DefaultTemplates.h kDefaultTemplates"
+            },
+            {
+                "template_precompiler",
+                "src/template_precompiler.cpp",
+                "template_precompiler",
+                "Template Precompiler (SQL -> C++ render functions)",
+                {"src/TemplateLoader.cpp", "src/MappedFile.cpp", "src/CompiledTemplate.cpp", "src/TemplateSink.cpp", "src/TemplateBundle.cpp", "src/SqlScanner.cpp", "src/SqlDecode.cpp", "src/TemplateIndex.cpp", "src/ThreadPool.cpp", "src/TemplateMetrics.cpp", "src/ContentPool.cpp", "src/RenderCache.cpp", "src/TemplatePrecompiler.cpp", "src/TemplateProgram.cpp", "src/GeneratedSource.cpp"},
+                "./template_precompiler SQL/data.sql src/PrecompiledTemplates.h"
+            },
             {
                 "template_generator",
-                "template_generator.cpp",
+                "src/template_generator.cpp",
                 "template_generator",
                 "Advanced C++ Template Generator",
-                {}
+                {"src/TemplateLoader.cpp", "src/MappedFile.cpp", "src/CompiledTemplate.cpp", "src/TemplateSink.cpp", "src/TemplateBundle.cpp", "src/SqlScanner.cpp", "src/SqlDecode.cpp", "src/TemplateIndex.cpp", "src/ThreadPool.cpp", "src/TemplateMetrics.cpp", "src/ContentPool.cpp", "src/RenderCache.cpp", "src/TemplateProgram.cpp", "src/OutputPlan.cpp", "src/ProjectManifest.cpp", "src/TarWriter.cpp", "src/TextArena.cpp"}
+            },
+            {
+                "template_bundler",
+                "src/template_bundler.cpp",
+                "template_bundler",
+                "Template Bundle Compiler (SQL -> .qmtb)",
+                {"src/TemplateLoader.cpp", "src/MappedFile.cpp", "src/CompiledTemplate.cpp", "src/TemplateSink.cpp", "src/TemplateBundle.cpp", "src/SqlScanner.cpp", "src/SqlDecode.cpp", "src/TemplateIndex.cpp", "src/ThreadPool.cpp", "src/TemplateMetrics.cpp", "src/ContentPool.cpp", "src/RenderCache.cpp", "src/TemplateProgram.cpp"}
             },
             {
                 "test_framework",
@@ -54,6 +78,13 @@ private:
                 "Unit Tests for Template Generator",
                 {"tests/test_framework.cpp"}
             },
+            {
+                "loader_tests",
+                "tests/test_template_loader.cpp",
+                "run_loader_tests",
+                "Unit Tests for Template Loader",
+                {"tests/test_framework.cpp", "src/TemplateLoader.cpp", "src/MappedFile.cpp", "src/CompiledTemplate.cpp", "src/TemplateSink.cpp", "src/TemplateBundle.cpp", "src/SqlScanner.cpp", "src/SqlDecode.cpp", "src/TemplateIndex.cpp", "src/ThreadPool.cpp", "src/TemplateMetrics.cpp", "src/ContentPool.cpp", "src/RenderCache.cpp", "src/EmbeddedTemplates.cpp", "src/GeneratedSource.cpp", "src/TemplatePrecompiler.cpp", "src/TemplateProgram.cpp", "src/OutputPlan.cpp", "src/ProjectManifest.cpp", "src/TarWriter.cpp", "src/TextArena.cpp"}
+            },
             {
                 "thought_record",
                 "cbt_apps/thought_record_journal.cpp",
@@ -108,6 +139,13 @@ private:
         int result = std::system(command.c_str());
         if (result == 0) {
             std::cout << "✅ Successfully built " << target.name << std::endl;
+            if (!target.post_build.empty()) {
+                std::cout << "Running: " << target.post_build << std::endl;
+                if (std::system(target.post_build.c_str()) != 0) {
+                    std::cerr << "❌ Post-build step failed for " << target.name << std::endl;
+                    return false;
+                }
+            }
             return true;
         } else {
             std::cerr << "❌ Failed to build " << target.name << std::endl;
@@ -0,0 +1,99 @@
+#include "CompiledTemplate.h"
+#include "TemplateSink.h"
+#include <algorithm>
+#include <cstring>
+
+CompiledTemplate CompiledTemplate::compile(std::string_view source) {
+    CompiledTemplate compiled;
+    size_t literal_start = 0;
+    size_t pos = source.find("{{");
+
+    while (pos != std::string_view::npos) {
+        size_t close = source.find("}}", pos + 2);
+        if (close == std::string_view::npos) {
+            break; // Unterminated placeholder; the rest is literal text
+        }
+        std::string_view token = source.substr(pos, close + 2 - pos);
+        if (!isPlaceholderToken(token)) {
+            pos = source.find("{{", pos + 1);
+            continue;
+        }
+
+        if (pos > literal_start) {
+            compiled.segments_.push_back({Segment::Kind::Literal, source.substr(literal_start, pos - literal_start), 0});
+            compiled.literal_size_ += pos - literal_start;
+        }
+
+        auto existing = std::find(compiled.placeholders_.begin(), compiled.placeholders_.end(), token);
+        std::uint32_t index = static_cast<std::uint32_t>(existing - compiled.placeholders_.begin());
+        if (existing == compiled.placeholders_.end()) {
+            compiled.placeholders_.emplace_back(token);
+        }
+        compiled.segments_.push_back({Segment::Kind::Placeholder, token, index});
+
+        literal_start = close + 2;
+        pos = source.find("{{", literal_start);
+    }
+
+    if (literal_start < source.size()) {
+        compiled.segments_.push_back({Segment::Kind::Literal, source.substr(literal_start), 0});
+        compiled.literal_size_ += source.size() - literal_start;
+    }
+    return compiled;
+}
+
+std::vector<std::string_view> CompiledTemplate::resolve(const std::map<std::string, std::string>& substitutions) const {
+    // Each distinct placeholder is looked up once per render.
+    std::vector<std::string_view> values(placeholders_.size());
+    for (size_t i = 0; i < placeholders_.size(); ++i) {
+        auto it = substitutions.find(placeholders_[i]);
+        values[i] = (it != substitutions.end()) ? std::string_view(it->second) : std::string_view(placeholders_[i]);
+    }
+    return values;
+}
+
+std::string CompiledTemplate::render(const std::map<std::string, std::string>& substitutions) const {
+    std::vector<std::string_view> values = resolve(substitutions);
+
+    size_t total = literal_size_;
+    for (const auto& segment : segments_) {
+        if (segment.kind == Segment::Kind::Placeholder) {
+            total += values[segment.placeholder].size();
+        }
+    }
+
+    std::string output(total, '\0');
+    char* out = output.data();
+    for (const auto& segment : segments_) {
+        std::string_view piece = (segment.kind == Segment::Kind::Literal) ? segment.text : values[segment.placeholder];
+        std::memcpy(out, piece.data(), piece.size());
+        out += piece.size();
+    }
+    return output;
+}
+
+void CompiledTemplate::renderTo(const std::map<std::string, std::string>& substitutions, TemplateSink& sink) const {
+    std::vector<std::string_view> values = resolve(substitutions);
+    for (const auto& segment : segments_) {
+        sink.write((segment.kind == Segment::Kind::Literal) ? segment.text : values[segment.placeholder]);
+    }
+}
+
+bool CompiledTemplate::isPlaceholderToken(std::string_view key) {
+    if (key.size() < 5 || key.substr(0, 2) != "{{" || key.substr(key.size() - 2) != "}}") {
+        return false;
+    }
+    std::string_view name = key.substr(2, key.size() - 4);
+    return name.find_first_of("{}") == std::string_view::npos;
+}
+
+std::string substituteByReplace(std::string content, const std::map<std::string, std::string>& substitutions) {
+    for (const auto& pair : substitutions) {
+        size_t pos = content.find(pair.first);
+        while (pos != std::string::npos) {
+            content.replace(pos, pair.first.length(), pair.second);
+            pos = content.find(pair.first, pos + pair.second.length());
+        }
+    }
+    return content;
+}
@@ -0,0 +1,84 @@
+#ifndef COMPILED_TEMPLATE_H
+#define COMPILED_TEMPLATE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <cstddef>
+#include <cstdint>
+
+class TemplateSink;
+
+/**
+ * @brief A template body split into literal and placeholder segments.
+ *
+ * A template is compiled once and can then be rendered any number of times
+ * in a single linear pass. Placeholders use the `{{name}}` syntax; the
+ * substitution map is keyed by the full token, e.g. "{{author}}", which is
+ * the same convention TemplateLoader::getAndSubstitute has always used.
+ *
+ * Literal segments are views into the source passed to compile(), so the
+ * source must outlive the compiled template.
+ */
+class CompiledTemplate {
+public:
+    struct Segment {
+        enum class Kind : std::uint8_t { Literal, Placeholder };
+        Kind kind;
+        std::string_view text;      ///< Literal bytes, or the full "{{name}}" token.
+        std::uint32_t placeholder;  ///< Index into placeholders() for Placeholder segments.
+    };
+
+    CompiledTemplate() = default;
+
+    /**
+     * @brief Splits a template body into segments.
+     * Unterminated or empty `{{` sequences are kept as literal text.
+     * @param source The template body. Must outlive the compiled template.
+     */
+    static CompiledTemplate compile(std::string_view source);
+
+    /**
+     * @brief Renders the template with the given substitutions.
+     * Placeholders without a substitution are emitted unchanged.
+     * @param substitutions A map of placeholders (e.g., "{{author}}") to their values.
+     * @return The rendered content, built in a single pre-sized buffer.
+     */
+    std::string render(const std::map<std::string, std::string>& substitutions) const;
+
+    /**
+     * @brief Renders the template segment by segment into a sink.
+     * The full output is never materialised; only the placeholder lookup
+     * table is allocated.
+     * @param substitutions A map of placeholders (e.g., "{{author}}") to their values.
+     * @param sink The destination for the rendered output.
+     */
+    void renderTo(const std::map<std::string, std::string>& substitutions, TemplateSink& sink) const;
+
+    const std::vector<Segment>& segments() const { return segments_; }
+    const std::vector<std::string>& placeholders() const { return placeholders_; }
+    std::size_t literalSize() const { return literal_size_; }
+
+    /**
+     * @brief Checks whether a substitution key uses the `{{name}}` placeholder syntax.
+     * Keys that do not can only be honoured by substituteByReplace().
+     */
+    static bool isPlaceholderToken(std::string_view key);
+
+private:
+    std::vector<Segment> segments_;
+    std::vector<std::string> placeholders_;  // Unique "{{name}}" tokens in order of first use
+    std::size_t literal_size_ = 0;
+
+    std::vector<std::string_view> resolve(const std::map<std::string, std::string>& substitutions) const;
+};
+
+/**
+ * @brief Substitutes placeholders by repeated find/replace over the whole string.
+ * This is the original getAndSubstitute algorithm. It accepts arbitrary keys,
+ * so the loader still falls back to it when a key is not a `{{name}}` token.
+ */
+std::string substituteByReplace(std::string content, const std::map<std::string, std::string>& substitutions);
+
+#endif // COMPILED_TEMPLATE_H
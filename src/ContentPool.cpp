@@ -0,0 +1,87 @@
+#include "ContentPool.h"
+#include <cstring>
+
+std::uint64_t hashContent(std::string_view bytes) {
+    const std::uint64_t multiplier = 0x9E3779B97F4A7C15ULL;
+    std::uint64_t hash = bytes.size() * multiplier;
+    std::size_t i = 0;
+    for (; i + 8 <= bytes.size(); i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes.data() + i, sizeof(word));
+        hash = (hash ^ word) * multiplier;
+        hash ^= hash >> 29;
+    }
+    for (; i < bytes.size(); ++i) {
+        hash = (hash ^ static_cast<unsigned char>(bytes[i])) * multiplier;
+    }
+    return hash ^ (hash >> 32);
+}
+
+std::shared_ptr<const TemplateBody> ContentPool::intern(std::string text) {
+    const std::uint64_t hash = hashContent(text);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.references;
+        stats_.logical_bytes += text.size();
+        if (auto existing = findLocked(hash, text)) {
+            return existing;
+        }
+    }
+
+    // Compile outside the lock; if another thread interned the same text in
+    // the meantime, its body wins and this one is dropped.
+    auto body = std::make_shared<TemplateBody>();
+    body->text = std::move(text);
+    body->content = body->text;
+    body->compiled = CompiledTemplate::compile(body->content);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto existing = findLocked(hash, body->content)) {
+        return existing;
+    }
+    insertLocked(hash, body);
+    return body;
+}
+
+std::shared_ptr<const TemplateBody> ContentPool::adopt(std::shared_ptr<const TemplateBody> body) {
+    const std::uint64_t hash = hashContent(body->content);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.references;
+    stats_.logical_bytes += body->content.size();
+    if (auto existing = findLocked(hash, body->content)) {
+        return existing;
+    }
+    insertLocked(hash, body);
+    return body;
+}
+
+std::shared_ptr<const TemplateBody> ContentPool::wrap(std::string_view content) {
+    auto body = std::make_shared<TemplateBody>();
+    body->content = content;
+    body->compiled = CompiledTemplate::compile(content);
+    return body;
+}
+
+ContentPool::Stats ContentPool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::shared_ptr<const TemplateBody> ContentPool::findLocked(std::uint64_t hash, std::string_view content) const {
+    auto it = bodies_.find(hash);
+    if (it == bodies_.end()) {
+        return nullptr;
+    }
+    for (const auto& body : it->second) {
+        if (body->content == content) {
+            return body;
+        }
+    }
+    return nullptr;
+}
+
+void ContentPool::insertLocked(std::uint64_t hash, std::shared_ptr<const TemplateBody> body) {
+    ++stats_.unique_bodies;
+    stats_.stored_bytes += body->content.size();
+    bodies_[hash].push_back(std::move(body));
+}
@@ -0,0 +1,88 @@
+#ifndef CONTENT_POOL_H
+#define CONTENT_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "CompiledTemplate.h"
+
+/**
+ * @brief A materialised template body and its compiled segments.
+ * `content` refers either to `text` (an owned, decoded copy) or to storage
+ * outside the body, such as a file mapping. Bodies are immutable once built
+ * and are shared between entries through std::shared_ptr.
+ */
+struct TemplateBody {
+    std::string text;
+    std::string_view content;
+    CompiledTemplate compiled;
+
+    bool ownsContent() const { return content.data() == text.data(); }
+};
+
+/**
+ * @brief 64-bit hash of a byte string, eight bytes at a time.
+ * Used to find identical bodies and unchanged statements; not stable across
+ * versions, so it must not be persisted.
+ */
+std::uint64_t hashContent(std::string_view bytes);
+
+/**
+ * @brief Content-addressed store of owned template bodies.
+ *
+ * Identical decoded bodies (the same LICENSE text in twenty projects, say)
+ * are kept once and shared by every entry that uses them, so memory grows
+ * with the amount of unique content rather than with the number of entries.
+ * Bodies are found by hash and confirmed by comparing bytes. All methods are
+ * thread-safe.
+ */
+class ContentPool {
+public:
+    struct Stats {
+        std::size_t references = 0;     ///< Bodies requested through intern()/adopt()
+        std::size_t unique_bodies = 0;
+        std::size_t logical_bytes = 0;  ///< Bytes all references would hold without sharing
+        std::size_t stored_bytes = 0;   ///< Bytes actually held
+
+        /**
+         * @brief logical_bytes / stored_bytes; 1.0 means nothing was shared.
+         */
+        double dedupRatio() const {
+            return stored_bytes == 0 ? 1.0 : static_cast<double>(logical_bytes) / static_cast<double>(stored_bytes);
+        }
+    };
+
+    /**
+     * @brief Returns the pooled body equal to `text`, creating and compiling it if needed.
+     */
+    std::shared_ptr<const TemplateBody> intern(std::string text);
+
+    /**
+     * @brief Adds an existing owned body (e.g. from a previous snapshot) to the pool.
+     * @return The pooled body equal to it, which may be a different object.
+     */
+    std::shared_ptr<const TemplateBody> adopt(std::shared_ptr<const TemplateBody> body);
+
+    /**
+     * @brief Builds an unpooled body that views storage owned by someone else.
+     */
+    static std::shared_ptr<const TemplateBody> wrap(std::string_view content);
+
+    Stats stats() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::uint64_t, std::vector<std::shared_ptr<const TemplateBody>>> bodies_;
+    Stats stats_;
+
+    std::shared_ptr<const TemplateBody> findLocked(std::uint64_t hash, std::string_view content) const;
+    void insertLocked(std::uint64_t hash, std::shared_ptr<const TemplateBody> body);
+};
+
+#endif // CONTENT_POOL_H
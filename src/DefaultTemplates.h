@@ -0,0 +1,421 @@
+// Generated by template_embedder from SQL/data.sql. Do not edit.
+#ifndef DEFAULT_TEMPLATES_H
+#define DEFAULT_TEMPLATES_H
+
+#include "EmbeddedTemplates.h"
+
+inline constexpr EmbeddedTemplate kDefaultTemplatesData[] = {
+    {std::string_view("generic", 7), std::string_view(".gitignore", 10),
+        std::string_view("# Compiled Object files\n"
+        "*.slo\n"
+        "*.lo\n"
+        "*.o\n"
+        "*.obj\n"
+        "\n"
+        "# Precompiled Headers\n"
+        "*.gch\n"
+        "*.pch\n"
+        "\n"
+        "# Compiled Dynamic libraries\n"
+        "*.so\n"
+        "*.dylib\n"
+        "*.dll\n"
+        "\n"
+        "# Fortran module files\n"
+        "*.mod\n"
+        "*.smod\n"
+        "\n"
+        "# Compiled Static libraries\n"
+        "*.lai\n"
+        "*.la\n"
+        "*.a\n"
+        "*.lib\n"
+        "\n"
+        "# Executables\n"
+        "*.exe\n"
+        "*.out\n"
+        "*.app\n"
+        "\n"
+        "# Build directories\n"
+        "build/\n"
+        "obj/\n"
+        "bin/\n"
+        "pgo-profiles/\n"
+        "\n"
+        "# IDE files\n"
+        ".vscode/\n"
+        ".vs/\n"
+        "*.vcxproj*\n"
+        "*.sln\n"
+        "\n"
+        "# CMake\n"
+        "CMakeCache.txt\n"
+        "CMakeFiles/\n"
+        "cmake_install.cmake\n"
+        "Makefile\n"
+        "\n"
+        "# Debug files\n"
+        "*.dSYM/\n"
+        "*.su\n"
+        "*.idb\n"
+        "*.pdb\n"
+        "\n"
+        "# Generator manifest\n"
+        ".template-manifest\n"
+        "\n"
+        "# Project specific\n"
+        "{{name}}\n"
+        "{{name}}_tests\n", 535)},
+    {std::string_view("generic", 7), std::string_view("CMakeLists.txt", 14),
+        std::string_view("cmake_minimum_required(VERSION 3.12)\n"
+        "project({{name}} VERSION {{version}})\n"
+        "\n"
+        "set(CMAKE_CXX_STANDARD 17)\n"
+        "set(CMAKE_CXX_STANDARD_REQUIRED ON)\n"
+        "\n"
+        "{{> partials/cmake_profiles}}# Include directories\n"
+        "include_directories(include)\n"
+        "\n"
+        "{{#if executable}}# Executable\n"
+        "add_executable({{name}}\n"
+        "    src/main.cpp\n"
+        "{{> partials/cmake_sources}})\n"
+        "\n"
+        "{{else if static_library}}# Static Library\n"
+        "add_library({{name}} STATIC\n"
+        "{{> partials/cmake_sources}})\n"
+        "\n"
+        "{{else if shared_library}}# Shared Library\n"
+        "add_library({{name}} SHARED\n"
+        "{{> partials/cmake_sources}})\n"
+        "# Calls within the library bind locally instead of going through the PLT\n"
+        "if(CMAKE_CXX_COMPILER_ID MATCHES \"GNU|Clang\" AND NOT APPLE)\n"
+        "    target_compile_options({{name}} PRIVATE -fno-plt -fno-semantic-interposition)\n"
+        "endif()\n"
+        "\n"
+        "{{else if header_only}}# Header-only Library\n"
+        "add_library({{name}} INTERFACE)\n"
+        "target_include_directories({{name}} INTERFACE include)\n"
+        "\n"
+        "{{else if unit_test}}# Test Executable\n"
+        "enable_testing()\n"
+        "add_executable({{name}}\n"
+        "    src/main.cpp\n"
+        "{{> partials/cmake_sources}})\n"
+        "add_test(NAME {{name}} COMMAND {{name}})\n"
+        "\n"
+        "{{/if}}{{#if includeTests}}{{#unless unit_test}}# Tests\n"
+        "enable_testing()\n"
+        "add_executable({{name}}_tests\n"
+        "    tests/test_{{name}}.cpp\n"
+        ")\n"
+        "{{#if library}}target_link_libraries({{name}}_tests PRIVATE {{name}})\n"
+        "{{/if}}add_test(NAME {{name}}_tests COMMAND {{name}}_tests)\n"
+        "\n"
+        "{{/unless}}{{/if}}{{#if dependencies}}# Dependencies\n"
+        "target_link_libraries({{name}} {{#if header_only}}INTERFACE{{else}}PRIVATE{{/if}}{{#each dependencies}} {{this}}{{/each}})\n"
+        "\n"
+        "{{/if}}{{#unless header_only}}# Compiler flags\n"
+        "target_compile_options({{name}} PRIVATE\n"
+        "    -Wall -Wextra -Wpedantic\n"
+        ")\n"
+        "\n"
+        "{{/unless}}# Installation\n"
+        "{{#unless header_only}}install(TARGETS {{name}} DESTINATION {{#if library}}lib{{else}}bin{{/if}})\n"
+        "{{/unless}}install(FILES include/{{name}}.h DESTINATION include)\n", 1802)},
+    {std::string_view("generic", 7), std::string_view("CMakePresets.json", 17),
+        std::string_view("{\n"
+        "    \"version\": 3,\n"
+        "    \"cmakeMinimumRequired\": {\n"
+        "        \"major\": 3,\n"
+        "        \"minor\": 21,\n"
+        "        \"patch\": 0\n"
+        "    },\n"
+        "    \"configurePresets\": [\n"
+        "        {\n"
+        "            \"name\": \"release\",\n"
+        "            \"displayName\": \"Release with link-time optimization\",\n"
+        "            \"binaryDir\": \"${sourceDir}/build/release\",\n"
+        "            \"cacheVariables\": {\n"
+        "                \"CMAKE_BUILD_TYPE\": \"Release\",\n"
+        "                \"ENABLE_LTO\": \"ON\"\n"
+        "            }\n"
+        "        },\n"
+        "        {\n"
+        "            \"name\": \"debug\",\n"
+        "            \"displayName\": \"Debug\",\n"
+        "            \"binaryDir\": \"${sourceDir}/build/debug\",\n"
+        "            \"cacheVariables\": {\n"
+        "                \"CMAKE_BUILD_TYPE\": \"Debug\",\n"
+        "                \"ENABLE_LTO\": \"OFF\"\n"
+        "            }\n"
+        "        },\n"
+        "        {\n"
+        "            \"name\": \"native\",\n"
+        "            \"inherits\": \"release\",\n"
+        "            \"displayName\": \"Release tuned for this machine\",\n"
+        "            \"binaryDir\": \"${sourceDir}/build/native\",\n"
+        "            \"cacheVariables\": {\n"
+        "                \"ENABLE_NATIVE_ARCH\": \"ON\"\n"
+        "            }\n"
+        "        },\n"
+        "        {\n"
+        "            \"name\": \"pgo-generate\",\n"
+        "            \"inherits\": \"release\",\n"
+        "            \"displayName\": \"PGO step 1: instrumented build\",\n"
+        "            \"binaryDir\": \"${sourceDir}/build/pgo\",\n"
+        "            \"cacheVariables\": {\n"
+        "                \"PGO_PHASE\": \"GENERATE\"\n"
+        "            }\n"
+        "        },\n"
+        "        {\n"
+        "            \"name\": \"pgo-use\",\n"
+        "            \"inherits\": \"pgo-generate\",\n"
+        "            \"displayName\": \"PGO step 2: optimized with the recorded profile\",\n"
+        "            \"cacheVariables\": {\n"
+        "                \"PGO_PHASE\": \"USE\"\n"
+        "            }\n"
+        "        }\n"
+        "    ],\n"
+        "    \"buildPresets\": [\n"
+        "        { \"name\": \"release\", \"configurePreset\": \"release\" },\n"
+        "        { \"name\": \"debug\", \"configurePreset\": \"debug\" },\n"
+        "        { \"name\": \"native\", \"configurePreset\": \"native\" },\n"
+        "        { \"name\": \"pgo-generate\", \"configurePreset\": \"pgo-generate\" },\n"
+        "        { \"name\": \"pgo-use\", \"configurePreset\": \"pgo-use\" }\n"
+        "    ]\n"
+        "}\n", 1885)},
+    {std::string_view("generic", 7), std::string_view("LICENSE", 7),
+        std::string_view("MIT License\n"
+        "\n"
+        "Copyright (c) 2024 {{author}}\n"
+        "\n"
+        "Permission is hereby granted, free of charge, to any person obtaining a copy\n"
+        "of this software and associated documentation files (the \"Software\"), to deal\n"
+        "in the Software without restriction, including without limitation the rights\n"
+        "to use, copy, modify, merge, publish, distribute, sublicense, and/or sell\n"
+        "copies of the Software, and to permit persons to whom the Software is\n"
+        "furnished to do so, subject to the following conditions:\n"
+        "\n"
+        "The above copyright notice and this permission notice shall be included in all\n"
+        "copies or substantial portions of the Software.\n"
+        "\n"
+        "THE SOFTWARE IS PROVIDED \"AS IS\", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR\n"
+        "IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,\n"
+        "FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE\n"
+        "AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER\n"
+        "LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,\n"
+        "OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE\n"
+        "SOFTWARE.", 1066)},
+    {std::string_view("generic", 7), std::string_view("Makefile", 8),
+        std::string_view("# Makefile for {{name}}\n"
+        "{{#if header_only}}#\n"
+        "# {{name}} is header-only: `make` checks that the header compiles on its own\n"
+        "# and `make install` copies it.\n"
+        "\n"
+        "CXX = g++\n"
+        "CXXFLAGS = -std=c++17 -Wall -Wextra -Wpedantic -Iinclude\n"
+        "HEADER = include/{{name}}.h\n"
+        "\n"
+        ".PHONY: all clean install\n"
+        "\n"
+        "all:\n"
+        "\t$(CXX) $(CXXFLAGS) -fsyntax-only -x c++ $(HEADER)\n"
+        "\n"
+        "clean:\n"
+        "\n"
+        "install:\n"
+        "\tcp $(HEADER) /usr/local/include/\n"
+        "{{else}}#\n"
+        "# `make` builds the release profile: -O3 with link-time optimization.\n"
+        "#   make debug           Unoptimized, with debug information\n"
+        "#   make NATIVE=1        Release tuned for this machine (-march=native)\n"
+        "{{#if library}}#   make pgo PGO_TRAIN=<command>\n"
+        "#                        Instrumented build, a training run of <command>, then\n"
+        "#                        a rebuild optimized with the recorded profile. The\n"
+        "#                        command must run a program that uses the instrumented\n"
+        "#                        library{{#if static_library}} and is linked with -fprofile-generate{{/if}}.\n"
+        "{{else}}#   make pgo             Instrumented build, a training run of PGO_TRAIN, then\n"
+        "#                        a rebuild optimized with the recorded profile\n"
+        "{{/if}}\n"
+        "CXX = g++\n"
+        "{{#if static_library}}AR = gcc-ar\n"
+        "{{/if}}CXXFLAGS = -std=c++17 -Wall -Wextra -Wpedantic -Iinclude\n"
+        "{{#if shared_library}}# Calls within the library bind locally instead of going through the PLT\n"
+        "CXXFLAGS += -fPIC -fno-plt -fno-semantic-interposition\n"
+        "{{/if}}LDFLAGS =\n"
+        "SRCDIR = src\n"
+        "OBJDIR = obj\n"
+        "SOURCES = $(wildcard $(SRCDIR)/*.cpp)\n"
+        "OBJECTS = $(SOURCES:$(SRCDIR)/%.cpp=$(OBJDIR)/%.o)\n"
+        "TARGET = {{#if static_library}}lib{{name}}.a{{else if shared_library}}lib{{name}}.so{{else}}{{name}}{{/if}}\n"
+        "{{#if dependencies}}LDLIBS ={{#each dependencies}} -l{{this}}{{/each}}\n"
+        "{{/if}}\n"
+        "RELEASE_FLAGS = -O3 -DNDEBUG -flto=auto\n"
+        "ifeq ($(NATIVE),1)\n"
+        "RELEASE_FLAGS += -march=native\n"
+        "endif\n"
+        "PGO_DIR = $(CURDIR)/pgo-profiles\n"
+        "{{#unless library}}PGO_TRAIN = ./$(TARGET)\n"
+        "{{/unless}}\n"
+        ".PHONY: all clean debug release pgo pgo-generate pgo-use\n"
+        "\n"
+        "all: release\n"
+        "\n"
+        "$(TARGET): $(OBJECTS)\n"
+        "{{#if static_library}}\t$(AR) rcs $@ $(OBJECTS)\n"
+        "{{else}}\t$(CXX){{#if shared_library}} -shared{{/if}} $(LDFLAGS) $(OBJECTS) -o $@{{#if dependencies}} $(LDLIBS){{/if}}\n"
+        "{{/if}}\n"
+        "$(OBJDIR)/%.o: $(SRCDIR)/%.cpp | $(OBJDIR)\n"
+        "\t$(CXX) $(CXXFLAGS) -c $< -o $@\n"
+        "\n"
+        "$(OBJDIR):\n"
+        "\tmkdir -p $(OBJDIR)\n"
+        "\n"
+        "debug: CXXFLAGS += -g -DDEBUG\n"
+        "debug: $(TARGET)\n"
+        "\n"
+        "release: CXXFLAGS += $(RELEASE_FLAGS)\n"
+        "release: LDFLAGS += $(RELEASE_FLAGS)\n"
+        "release: $(TARGET)\n"
+        "\n"
+        "pgo-generate: CXXFLAGS += $(RELEASE_FLAGS) -fprofile-generate=$(PGO_DIR)\n"
+        "pgo-generate: LDFLAGS += $(RELEASE_FLAGS) -fprofile-generate=$(PGO_DIR)\n"
+        "pgo-generate: $(TARGET)\n"
+        "\n"
+        "pgo-use: CXXFLAGS += $(RELEASE_FLAGS) -fprofile-use=$(PGO_DIR) -fprofile-correction -Wno-missing-profile\n"
+        "pgo-use: LDFLAGS += $(RELEASE_FLAGS) -fprofile-use=$(PGO_DIR)\n"
+        "pgo-use: $(TARGET)\n"
+        "\n"
+        "# Both phases build in $(OBJDIR), so the profile matches the objects it describes\n"
+        "pgo:\n"
+        "{{#if library}}\t$(if $(PGO_TRAIN),,$(error Set PGO_TRAIN to a command that exercises the library: make pgo PGO_TRAIN=./bench))\n"
+        "{{/if}}\trm -rf $(PGO_DIR)\n"
+        "\t$(MAKE) clean\n"
+        "\t$(MAKE) pgo-generate\n"
+        "\t$(PGO_TRAIN)\n"
+        "\t$(MAKE) clean\n"
+        "\t$(MAKE) pgo-use\n"
+        "\n"
+        "clean:\n"
+        "\trm -rf $(OBJDIR) $(TARGET)\n"
+        "\n"
+        "install: $(TARGET)\n"
+        "{{#if library}}\tcp $(TARGET) /usr/local/lib/\n"
+        "\tcp include/{{name}}.h /usr/local/include/\n"
+        "{{else}}\tcp $(TARGET) /usr/local/bin/\n"
+        "{{/if}}{{/if}}", 3303)},
+    {std::string_view("generic", 7), std::string_view("README.md", 9),
+        std::string_view("# {{project_name}}\n"
+        "\n"
+        "## Description\n"
+        "{{description}}\n"
+        "\n"
+        "## Goal\n"
+        "{{goal}}\n"
+        "\n"
+        "## Building\n"
+        "\n"
+        "### Using Makefile\n"
+        "```bash\n"
+        "make\n"
+        "```\n"
+        "\n"
+        "## Author\n"
+        "{{author}}\n", 141)},
+    {std::string_view("generic", 7), std::string_view("include/LikertScale.h", 21),
+        std::string_view("#ifndef LIKERT_SCALE_H\n"
+        "#define LIKERT_SCALE_H\n"
+        "\n"
+        "#include <string>\n"
+        "#include <vector>\n"
+        "\n"
+        "/**\n"
+        " * @class LikertScale\n"
+        " * @brief A simple class to display a Likert scale question and get a response.\n"
+        " */\n"
+        "class LikertScale {\n"
+        "public:\n"
+        "    /**\n"
+        "     * @brief Construct a new Likert Scale object\n"
+        "     * @param question The question to ask the user.\n"
+        "     * @param options The list of options for the scale (e.g., \"Strongly Disagree\" to \"Strongly Agree\").\n"
+        "     */\n"
+        "    LikertScale(const std::string& question, const std::vector<std::string>& options);\n"
+        "\n"
+        "    /**\n"
+        "     * @brief Displays the question and options, then waits for and validates user input.\n"
+        "     * @return The user's choice as an integer (1-based index).\n"
+        "     */\n"
+        "    int displayAndGetResponse();\n"
+        "\n"
+        "private:\n"
+        "    std::string question_;\n"
+        "    std::vector<std::string> options_;\n"
+        "};\n"
+        "\n"
+        "#endif // LIKERT_SCALE_H\n", 842)},
+    {std::string_view("generic", 7), std::string_view("partials/cmake_profiles", 23),
+        std::string_view("# Build profiles. Without a preset this is a Release build with link-time\n"
+        "# optimization; CMakePresets.json selects the others:\n"
+        "#   cmake --preset native        Release tuned for this machine (-march=native)\n"
+        "#   cmake --preset pgo-generate  Instrumented build: build it, run a typical workload,\n"
+        "#   cmake --preset pgo-use       then rebuild in the same directory with the profile\n"
+        "if(NOT CMAKE_BUILD_TYPE AND NOT CMAKE_CONFIGURATION_TYPES)\n"
+        "    set(CMAKE_BUILD_TYPE Release CACHE STRING \"Build type\" FORCE)\n"
+        "endif()\n"
+        "option(ENABLE_LTO \"Link-time optimization outside Debug builds\" ON)\n"
+        "option(ENABLE_NATIVE_ARCH \"Tune for the building machine (-march=native)\" OFF)\n"
+        "set(PGO_PHASE OFF CACHE STRING \"Profile-guided optimization: OFF, GENERATE or USE\")\n"
+        "set_property(CACHE PGO_PHASE PROPERTY STRINGS OFF GENERATE USE)\n"
+        "set(PGO_DIR \"${CMAKE_BINARY_DIR}/pgo-profiles\" CACHE PATH \"Where PGO profiles are written and read\")\n"
+        "\n"
+        "if(ENABLE_LTO AND NOT CMAKE_BUILD_TYPE STREQUAL \"Debug\")\n"
+        "    include(CheckIPOSupported)\n"
+        "    check_ipo_supported(RESULT lto_supported OUTPUT lto_error)\n"
+        "    if(lto_supported)\n"
+        "        set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)\n"
+        "    else()\n"
+        "        message(WARNING \"Link-time optimization is not available: ${lto_error}\")\n"
+        "    endif()\n"
+        "endif()\n"
+        "if(CMAKE_CXX_COMPILER_ID MATCHES \"GNU|Clang\")\n"
+        "    if(ENABLE_NATIVE_ARCH)\n"
+        "        add_compile_options(-march=native)\n"
+        "    endif()\n"
+        "    if(PGO_PHASE STREQUAL \"GENERATE\")\n"
+        "        add_compile_options(-fprofile-generate=${PGO_DIR})\n"
+        "        string(APPEND CMAKE_EXE_LINKER_FLAGS \" -fprofile-generate=${PGO_DIR}\")\n"
+        "        string(APPEND CMAKE_SHARED_LINKER_FLAGS \" -fprofile-generate=${PGO_DIR}\")\n"
+        "    elseif(PGO_PHASE STREQUAL \"USE\")\n"
+        "        # Clang needs the raw profiles merged first:\n"
+        "        #   llvm-profdata merge -o ${PGO_DIR}/default.profdata ${PGO_DIR}/*.profraw\n"
+        "        add_compile_options(-fprofile-use=${PGO_DIR})\n"
+        "        if(CMAKE_CXX_COMPILER_ID STREQUAL \"GNU\")\n"
+        "            add_compile_options(-fprofile-correction -Wno-missing-profile)\n"
+        "        endif()\n"
+        "    endif()\n"
+        "endif()\n"
+        "\n", 2021)},
+    {std::string_view("generic", 7), std::string_view("partials/cmake_sources", 22),
+        std::string_view("    src/{{name}}.cpp\n"
+        "{{#if includeLikertScale}}    src/LikertScale.cpp\n"
+        "{{/if}}", 78)},
+};
+
+inline constexpr std::uint32_t kDefaultTemplatesDisplacements[] = {
+    0, 0, 2, 0,
+};
+
+inline constexpr std::uint32_t kDefaultTemplatesSlots[] = {
+    0, 0, 0, 3, 5, 6, 0, 8, 0, 1, 2, 7, 9, 0, 0, 4,
+};
+
+inline constexpr EmbeddedTemplateSet kDefaultTemplates(
+    kDefaultTemplatesData, 9,
+    kDefaultTemplatesDisplacements, 4,
+    kDefaultTemplatesSlots, 16);
+
+static_assert(kDefaultTemplates.isPerfect(), "kDefaultTemplates has a stale index; rerun template_embedder");
+
+#endif // DEFAULT_TEMPLATES_H
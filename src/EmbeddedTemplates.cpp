@@ -0,0 +1,145 @@
+#include "EmbeddedTemplates.h"
+#include "GeneratedSource.h"
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+std::size_t powerOfTwoAtLeast(std::size_t value) {
+    std::size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+PerfectHash buildPerfectHash(const std::vector<EmbeddedTemplate>& templates) {
+    PerfectHash table;
+    if (templates.empty()) {
+        return table;
+    }
+    const std::size_t bucket_count = powerOfTwoAtLeast((templates.size() + 3) / 4);
+    const std::size_t slot_count = powerOfTwoAtLeast(templates.size() + templates.size() / 4);
+    table.displacements.assign(bucket_count, 0);
+    table.slots.assign(slot_count, 0);
+
+    std::vector<std::uint64_t> hashes;
+    std::vector<std::vector<std::uint32_t>> buckets(bucket_count);
+    hashes.reserve(templates.size());
+    for (std::size_t i = 0; i < templates.size(); ++i) {
+        hashes.push_back(hashTemplateKey(templates[i].project_name, templates[i].file_path));
+        buckets[(hashes.back() >> 32) & (bucket_count - 1)].push_back(static_cast<std::uint32_t>(i));
+    }
+    for (const auto& bucket : buckets) {
+        for (std::size_t a = 0; a < bucket.size(); ++a) {
+            for (std::size_t b = a + 1; b < bucket.size(); ++b) {
+                if (hashes[bucket[a]] != hashes[bucket[b]]) {
+                    continue;
+                }
+                // No displacement can separate keys whose full hashes are equal.
+                const EmbeddedTemplate& x = templates[bucket[a]];
+                const EmbeddedTemplate& y = templates[bucket[b]];
+                if (x.project_name == y.project_name && x.file_path == y.file_path) {
+                    throw std::invalid_argument("Duplicate embedded template '" + std::string(x.file_path) +
+                                                "' in project '" + std::string(x.project_name) + "'.");
+                }
+                throw std::invalid_argument("Embedded templates '" + std::string(x.file_path) + "' and '" +
+                                            std::string(y.file_path) + "' have the same key hash.");
+            }
+        }
+    }
+
+    std::vector<std::size_t> order(bucket_count);
+    for (std::size_t i = 0; i < bucket_count; ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&buckets](std::size_t a, std::size_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<std::size_t> placed;
+    for (std::size_t bucket_index : order) {
+        const std::vector<std::uint32_t>& bucket = buckets[bucket_index];
+        if (bucket.empty()) {
+            break;
+        }
+        // Keys with equal hashes were rejected above and the table has a free
+        // slot for every key, so some displacement eventually fits.
+        for (std::uint32_t displacement = 0;; ++displacement) {
+            placed.clear();
+            bool fits = true;
+            for (std::uint32_t member : bucket) {
+                std::size_t slot = embeddedSlotHash(hashes[member], displacement) & (slot_count - 1);
+                if (table.slots[slot] != 0 || std::find(placed.begin(), placed.end(), slot) != placed.end()) {
+                    fits = false;
+                    break;
+                }
+                placed.push_back(slot);
+            }
+            if (fits) {
+                for (std::size_t i = 0; i < bucket.size(); ++i) {
+                    table.slots[placed[i]] = bucket[i] + 1;
+                }
+                table.displacements[bucket_index] = displacement;
+                break;
+            }
+        }
+    }
+    return table;
+}
+
+void writeEmbeddedTemplates(const std::string& path, const std::vector<BundleRecord>& records,
+                            const std::string& symbol, const std::string& source) {
+    // Later records replace earlier ones with the same key; the map also
+    // orders the templates by (project_name, file_path).
+    std::map<std::pair<std::string_view, std::string_view>, std::size_t> latest;
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        latest[{records[i].project_name, records[i].file_path}] = i;
+    }
+    std::vector<EmbeddedTemplate> templates;
+    templates.reserve(latest.size());
+    for (const auto& pair : latest) {
+        const BundleRecord& record = records[pair.second];
+        templates.push_back({record.project_name, record.file_path, record.content});
+    }
+    PerfectHash table = buildPerfectHash(templates);
+
+    const std::string guard = GeneratedSource::includeGuardFor(path);
+    std::ostringstream out;
+    out << "// Generated by template_embedder from " << source << ". Do not edit.\n"
+        << "#ifndef " << guard << "\n"
+        << "#define " << guard << "\n\n"
+        << "#include \"EmbeddedTemplates.h\"\n\n";
+    if (templates.empty()) {
+        out << "inline constexpr EmbeddedTemplateSet " << symbol << "(nullptr, 0, nullptr, 0, nullptr, 0);\n";
+    } else {
+        out << "inline constexpr EmbeddedTemplate " << symbol << "Data[] = {\n";
+        for (const EmbeddedTemplate& entry : templates) {
+            out << "    {" << GeneratedSource::viewLiteral(entry.project_name, false) << ", "
+                << GeneratedSource::viewLiteral(entry.file_path, false) << ",\n        "
+                << GeneratedSource::viewLiteral(entry.content, true) << "},\n";
+        }
+        out << "};\n\n";
+        auto writeTable = [&out](const std::string& name, const std::vector<std::uint32_t>& values) {
+            out << "inline constexpr std::uint32_t " << name << "[] = {";
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                out << (i % 16 == 0 ? "\n    " : " ") << values[i] << ",";
+            }
+            out << "\n};\n\n";
+        };
+        writeTable(symbol + "Displacements", table.displacements);
+        writeTable(symbol + "Slots", table.slots);
+        out << "inline constexpr EmbeddedTemplateSet " << symbol << "(\n"
+            << "    " << symbol << "Data, " << templates.size() << ",\n"
+            << "    " << symbol << "Displacements, " << table.displacements.size() << ",\n"
+            << "    " << symbol << "Slots, " << table.slots.size() << ");\n";
+    }
+    out << "\nstatic_assert(" << symbol << ".isPerfect(), \"" << symbol << " has a stale index; rerun template_embedder\");\n\n"
+        << "#endif // " << guard << "\n";
+
+    GeneratedSource::writeFile(path, out.str());
+}
@@ -0,0 +1,153 @@
+#ifndef EMBEDDED_TEMPLATES_H
+#define EMBEDDED_TEMPLATES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "TemplateBundle.h"
+#include "TemplateIndex.h"
+
+/**
+ * @brief One template compiled into the binary.
+ */
+struct EmbeddedTemplate {
+    std::string_view project_name;
+    std::string_view file_path;
+    std::string_view content;
+};
+
+/**
+ * @brief Maps a key hash and its bucket's displacement to a slot hash.
+ * The splitmix64 finaliser spreads every displacement over the whole table.
+ */
+constexpr std::uint64_t embeddedSlotHash(std::uint64_t key_hash, std::uint32_t displacement) {
+    std::uint64_t x = key_hash ^ (displacement * 0x9E3779B97F4A7C15ULL);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief A constexpr table of templates with a perfect-hash index.
+ *
+ * Instances are emitted by template_embedder into a generated header (see
+ * DefaultTemplates.h). The templates are sorted by (project_name, file_path)
+ * and indexed with hash-and-displace: the key hash picks a bucket, the
+ * bucket's displacement picks a slot, and the embedder chose displacements
+ * so that no two keys share a slot. A lookup is one pass over the key, two
+ * table reads and one key comparison; nothing is read or parsed at startup.
+ */
+class EmbeddedTemplateSet {
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /**
+     * @param templates Templates sorted by (project_name, file_path).
+     * @param displacements bucket_count entries (a power of two), one per bucket.
+     * @param slots slot_count entries (a power of two): 0 for an empty slot,
+     *        otherwise the template index plus one.
+     */
+    constexpr EmbeddedTemplateSet(const EmbeddedTemplate* templates, std::size_t count,
+                                  const std::uint32_t* displacements, std::size_t bucket_count,
+                                  const std::uint32_t* slots, std::size_t slot_count)
+        : templates_(templates), count_(count), displacements_(displacements), bucket_count_(bucket_count),
+          slots_(slots), slot_count_(slot_count) {}
+
+    constexpr std::size_t size() const { return count_; }
+    constexpr const EmbeddedTemplate& operator[](std::size_t index) const { return templates_[index]; }
+
+    /**
+     * @return The index of the template, or npos if the key is absent.
+     */
+    constexpr std::size_t find(std::string_view project_name, std::string_view file_path) const {
+        if (count_ == 0) {
+            return npos;
+        }
+        const std::uint64_t hash = hashTemplateKey(project_name, file_path);
+        const std::uint32_t displacement = displacements_[(hash >> 32) & (bucket_count_ - 1)];
+        const std::uint32_t slot = slots_[embeddedSlotHash(hash, displacement) & (slot_count_ - 1)];
+        if (slot == 0) {
+            return npos;
+        }
+        const EmbeddedTemplate& candidate = templates_[slot - 1];
+        return candidate.file_path == file_path && candidate.project_name == project_name ? slot - 1 : npos;
+    }
+
+    /**
+     * @brief Returns the half-open range of template indices that belong to a project.
+     */
+    constexpr std::pair<std::size_t, std::size_t> projectRange(std::string_view project_name) const {
+        std::size_t begin = 0;
+        std::size_t end = count_;
+        while (begin < end) {
+            std::size_t middle = begin + (end - begin) / 2;
+            if (templates_[middle].project_name < project_name) {
+                begin = middle + 1;
+            } else {
+                end = middle;
+            }
+        }
+        end = begin;
+        while (end < count_ && templates_[end].project_name == project_name) {
+            ++end;
+        }
+        return {begin, end};
+    }
+
+    /**
+     * @brief Checks that every template is found at its own index. Generated
+     * headers static_assert this, so a stale or hand-edited table fails to compile.
+     */
+    constexpr bool isPerfect() const {
+        for (std::size_t i = 0; i < count_; ++i) {
+            if (find(templates_[i].project_name, templates_[i].file_path) != i) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    const EmbeddedTemplate* templates_;
+    std::size_t count_;
+    const std::uint32_t* displacements_;
+    std::size_t bucket_count_;
+    const std::uint32_t* slots_;
+    std::size_t slot_count_;
+};
+
+/**
+ * @brief Displacement and slot tables for EmbeddedTemplateSet, as found by buildPerfectHash().
+ */
+struct PerfectHash {
+    std::vector<std::uint32_t> displacements;
+    std::vector<std::uint32_t> slots;  ///< 0 for empty, otherwise template index plus one
+};
+
+/**
+ * @brief Builds a collision-free index over the templates' keys.
+ * Buckets are placed largest first, each with the smallest displacement that
+ * moves all of its keys into free slots.
+ * @throws std::invalid_argument if two templates have the same key (or key hash).
+ */
+PerfectHash buildPerfectHash(const std::vector<EmbeddedTemplate>& templates);
+
+/**
+ * @brief Writes a C++ header that embeds templates as constexpr tables.
+ * When several records share a (project_name, file_path) key the last one
+ * wins, as in writeTemplateBundle. The header defines `symbol` as an
+ * EmbeddedTemplateSet and static_asserts that its index is perfect.
+ * @param path The header to write; its file name also gives the include guard.
+ * @param records The templates to embed; content must already be unescaped.
+ * @param symbol Name of the EmbeddedTemplateSet constant, e.g. "kDefaultTemplates".
+ * @param source Where the templates came from, for the header comment.
+ * @throws std::runtime_error if the header cannot be written.
+ */
+void writeEmbeddedTemplates(const std::string& path, const std::vector<BundleRecord>& records,
+                            const std::string& symbol, const std::string& source);
+
+#endif // EMBEDDED_TEMPLATES_H
@@ -0,0 +1,70 @@
+#include "GeneratedSource.h"
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace GeneratedSource {
+
+std::string stringLiteral(std::string_view text, bool break_lines) {
+    // Octal escapes always use three digits so that a following digit cannot extend them.
+    static const char digits[] = "01234567";
+    std::string out = "\"";
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        switch (c) {
+        case '\n':
+            out += "\\n";
+            if (break_lines && i + 1 < text.size()) {
+                out += "\"\n        \"";
+            }
+            break;
+        case '\t': out += "\\t"; break;
+        case '\r': out += "\\r"; break;
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        default:
+            if (c >= 0x20 && c < 0x7F) {
+                out += static_cast<char>(c);
+            } else {
+                out += '\\';
+                out += digits[(c >> 6) & 7];
+                out += digits[(c >> 3) & 7];
+                out += digits[c & 7];
+            }
+        }
+    }
+    out += '"';
+    return out;
+}
+
+std::string viewLiteral(std::string_view text, bool break_lines) {
+    return "std::string_view(" + stringLiteral(text, break_lines) + ", " + std::to_string(text.size()) + ")";
+}
+
+std::string includeGuardFor(const std::string& path) {
+    std::string name = std::filesystem::path(path).filename().string();
+    std::string guard;
+    for (std::size_t i = 0; i < name.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(name[i]);
+        if (std::isupper(c) && i > 0 && (std::islower(static_cast<unsigned char>(name[i - 1])) ||
+                                         std::isdigit(static_cast<unsigned char>(name[i - 1])))) {
+            guard += '_';
+        }
+        guard += std::isalnum(c) ? static_cast<char>(std::toupper(c)) : '_';
+    }
+    return guard;
+}
+
+void writeFile(const std::string& path, const std::string& text) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not create " + path);
+    }
+    file << text;
+    if (!file) {
+        throw std::runtime_error("Failed to write " + path);
+    }
+}
+
+} // namespace GeneratedSource
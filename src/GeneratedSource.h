@@ -0,0 +1,37 @@
+#ifndef GENERATED_SOURCE_H
+#define GENERATED_SOURCE_H
+
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Helpers shared by the tools that emit C++ headers (template_embedder,
+ * template_precompiler).
+ */
+namespace GeneratedSource {
+
+/**
+ * @brief Escapes arbitrary bytes as a C++ string literal, quotes included.
+ * @param break_lines Continue the literal on a new, indented line after each "\n".
+ */
+std::string stringLiteral(std::string_view text, bool break_lines);
+
+/**
+ * @brief A `std::string_view(literal, length)` expression; the explicit length keeps embedded NULs.
+ */
+std::string viewLiteral(std::string_view text, bool break_lines);
+
+/**
+ * @brief Derives an include guard from a header's file name ("DefaultTemplates.h" -> "DEFAULT_TEMPLATES_H").
+ */
+std::string includeGuardFor(const std::string& path);
+
+/**
+ * @brief Replaces the file at `path` with `text`.
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void writeFile(const std::string& path, const std::string& text);
+
+} // namespace GeneratedSource
+
+#endif // GENERATED_SOURCE_H
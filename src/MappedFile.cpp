@@ -0,0 +1,104 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <fstream>
+#include <sstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path, Access access) {
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + path);
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    buffer_ = contents.str();
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    (void)access;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open file: " + path);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Could not stat file: " + path);
+    }
+
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ > 0) {
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Could not map file: " + path);
+        }
+        data_ = static_cast<const char*>(addr);
+        advise(access);
+    }
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+#ifdef _WIN32
+        buffer_ = std::move(other.buffer_);
+        data_ = buffer_.data();
+#else
+        data_ = other.data_;
+#endif
+        size_ = other.size_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+void MappedFile::advise(Access access) {
+#ifndef _WIN32
+    if (data_ == nullptr) {
+        return;
+    }
+    int advice = MADV_NORMAL;
+    if (access == Access::Sequential) {
+        advice = MADV_SEQUENTIAL;
+    } else if (access == Access::Random) {
+        advice = MADV_RANDOM;
+    }
+    // Only a hint; a failure changes nothing but paging behaviour.
+    ::madvise(const_cast<char*>(data_), size_, advice);
+#else
+    (void)access;
+#endif
+}
+
+void MappedFile::release() {
+#ifndef _WIN32
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
@@ -0,0 +1,60 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * The mapping lives as long as the object, so any std::string_view taken from
+ * view() must not outlive it. On platforms without mmap the file is read into
+ * an owned buffer instead, which keeps the interface identical.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief How the mapping will be read, passed to the kernel as a paging hint.
+     */
+    enum class Access {
+        Normal,     ///< No hint
+        Sequential, ///< One pass front to back; pages behind the reader may be dropped
+        Random,     ///< Scattered reads; no read-ahead
+    };
+
+    /**
+     * @brief Maps the given file read-only.
+     * @param path The path of the file to map.
+     * @param access How the mapping will be read first; see advise().
+     * @throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string& path, Access access = Access::Normal);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    std::string_view view() const { return std::string_view(data_, size_); }
+
+    /**
+     * @brief Replaces the paging hint, for a mapping that is scanned once and
+     * then kept for other reads. Does nothing where there is no mmap.
+     */
+    void advise(Access access);
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef _WIN32
+    std::string buffer_;
+#endif
+
+    void release();
+};
+
+#endif // MAPPED_FILE_H
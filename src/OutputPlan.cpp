@@ -0,0 +1,602 @@
+#include "OutputPlan.h"
+#include "MappedFile.h"
+#include "TarWriter.h"
+#include "TemplateSink.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <fstream>
+#include <future>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#include <process.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Counts the bytes passed on to another sink.
+class CountingSink : public TemplateSink {
+public:
+    explicit CountingSink(TemplateSink& out) : out_(out) {}
+    void write(std::string_view chunk) override {
+        out_.write(chunk);
+        bytes_ += chunk.size();
+    }
+    void flush() override { out_.flush(); }
+    std::size_t bytes() const { return bytes_; }
+
+private:
+    TemplateSink& out_;
+    std::size_t bytes_ = 0;
+};
+
+#ifdef _WIN32
+int closeFile(int fd) { return ::_close(fd); }
+#else
+int closeFile(int fd) { return ::close(fd); }
+#endif
+
+// Opens `path` for writing with `mode` as its permissions if it is created;
+// when `exclusive`, fails with EEXIST instead of opening an existing file.
+// Returns -1 with errno set on failure.
+int openForWriting(const std::string& path, bool exclusive, int mode) {
+#ifdef _WIN32
+    return ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY | (exclusive ? _O_EXCL : _O_TRUNC), mode);
+#else
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (exclusive ? O_EXCL : O_TRUNC), mode);
+#endif
+}
+
+// Passes a sink over the open file `fd`, which is `path`, to fill(sink),
+// closes it and returns its size. If anything fails the file is removed, so
+// no partial file is left behind.
+template <typename Fill>
+std::size_t fillFile(int fd, const std::string& path, Fill&& fill) {
+    std::size_t bytes = 0;
+    try {
+        FdSink out(fd);
+        CountingSink sink(out);
+        fill(sink);
+        sink.flush();
+        bytes = sink.bytes();
+    } catch (...) {
+        closeFile(fd);
+        std::remove(path.c_str());
+        throw;
+    }
+    if (closeFile(fd) != 0) {
+        const int error = errno;
+        std::remove(path.c_str());
+        throw std::runtime_error(std::strerror(error));
+    }
+    return bytes;
+}
+
+// Creates a file, passes a sink over it to fill(sink) and returns its size.
+template <typename Fill>
+std::size_t writeFileWith(const std::string& path, Fill&& fill) {
+    const int fd = openForWriting(path, false, 0644);
+    if (fd < 0) {
+        throw std::runtime_error(std::strerror(errno));
+    }
+    return fillFile(fd, path, std::forward<Fill>(fill));
+}
+
+// Creates a file next to `path` that no other writer uses, named
+// .<name>.<pid>-<n>.tmp so that it cannot clash with the user's own files.
+// Returns its descriptor and stores its name in `temporary`.
+int createTemporaryFor(const std::string& path, std::string& temporary) {
+    static std::atomic<unsigned long> counter{0};
+#ifdef _WIN32
+    const long pid = ::_getpid();
+#else
+    const long pid = static_cast<long>(::getpid());
+#endif
+    const fs::path target(path);
+    const std::string prefix = "." + target.filename().string() + "." + std::to_string(pid) + "-";
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        temporary = (target.parent_path() / (prefix + std::to_string(counter++) + ".tmp")).string();
+        const int fd = openForWriting(temporary, true, 0644);
+        if (fd >= 0 || errno != EEXIST) {
+            return fd;
+        }
+    }
+    errno = EEXIST;
+    return -1;
+}
+
+// Like writeFileWith, but writes a temporary file in the same directory and
+// renames it over `path`, so that the target holds either its old content or
+// all of the new. The new file keeps the permissions of the one it replaces.
+// The temporary file is removed on failure; only a crash can leave one.
+template <typename Fill>
+std::size_t replaceFileWith(const std::string& path, Fill&& fill) {
+    std::string temporary;
+    const int fd = createTemporaryFor(path, temporary);
+    if (fd < 0) {
+        throw std::runtime_error(std::strerror(errno));
+    }
+#ifndef _WIN32
+    struct stat existing;
+    if (::stat(path.c_str(), &existing) == 0 && ::fchmod(fd, existing.st_mode & 07777) != 0) {
+        const int error = errno;
+        closeFile(fd);
+        std::remove(temporary.c_str());
+        throw std::runtime_error(std::strerror(error));
+    }
+#endif
+    const std::size_t bytes = fillFile(fd, temporary, std::forward<Fill>(fill));
+    std::error_code ec;
+    fs::rename(temporary, path, ec);
+    if (ec) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error(ec.message());
+    }
+    return bytes;
+}
+
+template <typename Fill>
+std::size_t putFile(const std::string& path, OutputPlan::WriteMode mode, Fill&& fill) {
+    return mode == OutputPlan::WriteMode::InPlace ? writeFileWith(path, std::forward<Fill>(fill))
+                                                  : replaceFileWith(path, std::forward<Fill>(fill));
+}
+
+// Collects rendered output into a string.
+class StringSink : public TemplateSink {
+public:
+    explicit StringSink(std::string& out) : out_(out) {}
+    void write(std::string_view chunk) override { out_.append(chunk); }
+
+private:
+    std::string& out_;
+};
+
+// Calls visit(0) ... visit(count - 1) on `threads` threads, or inline for one.
+template <typename Visit>
+void forEachIndex(std::size_t count, std::size_t threads, Visit&& visit) {
+    if (threads <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            visit(i);
+        }
+        return;
+    }
+    ThreadPool pool(threads);
+    std::vector<std::future<void>> done;
+    done.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        done.push_back(pool.submit([&visit, i]() { visit(i); }));
+    }
+    for (std::future<void>& item : done) {
+        item.get();
+    }
+}
+
+// An exception's message, never empty.
+std::string describe(const std::exception& e) {
+    std::string message = e.what();
+    return message.empty() ? "unknown error" : message;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+// With WriteMode::Durable, syncs the filesystem holding `path` once anything
+// was written, and records the time or the failure in the report.
+void syncIfDurable(OutputPlan::WriteMode mode, const std::string& path, OutputPlan::Report& report) {
+    if (mode != OutputPlan::WriteMode::Durable || report.written.empty()) {
+        return;
+    }
+    auto started = std::chrono::steady_clock::now();
+    try {
+        OutputPlan::syncFilesystem(path);
+    } catch (const std::exception& e) {
+        report.failures.emplace_back(path, "sync failed: " + describe(e));
+    }
+    report.sync_ms = elapsedMs(started);
+}
+
+// Creates the directories of a plan and records them in the report. Sorting
+// puts parents before their children and drops duplicates.
+void createDirectories(std::vector<std::string> directories, OutputPlan::Report& report) {
+    std::sort(directories.begin(), directories.end());
+    directories.erase(std::unique(directories.begin(), directories.end()), directories.end());
+    for (const std::string& directory : directories) {
+        std::error_code ec;
+        if (fs::create_directories(directory, ec)) {
+            report.created_directories.push_back(directory);
+        } else if (ec) {
+            report.failures.emplace_back(directory, ec.message());
+        }
+    }
+}
+
+// What the manifest of writeIncremental() records about one file.
+struct ManifestEntry {
+    std::uint64_t hash = 0;
+    std::uintmax_t size = 0;
+    std::int64_t modified = 0;  // In the filesystem clock's ticks
+};
+
+// Paths relative to the root, sorted so that the same files give the same manifest.
+using Manifest = std::map<std::string, ManifestEntry>;
+
+constexpr const char* kManifestHeader = "template-manifest 1";
+
+constexpr std::uint64_t kStableHashSeed = 0xCBF29CE484222325ULL;
+
+// 64-bit FNV-1a. Unlike hashContent() it is fixed, so it can be stored.
+// Passing the hash of a prefix continues it over the bytes that follow.
+std::uint64_t stableHash(std::string_view bytes, std::uint64_t hash = kStableHashSeed) {
+    for (char c : bytes) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+// Hashes and counts what is written to it, optionally passing it on, and
+// compares it with `expected` as it goes, so output can be checked against
+// a file without being held in memory.
+class DigestSink : public TemplateSink {
+public:
+    explicit DigestSink(TemplateSink* out = nullptr, std::string_view expected = std::string_view())
+        : out_(out), expected_(expected) {}
+
+    void write(std::string_view chunk) override {
+        hash_ = stableHash(chunk, hash_);
+        matches_ = matches_ && chunk.size() <= expected_.size() - size_ &&
+                   (chunk.empty() || std::memcmp(expected_.data() + size_, chunk.data(), chunk.size()) == 0);
+        size_ += chunk.size();
+        if (out_) {
+            out_->write(chunk);
+        }
+    }
+    void flush() override {
+        if (out_) {
+            out_->flush();
+        }
+    }
+
+    std::uint64_t hash() const { return hash_; }
+    std::size_t size() const { return size_; }
+    bool matchesExpected() const { return matches_ && size_ == expected_.size(); }
+
+private:
+    TemplateSink* out_;
+    std::string_view expected_;
+    std::uint64_t hash_ = kStableHashSeed;
+    std::size_t size_ = 0;
+    bool matches_ = true;
+};
+
+// -1 if the time cannot be read, which no recorded time matches.
+std::int64_t modifiedTime(const std::string& path) {
+    std::error_code ec;
+    const fs::file_time_type time = fs::last_write_time(path, ec);
+    return ec ? -1 : static_cast<std::int64_t>(time.time_since_epoch().count());
+}
+
+// One "<hash> <size> <modified> <path>" line per file after the header. A
+// missing manifest, or one in another format, reads as empty.
+Manifest readManifest(const std::string& path) {
+    Manifest manifest;
+    std::ifstream in(path);
+    std::string line;
+    if (!std::getline(in, line) || line != kManifestHeader) {
+        return manifest;
+    }
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        ManifestEntry entry;
+        std::string file;
+        if (fields >> std::hex >> entry.hash >> std::dec >> entry.size >> entry.modified &&
+            fields.get() == ' ' && std::getline(fields, file) && !file.empty()) {
+            manifest[file] = entry;
+        }
+    }
+    return manifest;
+}
+
+std::string formatManifest(const Manifest& manifest) {
+    std::ostringstream out;
+    out << kManifestHeader << '\n';
+    for (const auto& file : manifest) {
+        out << std::hex << file.second.hash << std::dec << ' ' << file.second.size << ' '
+            << file.second.modified << ' ' << file.first << '\n';
+    }
+    return out.str();
+}
+
+// Writes a planned file's content to a sink.
+void fillPlannedFile(const OutputPlan::File& file, TemplateSink& sink) {
+    if (file.render) {
+        file.render(sink);
+    } else {
+        sink.write(file.text());
+    }
+}
+
+// Renders a planned file that exists on disk and reports whether the output
+// is what the file already holds, recording its hash and size in `entry`.
+// While the file's size and modification time match what the manifest
+// recorded, the hashes are compared and the file is not read; otherwise the
+// output is compared with the mapped file as it is rendered.
+bool reproducesFile(const OutputPlan::File& file, const ManifestEntry* recorded, std::uintmax_t size_on_disk,
+                    ManifestEntry& entry) {
+    entry.modified = modifiedTime(file.path);
+    const bool trusted = recorded && entry.modified >= 0 && recorded->size == size_on_disk &&
+                         recorded->modified == entry.modified;
+    if (trusted) {
+        DigestSink digest;
+        fillPlannedFile(file, digest);
+        entry.hash = digest.hash();
+        entry.size = digest.size();
+        return entry.hash == recorded->hash && entry.size == recorded->size;
+    }
+    std::unique_ptr<MappedFile> disk;
+    try {
+        disk = std::make_unique<MappedFile>(file.path, MappedFile::Access::Sequential);
+    } catch (const std::exception&) {
+        // Unreadable: it is rewritten, and a hash is still needed for the manifest.
+    }
+    DigestSink digest(nullptr, disk ? disk->view() : std::string_view());
+    fillPlannedFile(file, digest);
+    entry.hash = digest.hash();
+    entry.size = digest.size();
+    return disk && digest.matchesExpected();
+}
+
+// Writes one planned file and returns its size.
+std::size_t writePlannedFile(const OutputPlan::File& file, OutputPlan::WriteMode mode) {
+    return putFile(file.path, mode, [&file](TemplateSink& sink) { fillPlannedFile(file, sink); });
+}
+
+} // namespace
+
+void OutputPlan::addDirectory(std::string path) {
+    directories_.push_back(std::move(path));
+}
+
+void OutputPlan::addFile(std::string path, std::string content) {
+    files_.push_back({std::move(path), std::move(content), Render(), std::string_view(), false});
+}
+
+void OutputPlan::addFile(std::string path, Render render) {
+    files_.push_back({std::move(path), std::string(), std::move(render), std::string_view(), false});
+}
+
+void OutputPlan::addBorrowedFile(std::string path, std::string_view content) {
+    files_.push_back({std::move(path), std::string(), Render(), content, true});
+}
+
+OutputPlan::Report OutputPlan::write(std::size_t io_threads) const {
+    Report report;
+
+    auto started = std::chrono::steady_clock::now();
+    createDirectories(directories_, report);
+    report.directories_ms = elapsedMs(started);
+
+    started = std::chrono::steady_clock::now();
+    std::vector<std::size_t> sizes(files_.size(), 0);
+    std::vector<std::string> errors(files_.size());
+    report.io_threads = std::max<std::size_t>(1, std::min(io_threads, files_.size()));
+    forEachIndex(files_.size(), report.io_threads, [&](std::size_t i) {
+        try {
+            sizes[i] = writePlannedFile(files_[i], mode_);
+        } catch (const std::exception& e) {
+            errors[i] = describe(e);
+        }
+    });
+    report.files_ms = elapsedMs(started);
+
+    for (std::size_t i = 0; i < files_.size(); ++i) {
+        if (errors[i].empty()) {
+            report.written.push_back(files_[i].path);
+            report.bytes += sizes[i];
+        } else {
+            report.failures.emplace_back(files_[i].path, errors[i]);
+        }
+    }
+    if (!report.written.empty()) {
+        syncIfDurable(mode_, report.written.front(), report);
+    }
+    return report;
+}
+
+OutputPlan::Report OutputPlan::writeIncremental(const std::string& root, std::size_t io_threads) const {
+    Report report;
+    const std::string prefix = root + "/";
+    const std::string manifest_path = prefix + kManifestName;
+    const Manifest previous = readManifest(manifest_path);
+
+    auto started = std::chrono::steady_clock::now();
+    createDirectories(directories_, report);
+    report.directories_ms = elapsedMs(started);
+
+    enum class Outcome { Failed, Created, Updated, Unchanged };
+    started = std::chrono::steady_clock::now();
+    std::vector<Outcome> outcomes(files_.size(), Outcome::Failed);
+    std::vector<std::size_t> sizes(files_.size(), 0);
+    std::vector<std::string> errors(files_.size());
+    std::vector<ManifestEntry> entries(files_.size());
+    report.io_threads = std::max<std::size_t>(1, std::min(io_threads, files_.size()));
+    forEachIndex(files_.size(), report.io_threads, [&](std::size_t i) {
+        const File& file = files_[i];
+        try {
+            std::error_code ec;
+            const std::uintmax_t size_on_disk = fs::file_size(file.path, ec);
+            const bool existed = !ec;
+            if (file.path.compare(0, prefix.size(), prefix) != 0) {
+                sizes[i] = writePlannedFile(file, mode_);
+                outcomes[i] = existed ? Outcome::Updated : Outcome::Created;
+                return;
+            }
+
+            // An existing file is checked with one render that is not kept;
+            // only if it changed is the file rendered again, into the file.
+            ManifestEntry& entry = entries[i];
+            if (existed) {
+                auto recorded = previous.find(file.path.substr(prefix.size()));
+                if (reproducesFile(file, recorded != previous.end() ? &recorded->second : nullptr, size_on_disk,
+                                   entry)) {
+                    outcomes[i] = Outcome::Unchanged;
+                    return;
+                }
+            }
+            sizes[i] = putFile(file.path, mode_, [&file, &entry](TemplateSink& sink) {
+                DigestSink digest(&sink);
+                fillPlannedFile(file, digest);
+                entry.hash = digest.hash();
+                entry.size = digest.size();
+            });
+            entry.modified = modifiedTime(file.path);
+            outcomes[i] = existed ? Outcome::Updated : Outcome::Created;
+        } catch (const std::exception& e) {
+            errors[i] = describe(e);
+        }
+    });
+
+    Manifest manifest;
+    std::set<std::string_view> planned;
+    for (std::size_t i = 0; i < files_.size(); ++i) {
+        const std::string& path = files_[i].path;
+        const bool tracked = path.compare(0, prefix.size(), prefix) == 0;
+        if (tracked) {
+            planned.insert(std::string_view(path).substr(prefix.size()));
+        }
+        switch (outcomes[i]) {
+        case Outcome::Failed:
+            report.failures.emplace_back(path, errors[i]);
+            continue;
+        case Outcome::Unchanged:
+            report.unchanged.push_back(path);
+            break;
+        case Outcome::Updated:
+            report.updated.push_back(path);
+            [[fallthrough]];
+        case Outcome::Created:
+            report.written.push_back(path);
+            report.bytes += sizes[i];
+            break;
+        }
+        if (tracked) {
+            manifest[path.substr(prefix.size())] = entries[i];
+        }
+    }
+
+    // Files the plan no longer produces are reported, not deleted, for as
+    // long as they exist.
+    for (const auto& file : previous) {
+        std::error_code ec;
+        if (!planned.count(file.first) && fs::exists(prefix + file.first, ec)) {
+            report.stale.push_back(prefix + file.first);
+            manifest.insert(file);
+        }
+    }
+
+    // The manifest is replaced by renaming, so an interrupted run leaves the
+    // old one, which at worst makes the next run compare more files.
+    const std::string text = formatManifest(manifest);
+    if (text != formatManifest(previous)) {
+        try {
+            replaceFileWith(manifest_path, [&text](TemplateSink& sink) { sink.write(text); });
+        } catch (const std::exception& e) {
+            report.failures.emplace_back(manifest_path, describe(e));
+        }
+    }
+    report.files_ms = elapsedMs(started);
+    syncIfDurable(mode_, root, report);
+    return report;
+}
+
+void OutputPlan::syncFilesystem(const std::string& path) {
+#if defined(__linux__)
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error(std::strerror(errno));
+    }
+    const int result = ::syncfs(fd);
+    const int error = errno;
+    ::close(fd);
+    if (result != 0) {
+        throw std::runtime_error(std::strerror(error));
+    }
+#elif defined(_WIN32)
+    (void)path;
+#else
+    (void)path;
+    ::sync();
+#endif
+}
+
+void OutputPlan::append(OutputPlan&& other) {
+    directories_.insert(directories_.end(), std::make_move_iterator(other.directories_.begin()),
+                        std::make_move_iterator(other.directories_.end()));
+    files_.insert(files_.end(), std::make_move_iterator(other.files_.begin()),
+                  std::make_move_iterator(other.files_.end()));
+    other.directories_.clear();
+    other.files_.clear();
+}
+
+OutputPlan::Report OutputPlan::writeArchive(TarWriter& archive, std::size_t io_threads) const {
+    Report report;
+
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::string> contents(files_.size());
+    std::vector<std::string> errors(files_.size());
+    report.io_threads = std::max<std::size_t>(1, std::min(io_threads, files_.size()));
+    forEachIndex(files_.size(), report.io_threads, [&](std::size_t i) {
+        if (!files_[i].render) {
+            return;
+        }
+        try {
+            StringSink sink(contents[i]);
+            files_[i].render(sink);
+        } catch (const std::exception& e) {
+            errors[i] = describe(e);
+        }
+    });
+    report.files_ms = elapsedMs(started);
+
+    // Directories are archived in plan order; extractors create any parent
+    // that a plan does not list.
+    started = std::chrono::steady_clock::now();
+    std::set<std::string_view> archived;
+    for (const std::string& directory : directories_) {
+        if (archived.insert(directory).second) {
+            archive.addDirectory(directory);
+            report.created_directories.push_back(directory);
+        }
+    }
+    for (std::size_t i = 0; i < files_.size(); ++i) {
+        if (!errors[i].empty()) {
+            report.failures.emplace_back(files_[i].path, errors[i]);
+            continue;
+        }
+        const std::string_view content = files_[i].render ? std::string_view(contents[i]) : files_[i].text();
+        archive.addFile(files_[i].path, content);
+        report.written.push_back(files_[i].path);
+        report.bytes += content.size();
+        std::string().swap(contents[i]);
+    }
+    report.archive_ms = elapsedMs(started);
+    return report;
+}
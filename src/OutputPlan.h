@@ -0,0 +1,163 @@
+#ifndef OUTPUT_PLAN_H
+#define OUTPUT_PLAN_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class TarWriter;
+class TemplateSink;
+
+/**
+ * @brief The directories and files of a generated project, written in two passes.
+ *
+ * Generation records what it would write instead of touching the filesystem.
+ * write() then creates the whole directory tree in one pass and writes the
+ * files concurrently on a small pool of I/O threads, so the cost of opening
+ * and closing each file overlaps with the others. Files must not depend on
+ * each other; a file's render function may run on any I/O thread.
+ *
+ * By default each file is written under a temporary name and renamed into
+ * place, so a crash never leaves a truncated file, and the filesystem is
+ * synced once after the last rename instead of once per file.
+ *
+ * writeIncremental() leaves alone the files whose content has not changed
+ * since the last run, so that their modification times, and the builds that
+ * depend on them, are kept. writeArchive() instead renders the tree in memory
+ * and emits it as one sequential tar stream, with no per-file system calls
+ * at all.
+ */
+class OutputPlan {
+public:
+    /**
+     * @brief Writes the content of one file to a sink. Must be safe to call
+     * concurrently with the render functions of other files.
+     */
+    using Render = std::function<void(TemplateSink& sink)>;
+
+    struct File {
+        std::string path;
+        std::string content;        ///< Written when render is empty, unless borrowed
+        Render render;
+        std::string_view borrowed;  ///< Content owned by the caller; see addBorrowedFile()
+        bool is_borrowed = false;
+
+        /**
+         * @brief The content of a file without a render function.
+         */
+        std::string_view text() const { return is_borrowed ? borrowed : std::string_view(content); }
+    };
+
+    enum class WriteMode {
+        InPlace,  ///< Truncate and write each file where it is; a crash can leave partial files
+        Atomic,   ///< Write each file to a temporary name, then rename it over the target
+        Durable,  ///< Atomic, then one sync of the filesystem once every file is in place
+    };
+
+    /**
+     * @brief What write() or writeArchive() did, with files in the order they were added.
+     */
+    struct Report {
+        std::vector<std::string> created_directories;  ///< Directories that did not exist before, or were archived
+        std::vector<std::string> written;
+        std::vector<std::string> updated;    ///< Written files that existed with other content; writeIncremental() only
+        std::vector<std::string> unchanged;  ///< Files already up to date and left alone; writeIncremental() only
+        std::vector<std::string> stale;      ///< Files the last run wrote that are no longer planned; left in place
+        std::vector<std::pair<std::string, std::string>> failures;  ///< Path and error, directories included
+        std::size_t bytes = 0;                          ///< File content, without archive headers
+        std::size_t io_threads = 0;
+        double directories_ms = 0.0;
+        double files_ms = 0.0;                          ///< Writing, or for an archive rendering, the files
+        double archive_ms = 0.0;                        ///< Streaming the archive; writeArchive() only
+        double sync_ms = 0.0;                           ///< The final sync; WriteMode::Durable only
+    };
+
+    static constexpr std::size_t kDefaultIoThreads = 4;
+
+    /**
+     * @brief Name of the file writeIncremental() keeps in the root directory.
+     */
+    static constexpr const char* kManifestName = ".template-manifest";
+
+    void addDirectory(std::string path);
+    void addFile(std::string path, std::string content);
+    void addFile(std::string path, Render render);
+
+    /**
+     * @brief Adds a file whose content is not copied, such as text in a
+     * TextArena. The content must stay valid until the plan is written.
+     */
+    void addBorrowedFile(std::string path, std::string_view content);
+
+    /**
+     * @brief Moves the directories and files of another plan to the end of this one.
+     */
+    void append(OutputPlan&& other);
+
+    /**
+     * @brief How write() and writeIncremental() put files on disk; Durable by default.
+     */
+    void setWriteMode(WriteMode mode) { mode_ = mode; }
+    WriteMode writeMode() const { return mode_; }
+
+    const std::vector<std::string>& directories() const { return directories_; }
+    const std::vector<File>& files() const { return files_; }
+    bool empty() const { return directories_.empty() && files_.empty(); }
+
+    /**
+     * @brief Creates the directories, then writes the files as the write
+     * mode says. A file that cannot be opened, written or rendered is
+     * recorded in the report and does not stop the others; unless the mode
+     * is InPlace, such a file keeps its previous content.
+     * @param io_threads Maximum number of files written at once; at most one
+     *        thread per file is started, and 1 writes on the calling thread.
+     */
+    Report write(std::size_t io_threads = kDefaultIoThreads) const;
+
+    /**
+     * @brief Like write(), but only writes the files under `root` whose
+     * rendered bytes differ from what is on disk.
+     *
+     * `root`/.template-manifest records the hash, size and modification time
+     * of every file the last run wrote. A file whose new content hashes the
+     * same and whose size and modification time still match the manifest is
+     * skipped without being read; otherwise an existing file is compared
+     * byte for byte with the output as it is rendered. Nothing is held in
+     * memory: a file that turns out to differ is rendered a second time,
+     * straight into the file, so render functions must produce the same
+     * bytes each time they are called. New files are rendered once. The
+     * manifest is replaced afterwards, and a missing or unreadable one only
+     * means that every file is compared. Files outside `root` are always
+     * written.
+     */
+    Report writeIncremental(const std::string& root, std::size_t io_threads = kDefaultIoThreads) const;
+
+    /**
+     * @brief Renders the files into memory, then adds the directories and
+     * files to an archive in plan order. Rendering runs on up to
+     * `io_threads` threads; the archive is written on the calling thread. A
+     * file that fails to render is left out and recorded in the report. The
+     * caller finishes the archive, so several plans can share one.
+     * @throws std::invalid_argument if a path cannot be stored in the archive.
+     * @throws std::runtime_error if the archive's sink fails.
+     */
+    Report writeArchive(TarWriter& archive, std::size_t io_threads = kDefaultIoThreads) const;
+
+    /**
+     * @brief Flushes all pending writes of the filesystem that holds `path`
+     * to disk: syncfs() on Linux and sync() on other POSIX systems. Windows
+     * has no unprivileged equivalent, so there it does nothing.
+     * @throws std::runtime_error if `path` cannot be opened or the sync fails.
+     */
+    static void syncFilesystem(const std::string& path);
+
+private:
+    std::vector<std::string> directories_;
+    std::vector<File> files_;
+    WriteMode mode_ = WriteMode::Durable;
+};
+
+#endif // OUTPUT_PLAN_H
@@ -0,0 +1,1122 @@
+// Generated by template_precompiler from SQL/data.sql. Do not edit.
+#ifndef PRECOMPILED_TEMPLATES_H
+#define PRECOMPILED_TEMPLATES_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "TemplatePrecompiler.h"
+
+namespace PrecompiledTemplatesDetail {
+
+// generic/.gitignore
+inline constexpr std::string_view t0_literal0 = std::string_view("# Compiled Object files\n"
+        "*.slo\n"
+        "*.lo\n"
+        "*.o\n"
+        "*.obj\n"
+        "\n"
+        "# Precompiled Headers\n"
+        "*.gch\n"
+        "*.pch\n"
+        "\n"
+        "# Compiled Dynamic libraries\n"
+        "*.so\n"
+        "*.dylib\n"
+        "*.dll\n"
+        "\n"
+        "# Fortran module files\n"
+        "*.mod\n"
+        "*.smod\n"
+        "\n"
+        "# Compiled Static libraries\n"
+        "*.lai\n"
+        "*.la\n"
+        "*.a\n"
+        "*.lib\n"
+        "\n"
+        "# Executables\n"
+        "*.exe\n"
+        "*.out\n"
+        "*.app\n"
+        "\n"
+        "# Build directories\n"
+        "build/\n"
+        "obj/\n"
+        "bin/\n"
+        "pgo-profiles/\n"
+        "\n"
+        "# IDE files\n"
+        ".vscode/\n"
+        ".vs/\n"
+        "*.vcxproj*\n"
+        "*.sln\n"
+        "\n"
+        "# CMake\n"
+        "CMakeCache.txt\n"
+        "CMakeFiles/\n"
+        "cmake_install.cmake\n"
+        "Makefile\n"
+        "\n"
+        "# Debug files\n"
+        "*.dSYM/\n"
+        "*.su\n"
+        "*.idb\n"
+        "*.pdb\n"
+        "\n"
+        "# Generator manifest\n"
+        ".template-manifest\n"
+        "\n"
+        "# Project specific\n", 511);
+inline constexpr std::string_view t0_literal1 = std::string_view("\n", 1);
+inline constexpr std::string_view t0_literal2 = std::string_view("_tests\n", 7);
+
+inline std::string render0(const ProjectConfig& config) {
+    std::string out;
+    out.reserve(519 + 2 * config.name.size());
+    out.append(t0_literal0);
+    out.append(config.name);
+    out.append(t0_literal1);
+    out.append(config.name);
+    out.append(t0_literal2);
+    return out;
+}
+
+inline void renderTo0(const ProjectConfig& config, TemplateSink& sink) {
+    sink.write(t0_literal0);
+    sink.write(config.name);
+    sink.write(t0_literal1);
+    sink.write(config.name);
+    sink.write(t0_literal2);
+}
+
+// generic/CMakeLists.txt
+inline constexpr std::string_view t1_literal0 = std::string_view("cmake_minimum_required(VERSION 3.12)\n"
+        "project(", 45);
+inline constexpr std::string_view t1_literal1 = std::string_view(" VERSION ", 9);
+inline constexpr std::string_view t1_literal2 = std::string_view(")\n"
+        "\n"
+        "set(CMAKE_CXX_STANDARD 17)\n"
+        "set(CMAKE_CXX_STANDARD_REQUIRED ON)\n"
+        "\n"
+        "# Build profiles. Without a preset this is a Release build with link-time\n"
+        "# optimization; CMakePresets.json selects the others:\n"
+        "#   cmake --preset native        Release tuned for this machine (-march=native)\n"
+        "#   cmake --preset pgo-generate  Instrumented build: build it, run a typical workload,\n"
+        "#   cmake --preset pgo-use       then rebuild in the same directory with the profile\n"
+        "if(NOT CMAKE_BUILD_TYPE AND NOT CMAKE_CONFIGURATION_TYPES)\n"
+        "    set(CMAKE_BUILD_TYPE Release CACHE STRING \"Build type\" FORCE)\n"
+        "endif()\n"
+        "option(ENABLE_LTO \"Link-time optimization outside Debug builds\" ON)\n"
+        "option(ENABLE_NATIVE_ARCH \"Tune for the building machine (-march=native)\" OFF)\n"
+        "set(PGO_PHASE OFF CACHE STRING \"Profile-guided optimization: OFF, GENERATE or USE\")\n"
+        "set_property(CACHE PGO_PHASE PROPERTY STRINGS OFF GENERATE USE)\n"
+        "set(PGO_DIR \"${CMAKE_BINARY_DIR}/pgo-profiles\" CACHE PATH \"Where PGO profiles are written and read\")\n"
+        "\n"
+        "if(ENABLE_LTO AND NOT CMAKE_BUILD_TYPE STREQUAL \"Debug\")\n"
+        "    include(CheckIPOSupported)\n"
+        "    check_ipo_supported(RESULT lto_supported OUTPUT lto_error)\n"
+        "    if(lto_supported)\n"
+        "        set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)\n"
+        "    else()\n"
+        "        message(WARNING \"Link-time optimization is not available: ${lto_error}\")\n"
+        "    endif()\n"
+        "endif()\n"
+        "if(CMAKE_CXX_COMPILER_ID MATCHES \"GNU|Clang\")\n"
+        "    if(ENABLE_NATIVE_ARCH)\n"
+        "        add_compile_options(-march=native)\n"
+        "    endif()\n"
+        "    if(PGO_PHASE STREQUAL \"GENERATE\")\n"
+        "        add_compile_options(-fprofile-generate=${PGO_DIR})\n"
+        "        string(APPEND CMAKE_EXE_LINKER_FLAGS \" -fprofile-generate=${PGO_DIR}\")\n"
+        "        string(APPEND CMAKE_SHARED_LINKER_FLAGS \" -fprofile-generate=${PGO_DIR}\")\n"
+        "    elseif(PGO_PHASE STREQUAL \"USE\")\n"
+        "        # Clang needs the raw profiles merged first:\n"
+        "        #   llvm-profdata merge -o ${PGO_DIR}/default.profdata ${PGO_DIR}/*.profraw\n"
+        "        add_compile_options(-fprofile-use=${PGO_DIR})\n"
+        "        if(CMAKE_CXX_COMPILER_ID STREQUAL \"GNU\")\n"
+        "            add_compile_options(-fprofile-correction -Wno-missing-profile)\n"
+        "        endif()\n"
+        "    endif()\n"
+        "endif()\n"
+        "\n"
+        "# Include directories\n"
+        "include_directories(include)\n"
+        "\n", 2140);
+inline constexpr std::string_view t1_literal3 = std::string_view("# Executable\n"
+        "add_executable(", 28);
+inline constexpr std::string_view t1_literal4 = std::string_view("\n"
+        "    src/main.cpp\n"
+        "    src/", 26);
+inline constexpr std::string_view t1_literal5 = std::string_view(".cpp\n", 5);
+inline constexpr std::string_view t1_literal6 = std::string_view("    src/LikertScale.cpp\n", 24);
+inline constexpr std::string_view t1_literal7 = std::string_view(")\n"
+        "\n", 3);
+inline constexpr std::string_view t1_literal8 = std::string_view("# Static Library\n"
+        "add_library(", 29);
+inline constexpr std::string_view t1_literal9 = std::string_view(" STATIC\n"
+        "    src/", 16);
+inline constexpr std::string_view t1_literal10 = std::string_view(".cpp\n", 5);
+inline constexpr std::string_view t1_literal11 = std::string_view("    src/LikertScale.cpp\n", 24);
+inline constexpr std::string_view t1_literal12 = std::string_view(")\n"
+        "\n", 3);
+inline constexpr std::string_view t1_literal13 = std::string_view("# Shared Library\n"
+        "add_library(", 29);
+inline constexpr std::string_view t1_literal14 = std::string_view(" SHARED\n"
+        "    src/", 16);
+inline constexpr std::string_view t1_literal15 = std::string_view(".cpp\n", 5);
+inline constexpr std::string_view t1_literal16 = std::string_view("    src/LikertScale.cpp\n", 24);
+inline constexpr std::string_view t1_literal17 = std::string_view(")\n"
+        "# Calls within the library bind locally instead of going through the PLT\n"
+        "if(CMAKE_CXX_COMPILER_ID MATCHES \"GNU|Clang\" AND NOT APPLE)\n"
+        "    target_compile_options(", 162);
+inline constexpr std::string_view t1_literal18 = std::string_view(" PRIVATE -fno-plt -fno-semantic-interposition)\n"
+        "endif()\n"
+        "\n", 56);
+inline constexpr std::string_view t1_literal19 = std::string_view("# Header-only Library\n"
+        "add_library(", 34);
+inline constexpr std::string_view t1_literal20 = std::string_view(" INTERFACE)\n"
+        "target_include_directories(", 39);
+inline constexpr std::string_view t1_literal21 = std::string_view(" INTERFACE include)\n"
+        "\n", 21);
+inline constexpr std::string_view t1_literal22 = std::string_view("# Test Executable\n"
+        "enable_testing()\n"
+        "add_executable(", 50);
+inline constexpr std::string_view t1_literal23 = std::string_view("\n"
+        "    src/main.cpp\n"
+        "    src/", 26);
+inline constexpr std::string_view t1_literal24 = std::string_view(".cpp\n", 5);
+inline constexpr std::string_view t1_literal25 = std::string_view("    src/LikertScale.cpp\n", 24);
+inline constexpr std::string_view t1_literal26 = std::string_view(")\n"
+        "add_test(NAME ", 16);
+inline constexpr std::string_view t1_literal27 = std::string_view(" COMMAND ", 9);
+inline constexpr std::string_view t1_literal28 = std::string_view(")\n"
+        "\n", 3);
+inline constexpr std::string_view t1_literal29 = std::string_view("# Tests\n"
+        "enable_testing()\n"
+        "add_executable(", 40);
+inline constexpr std::string_view t1_literal30 = std::string_view("_tests\n"
+        "    tests/test_", 22);
+inline constexpr std::string_view t1_literal31 = std::string_view(".cpp\n"
+        ")\n", 7);
+inline constexpr std::string_view t1_literal32 = std::string_view("target_link_libraries(", 22);
+inline constexpr std::string_view t1_literal33 = std::string_view("_tests PRIVATE ", 15);
+inline constexpr std::string_view t1_literal34 = std::string_view(")\n", 2);
+inline constexpr std::string_view t1_literal35 = std::string_view("add_test(NAME ", 14);
+inline constexpr std::string_view t1_literal36 = std::string_view("_tests COMMAND ", 15);
+inline constexpr std::string_view t1_literal37 = std::string_view("_tests)\n"
+        "\n", 9);
+inline constexpr std::string_view t1_literal38 = std::string_view("# Dependencies\n"
+        "target_link_libraries(", 37);
+inline constexpr std::string_view t1_literal39 = std::string_view(" ", 1);
+inline constexpr std::string_view t1_literal40 = std::string_view("INTERFACE", 9);
+inline constexpr std::string_view t1_literal41 = std::string_view("PRIVATE", 7);
+inline constexpr std::string_view t1_literal42 = std::string_view(" ", 1);
+inline constexpr std::string_view t1_literal43 = std::string_view(")\n"
+        "\n", 3);
+inline constexpr std::string_view t1_literal44 = std::string_view("# Compiler flags\n"
+        "target_compile_options(", 40);
+inline constexpr std::string_view t1_literal45 = std::string_view(" PRIVATE\n"
+        "    -Wall -Wextra -Wpedantic\n"
+        ")\n"
+        "\n", 41);
+inline constexpr std::string_view t1_literal46 = std::string_view("# Installation\n", 15);
+inline constexpr std::string_view t1_literal47 = std::string_view("install(TARGETS ", 16);
+inline constexpr std::string_view t1_literal48 = std::string_view(" DESTINATION ", 13);
+inline constexpr std::string_view t1_literal49 = std::string_view("lib", 3);
+inline constexpr std::string_view t1_literal50 = std::string_view("bin", 3);
+inline constexpr std::string_view t1_literal51 = std::string_view(")\n", 2);
+inline constexpr std::string_view t1_literal52 = std::string_view("install(FILES include/", 22);
+inline constexpr std::string_view t1_literal53 = std::string_view(".h DESTINATION include)\n", 24);
+
+inline std::string render1(const ProjectConfig& config) {
+    std::string out;
+    out.reserve(3259 + 24 * config.name.size() + config.version.size());
+    const std::vector<std::string>* list0 = nullptr;
+    std::size_t item0 = 0;
+    out.append(t1_literal0);
+    out.append(config.name);
+    out.append(t1_literal1);
+    out.append(config.version);
+    out.append(t1_literal2);
+    if (!kProjectConfigConditions[12].test(config)) goto l15;  // executable
+    out.append(t1_literal3);
+    out.append(config.name);
+    out.append(t1_literal4);
+    out.append(config.name);
+    out.append(t1_literal5);
+    if (!kProjectConfigConditions[3].test(config)) goto l13;  // includeLikertScale
+    out.append(t1_literal6);
+l13:
+    out.append(t1_literal7);
+    goto l57;
+l15:
+    if (!kProjectConfigConditions[7].test(config)) goto l25;  // static_library
+    out.append(t1_literal8);
+    out.append(config.name);
+    out.append(t1_literal9);
+    out.append(config.name);
+    out.append(t1_literal10);
+    if (!kProjectConfigConditions[3].test(config)) goto l23;  // includeLikertScale
+    out.append(t1_literal11);
+l23:
+    out.append(t1_literal12);
+    goto l57;
+l25:
+    if (!kProjectConfigConditions[8].test(config)) goto l37;  // shared_library
+    out.append(t1_literal13);
+    out.append(config.name);
+    out.append(t1_literal14);
+    out.append(config.name);
+    out.append(t1_literal15);
+    if (!kProjectConfigConditions[3].test(config)) goto l33;  // includeLikertScale
+    out.append(t1_literal16);
+l33:
+    out.append(t1_literal17);
+    out.append(config.name);
+    out.append(t1_literal18);
+    goto l57;
+l37:
+    if (!kProjectConfigConditions[9].test(config)) goto l44;  // header_only
+    out.append(t1_literal19);
+    out.append(config.name);
+    out.append(t1_literal20);
+    out.append(config.name);
+    out.append(t1_literal21);
+    goto l57;
+l44:
+    if (!kProjectConfigConditions[11].test(config)) goto l57;  // unit_test
+    out.append(t1_literal22);
+    out.append(config.name);
+    out.append(t1_literal23);
+    out.append(config.name);
+    out.append(t1_literal24);
+    if (!kProjectConfigConditions[3].test(config)) goto l52;  // includeLikertScale
+    out.append(t1_literal25);
+l52:
+    out.append(t1_literal26);
+    out.append(config.name);
+    out.append(t1_literal27);
+    out.append(config.name);
+    out.append(t1_literal28);
+l57:
+    if (!kProjectConfigConditions[1].test(config)) goto l75;  // includeTests
+    if (kProjectConfigConditions[11].test(config)) goto l75;  // unit_test
+    out.append(t1_literal29);
+    out.append(config.name);
+    out.append(t1_literal30);
+    out.append(config.name);
+    out.append(t1_literal31);
+    if (!kProjectConfigConditions[13].test(config)) goto l70;  // library
+    out.append(t1_literal32);
+    out.append(config.name);
+    out.append(t1_literal33);
+    out.append(config.name);
+    out.append(t1_literal34);
+l70:
+    out.append(t1_literal35);
+    out.append(config.name);
+    out.append(t1_literal36);
+    out.append(config.name);
+    out.append(t1_literal37);
+l75:
+    if (!kProjectConfigConditions[14].test(config)) goto l88;  // dependencies
+    out.append(t1_literal38);
+    out.append(config.name);
+    out.append(t1_literal39);
+    if (!kProjectConfigConditions[9].test(config)) goto l82;  // header_only
+    out.append(t1_literal40);
+    goto l83;
+l82:
+    out.append(t1_literal41);
+l83:
+    list0 = &config.dependencies;
+    if (list0->empty()) goto l87;
+    item0 = 0;
+l84:
+    out.append(t1_literal42);
+    out.append((*list0)[item0]);
+    if (++item0 < list0->size()) goto l84;
+l87:
+    out.append(t1_literal43);
+l88:
+    if (kProjectConfigConditions[9].test(config)) goto l92;  // header_only
+    out.append(t1_literal44);
+    out.append(config.name);
+    out.append(t1_literal45);
+l92:
+    out.append(t1_literal46);
+    if (kProjectConfigConditions[9].test(config)) goto l102;  // header_only
+    out.append(t1_literal47);
+    out.append(config.name);
+    out.append(t1_literal48);
+    if (!kProjectConfigConditions[13].test(config)) goto l100;  // library
+    out.append(t1_literal49);
+    goto l101;
+l100:
+    out.append(t1_literal50);
+l101:
+    out.append(t1_literal51);
+l102:
+    out.append(t1_literal52);
+    out.append(config.name);
+    out.append(t1_literal53);
+    return out;
+}
+
+inline void renderTo1(const ProjectConfig& config, TemplateSink& sink) {
+    const std::vector<std::string>* list0 = nullptr;
+    std::size_t item0 = 0;
+    sink.write(t1_literal0);
+    sink.write(config.name);
+    sink.write(t1_literal1);
+    sink.write(config.version);
+    sink.write(t1_literal2);
+    if (!kProjectConfigConditions[12].test(config)) goto l15;  // executable
+    sink.write(t1_literal3);
+    sink.write(config.name);
+    sink.write(t1_literal4);
+    sink.write(config.name);
+    sink.write(t1_literal5);
+    if (!kProjectConfigConditions[3].test(config)) goto l13;  // includeLikertScale
+    sink.write(t1_literal6);
+l13:
+    sink.write(t1_literal7);
+    goto l57;
+l15:
+    if (!kProjectConfigConditions[7].test(config)) goto l25;  // static_library
+    sink.write(t1_literal8);
+    sink.write(config.name);
+    sink.write(t1_literal9);
+    sink.write(config.name);
+    sink.write(t1_literal10);
+    if (!kProjectConfigConditions[3].test(config)) goto l23;  // includeLikertScale
+    sink.write(t1_literal11);
+l23:
+    sink.write(t1_literal12);
+    goto l57;
+l25:
+    if (!kProjectConfigConditions[8].test(config)) goto l37;  // shared_library
+    sink.write(t1_literal13);
+    sink.write(config.name);
+    sink.write(t1_literal14);
+    sink.write(config.name);
+    sink.write(t1_literal15);
+    if (!kProjectConfigConditions[3].test(config)) goto l33;  // includeLikertScale
+    sink.write(t1_literal16);
+l33:
+    sink.write(t1_literal17);
+    sink.write(config.name);
+    sink.write(t1_literal18);
+    goto l57;
+l37:
+    if (!kProjectConfigConditions[9].test(config)) goto l44;  // header_only
+    sink.write(t1_literal19);
+    sink.write(config.name);
+    sink.write(t1_literal20);
+    sink.write(config.name);
+    sink.write(t1_literal21);
+    goto l57;
+l44:
+    if (!kProjectConfigConditions[11].test(config)) goto l57;  // unit_test
+    sink.write(t1_literal22);
+    sink.write(config.name);
+    sink.write(t1_literal23);
+    sink.write(config.name);
+    sink.write(t1_literal24);
+    if (!kProjectConfigConditions[3].test(config)) goto l52;  // includeLikertScale
+    sink.write(t1_literal25);
+l52:
+    sink.write(t1_literal26);
+    sink.write(config.name);
+    sink.write(t1_literal27);
+    sink.write(config.name);
+    sink.write(t1_literal28);
+l57:
+    if (!kProjectConfigConditions[1].test(config)) goto l75;  // includeTests
+    if (kProjectConfigConditions[11].test(config)) goto l75;  // unit_test
+    sink.write(t1_literal29);
+    sink.write(config.name);
+    sink.write(t1_literal30);
+    sink.write(config.name);
+    sink.write(t1_literal31);
+    if (!kProjectConfigConditions[13].test(config)) goto l70;  // library
+    sink.write(t1_literal32);
+    sink.write(config.name);
+    sink.write(t1_literal33);
+    sink.write(config.name);
+    sink.write(t1_literal34);
+l70:
+    sink.write(t1_literal35);
+    sink.write(config.name);
+    sink.write(t1_literal36);
+    sink.write(config.name);
+    sink.write(t1_literal37);
+l75:
+    if (!kProjectConfigConditions[14].test(config)) goto l88;  // dependencies
+    sink.write(t1_literal38);
+    sink.write(config.name);
+    sink.write(t1_literal39);
+    if (!kProjectConfigConditions[9].test(config)) goto l82;  // header_only
+    sink.write(t1_literal40);
+    goto l83;
+l82:
+    sink.write(t1_literal41);
+l83:
+    list0 = &config.dependencies;
+    if (list0->empty()) goto l87;
+    item0 = 0;
+l84:
+    sink.write(t1_literal42);
+    sink.write((*list0)[item0]);
+    if (++item0 < list0->size()) goto l84;
+l87:
+    sink.write(t1_literal43);
+l88:
+    if (kProjectConfigConditions[9].test(config)) goto l92;  // header_only
+    sink.write(t1_literal44);
+    sink.write(config.name);
+    sink.write(t1_literal45);
+l92:
+    sink.write(t1_literal46);
+    if (kProjectConfigConditions[9].test(config)) goto l102;  // header_only
+    sink.write(t1_literal47);
+    sink.write(config.name);
+    sink.write(t1_literal48);
+    if (!kProjectConfigConditions[13].test(config)) goto l100;  // library
+    sink.write(t1_literal49);
+    goto l101;
+l100:
+    sink.write(t1_literal50);
+l101:
+    sink.write(t1_literal51);
+l102:
+    sink.write(t1_literal52);
+    sink.write(config.name);
+    sink.write(t1_literal53);
+}
+
+// generic/CMakePresets.json
+inline constexpr std::string_view t2_literal0 = std::string_view("{\n"
+        "    \"version\": 3,\n"
+        "    \"cmakeMinimumRequired\": {\n"
+        "        \"major\": 3,\n"
+        "        \"minor\": 21,\n"
+        "        \"patch\": 0\n"
+        "    },\n"
+        "    \"configurePresets\": [\n"
+        "        {\n"
+        "            \"name\": \"release\",\n"
+        "            \"displayName\": \"Release with link-time optimization\",\n"
+        "            \"binaryDir\": \"${sourceDir}/build/release\",\n"
+        "            \"cacheVariables\": {\n"
+        "                \"CMAKE_BUILD_TYPE\": \"Release\",\n"
+        "                \"ENABLE_LTO\": \"ON\"\n"
+        "            }\n"
+        "        },\n"
+        "        {\n"
+        "            \"name\": \"debug\",\n"
+        "            \"displayName\": \"Debug\",\n"
+        "            \"binaryDir\": \"${sourceDir}/build/debug\",\n"
+        "            \"cacheVariables\": {\n"
+        "                \"CMAKE_BUILD_TYPE\": \"Debug\",\n"
+        "                \"ENABLE_LTO\": \"OFF\"\n"
+        "            }\n"
+        "        },\n"
+        "        {\n"
+        "            \"name\": \"native\",\n"
+        "            \"inherits\": \"release\",\n"
+        "            \"displayName\": \"Release tuned for this machine\",\n"
+        "            \"binaryDir\": \"${sourceDir}/build/native\",\n"
+        "            \"cacheVariables\": {\n"
+        "                \"ENABLE_NATIVE_ARCH\": \"ON\"\n"
+        "            }\n"
+        "        },\n"
+        "        {\n"
+        "            \"name\": \"pgo-generate\",\n"
+        "            \"inherits\": \"release\",\n"
+        "            \"displayName\": \"PGO step 1: instrumented build\",\n"
+        "            \"binaryDir\": \"${sourceDir}/build/pgo\",\n"
+        "            \"cacheVariables\": {\n"
+        "                \"PGO_PHASE\": \"GENERATE\"\n"
+        "            }\n"
+        "        },\n"
+        "        {\n"
+        "            \"name\": \"pgo-use\",\n"
+        "            \"inherits\": \"pgo-generate\",\n"
+        "            \"displayName\": \"PGO step 2: optimized with the recorded profile\",\n"
+        "            \"cacheVariables\": {\n"
+        "                \"PGO_PHASE\": \"USE\"\n"
+        "            }\n"
+        "        }\n"
+        "    ],\n"
+        "    \"buildPresets\": [\n"
+        "        { \"name\": \"release\", \"configurePreset\": \"release\" },\n"
+        "        { \"name\": \"debug\", \"configurePreset\": \"debug\" },\n"
+        "        { \"name\": \"native\", \"configurePreset\": \"native\" },\n"
+        "        { \"name\": \"pgo-generate\", \"configurePreset\": \"pgo-generate\" },\n"
+        "        { \"name\": \"pgo-use\", \"configurePreset\": \"pgo-use\" }\n"
+        "    ]\n"
+        "}\n", 1885);
+
+inline std::string render2(const ProjectConfig&) {
+    std::string out;
+    out.reserve(1885);
+    out.append(t2_literal0);
+    return out;
+}
+
+inline void renderTo2(const ProjectConfig&, TemplateSink& sink) {
+    sink.write(t2_literal0);
+}
+
+// generic/LICENSE
+inline constexpr std::string_view t3_literal0 = std::string_view("MIT License\n"
+        "\n"
+        "Copyright (c) 2024 ", 32);
+inline constexpr std::string_view t3_literal1 = std::string_view("\n"
+        "\n"
+        "Permission is hereby granted, free of charge, to any person obtaining a copy\n"
+        "of this software and associated documentation files (the \"Software\"), to deal\n"
+        "in the Software without restriction, including without limitation the rights\n"
+        "to use, copy, modify, merge, publish, distribute, sublicense, and/or sell\n"
+        "copies of the Software, and to permit persons to whom the Software is\n"
+        "furnished to do so, subject to the following conditions:\n"
+        "\n"
+        "The above copyright notice and this permission notice shall be included in all\n"
+        "copies or substantial portions of the Software.\n"
+        "\n"
+        "THE SOFTWARE IS PROVIDED \"AS IS\", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR\n"
+        "IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,\n"
+        "FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE\n"
+        "AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER\n"
+        "LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,\n"
+        "OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE\n"
+        "SOFTWARE.", 1024);
+
+inline std::string render3(const ProjectConfig& config) {
+    std::string out;
+    out.reserve(1056 + config.author.size());
+    out.append(t3_literal0);
+    out.append(config.author);
+    out.append(t3_literal1);
+    return out;
+}
+
+inline void renderTo3(const ProjectConfig& config, TemplateSink& sink) {
+    sink.write(t3_literal0);
+    sink.write(config.author);
+    sink.write(t3_literal1);
+}
+
+// generic/Makefile
+inline constexpr std::string_view t4_literal0 = std::string_view("# Makefile for ", 15);
+inline constexpr std::string_view t4_literal1 = std::string_view("\n", 1);
+inline constexpr std::string_view t4_literal2 = std::string_view("#\n"
+        "# ", 4);
+inline constexpr std::string_view t4_literal3 = std::string_view(" is header-only: `make` checks that the header compiles on its own\n"
+        "# and `make install` copies it.\n"
+        "\n"
+        "CXX = g++\n"
+        "CXXFLAGS = -std=c++17 -Wall -Wextra -Wpedantic -Iinclude\n"
+        "HEADER = include/", 184);
+inline constexpr std::string_view t4_literal4 = std::string_view(".h\n"
+        "\n"
+        ".PHONY: all clean install\n"
+        "\n"
+        "all:\n"
+        "\t$(CXX) $(CXXFLAGS) -fsyntax-only -x c++ $(HEADER)\n"
+        "\n"
+        "clean:\n"
+        "\n"
+        "install:\n"
+        "\tcp $(HEADER) /usr/local/include/\n", 139);
+inline constexpr std::string_view t4_literal5 = std::string_view("#\n"
+        "# `make` builds the release profile: -O3 with link-time optimization.\n"
+        "#   make debug           Unoptimized, with debug information\n"
+        "#   make NATIVE=1        Release tuned for this machine (-march=native)\n", 205);
+inline constexpr std::string_view t4_literal6 = std::string_view("#   make pgo PGO_TRAIN=<command>\n"
+        "#                        Instrumented build, a training run of <command>, then\n"
+        "#                        a rebuild optimized with the recorded profile. The\n"
+        "#                        command must run a program that uses the instrumented\n"
+        "#                        library", 299);
+inline constexpr std::string_view t4_literal7 = std::string_view(" and is linked with -fprofile-generate", 38);
+inline constexpr std::string_view t4_literal8 = std::string_view(".\n", 2);
+inline constexpr std::string_view t4_literal9 = std::string_view("#   make pgo             Instrumented build, a training run of PGO_TRAIN, then\n"
+        "#                        a rebuild optimized with the recorded profile\n", 150);
+inline constexpr std::string_view t4_literal10 = std::string_view("\n"
+        "CXX = g++\n", 11);
+inline constexpr std::string_view t4_literal11 = std::string_view("AR = gcc-ar\n", 12);
+inline constexpr std::string_view t4_literal12 = std::string_view("CXXFLAGS = -std=c++17 -Wall -Wextra -Wpedantic -Iinclude\n", 57);
+inline constexpr std::string_view t4_literal13 = std::string_view("# Calls within the library bind locally instead of going through the PLT\n"
+        "CXXFLAGS += -fPIC -fno-plt -fno-semantic-interposition\n", 128);
+inline constexpr std::string_view t4_literal14 = std::string_view("LDFLAGS =\n"
+        "SRCDIR = src\n"
+        "OBJDIR = obj\n"
+        "SOURCES = $(wildcard $(SRCDIR)/*.cpp)\n"
+        "OBJECTS = $(SOURCES:$(SRCDIR)/%.cpp=$(OBJDIR)/%.o)\n"
+        "TARGET = ", 134);
+inline constexpr std::string_view t4_literal15 = std::string_view("lib", 3);
+inline constexpr std::string_view t4_literal16 = std::string_view(".a", 2);
+inline constexpr std::string_view t4_literal17 = std::string_view("lib", 3);
+inline constexpr std::string_view t4_literal18 = std::string_view(".so", 3);
+inline constexpr std::string_view t4_literal19 = std::string_view("\n", 1);
+inline constexpr std::string_view t4_literal20 = std::string_view("LDLIBS =", 8);
+inline constexpr std::string_view t4_literal21 = std::string_view(" -l", 3);
+inline constexpr std::string_view t4_literal22 = std::string_view("\n", 1);
+inline constexpr std::string_view t4_literal23 = std::string_view("\n"
+        "RELEASE_FLAGS = -O3 -DNDEBUG -flto=auto\n"
+        "ifeq ($(NATIVE),1)\n"
+        "RELEASE_FLAGS += -march=native\n"
+        "endif\n"
+        "PGO_DIR = $(CURDIR)/pgo-profiles\n", 130);
+inline constexpr std::string_view t4_literal24 = std::string_view("PGO_TRAIN = ./$(TARGET)\n", 24);
+inline constexpr std::string_view t4_literal25 = std::string_view("\n"
+        ".PHONY: all clean debug release pgo pgo-generate pgo-use\n"
+        "\n"
+        "all: release\n"
+        "\n"
+        "$(TARGET): $(OBJECTS)\n", 95);
+inline constexpr std::string_view t4_literal26 = std::string_view("\t$(AR) rcs $@ $(OBJECTS)\n", 25);
+inline constexpr std::string_view t4_literal27 = std::string_view("\t$(CXX)", 7);
+inline constexpr std::string_view t4_literal28 = std::string_view(" -shared", 8);
+inline constexpr std::string_view t4_literal29 = std::string_view(" $(LDFLAGS) $(OBJECTS) -o $@", 28);
+inline constexpr std::string_view t4_literal30 = std::string_view(" $(LDLIBS)", 10);
+inline constexpr std::string_view t4_literal31 = std::string_view("\n", 1);
+inline constexpr std::string_view t4_literal32 = std::string_view("\n"
+        "$(OBJDIR)/%.o: $(SRCDIR)/%.cpp | $(OBJDIR)\n"
+        "\t$(CXX) $(CXXFLAGS) -c $< -o $@\n"
+        "\n"
+        "$(OBJDIR):\n"
+        "\tmkdir -p $(OBJDIR)\n"
+        "\n"
+        "debug: CXXFLAGS += -g -DDEBUG\n"
+        "debug: $(TARGET)\n"
+        "\n"
+        "release: CXXFLAGS += $(RELEASE_FLAGS)\n"
+        "release: LDFLAGS += $(RELEASE_FLAGS)\n"
+        "release: $(TARGET)\n"
+        "\n"
+        "pgo-generate: CXXFLAGS += $(RELEASE_FLAGS) -fprofile-generate=$(PGO_DIR)\n"
+        "pgo-generate: LDFLAGS += $(RELEASE_FLAGS) -fprofile-generate=$(PGO_DIR)\n"
+        "pgo-generate: $(TARGET)\n"
+        "\n"
+        "pgo-use: CXXFLAGS += $(RELEASE_FLAGS) -fprofile-use=$(PGO_DIR) -fprofile-correction -Wno-missing-profile\n"
+        "pgo-use: LDFLAGS += $(RELEASE_FLAGS) -fprofile-use=$(PGO_DIR)\n"
+        "pgo-use: $(TARGET)\n"
+        "\n"
+        "# Both phases build in $(OBJDIR), so the profile matches the objects it describes\n"
+        "pgo:\n", 696);
+inline constexpr std::string_view t4_literal33 = std::string_view("\t$(if $(PGO_TRAIN),,$(error Set PGO_TRAIN to a command that exercises the library: make pgo PGO_TRAIN=./bench))\n", 112);
+inline constexpr std::string_view t4_literal34 = std::string_view("\trm -rf $(PGO_DIR)\n"
+        "\t$(MAKE) clean\n"
+        "\t$(MAKE) pgo-generate\n"
+        "\t$(PGO_TRAIN)\n"
+        "\t$(MAKE) clean\n"
+        "\t$(MAKE) pgo-use\n"
+        "\n"
+        "clean:\n"
+        "\trm -rf $(OBJDIR) $(TARGET)\n"
+        "\n"
+        "install: $(TARGET)\n", 158);
+inline constexpr std::string_view t4_literal35 = std::string_view("\tcp $(TARGET) /usr/local/lib/\n"
+        "\tcp include/", 42);
+inline constexpr std::string_view t4_literal36 = std::string_view(".h /usr/local/include/\n", 23);
+inline constexpr std::string_view t4_literal37 = std::string_view("\tcp $(TARGET) /usr/local/bin/\n", 30);
+
+inline std::string render4(const ProjectConfig& config) {
+    std::string out;
+    out.reserve(2792 + 7 * config.name.size());
+    const std::vector<std::string>* list0 = nullptr;
+    std::size_t item0 = 0;
+    out.append(t4_literal0);
+    out.append(config.name);
+    out.append(t4_literal1);
+    if (!kProjectConfigConditions[9].test(config)) goto l10;  // header_only
+    out.append(t4_literal2);
+    out.append(config.name);
+    out.append(t4_literal3);
+    out.append(config.name);
+    out.append(t4_literal4);
+    goto l68;
+l10:
+    out.append(t4_literal5);
+    if (!kProjectConfigConditions[13].test(config)) goto l17;  // library
+    out.append(t4_literal6);
+    if (!kProjectConfigConditions[7].test(config)) goto l15;  // static_library
+    out.append(t4_literal7);
+l15:
+    out.append(t4_literal8);
+    goto l18;
+l17:
+    out.append(t4_literal9);
+l18:
+    out.append(t4_literal10);
+    if (!kProjectConfigConditions[7].test(config)) goto l21;  // static_library
+    out.append(t4_literal11);
+l21:
+    out.append(t4_literal12);
+    if (!kProjectConfigConditions[8].test(config)) goto l24;  // shared_library
+    out.append(t4_literal13);
+l24:
+    out.append(t4_literal14);
+    if (!kProjectConfigConditions[7].test(config)) goto l30;  // static_library
+    out.append(t4_literal15);
+    out.append(config.name);
+    out.append(t4_literal16);
+    goto l36;
+l30:
+    if (!kProjectConfigConditions[8].test(config)) goto l35;  // shared_library
+    out.append(t4_literal17);
+    out.append(config.name);
+    out.append(t4_literal18);
+    goto l36;
+l35:
+    out.append(config.name);
+l36:
+    out.append(t4_literal19);
+    if (!kProjectConfigConditions[14].test(config)) goto l44;  // dependencies
+    out.append(t4_literal20);
+    list0 = &config.dependencies;
+    if (list0->empty()) goto l43;
+    item0 = 0;
+l40:
+    out.append(t4_literal21);
+    out.append((*list0)[item0]);
+    if (++item0 < list0->size()) goto l40;
+l43:
+    out.append(t4_literal22);
+l44:
+    out.append(t4_literal23);
+    if (kProjectConfigConditions[13].test(config)) goto l47;  // library
+    out.append(t4_literal24);
+l47:
+    out.append(t4_literal25);
+    if (!kProjectConfigConditions[7].test(config)) goto l51;  // static_library
+    out.append(t4_literal26);
+    goto l58;
+l51:
+    out.append(t4_literal27);
+    if (!kProjectConfigConditions[8].test(config)) goto l54;  // shared_library
+    out.append(t4_literal28);
+l54:
+    out.append(t4_literal29);
+    if (!kProjectConfigConditions[14].test(config)) goto l57;  // dependencies
+    out.append(t4_literal30);
+l57:
+    out.append(t4_literal31);
+l58:
+    out.append(t4_literal32);
+    if (!kProjectConfigConditions[13].test(config)) goto l61;  // library
+    out.append(t4_literal33);
+l61:
+    out.append(t4_literal34);
+    if (!kProjectConfigConditions[13].test(config)) goto l67;  // library
+    out.append(t4_literal35);
+    out.append(config.name);
+    out.append(t4_literal36);
+    goto l68;
+l67:
+    out.append(t4_literal37);
+l68:
+    return out;
+}
+
+inline void renderTo4(const ProjectConfig& config, TemplateSink& sink) {
+    const std::vector<std::string>* list0 = nullptr;
+    std::size_t item0 = 0;
+    sink.write(t4_literal0);
+    sink.write(config.name);
+    sink.write(t4_literal1);
+    if (!kProjectConfigConditions[9].test(config)) goto l10;  // header_only
+    sink.write(t4_literal2);
+    sink.write(config.name);
+    sink.write(t4_literal3);
+    sink.write(config.name);
+    sink.write(t4_literal4);
+    goto l68;
+l10:
+    sink.write(t4_literal5);
+    if (!kProjectConfigConditions[13].test(config)) goto l17;  // library
+    sink.write(t4_literal6);
+    if (!kProjectConfigConditions[7].test(config)) goto l15;  // static_library
+    sink.write(t4_literal7);
+l15:
+    sink.write(t4_literal8);
+    goto l18;
+l17:
+    sink.write(t4_literal9);
+l18:
+    sink.write(t4_literal10);
+    if (!kProjectConfigConditions[7].test(config)) goto l21;  // static_library
+    sink.write(t4_literal11);
+l21:
+    sink.write(t4_literal12);
+    if (!kProjectConfigConditions[8].test(config)) goto l24;  // shared_library
+    sink.write(t4_literal13);
+l24:
+    sink.write(t4_literal14);
+    if (!kProjectConfigConditions[7].test(config)) goto l30;  // static_library
+    sink.write(t4_literal15);
+    sink.write(config.name);
+    sink.write(t4_literal16);
+    goto l36;
+l30:
+    if (!kProjectConfigConditions[8].test(config)) goto l35;  // shared_library
+    sink.write(t4_literal17);
+    sink.write(config.name);
+    sink.write(t4_literal18);
+    goto l36;
+l35:
+    sink.write(config.name);
+l36:
+    sink.write(t4_literal19);
+    if (!kProjectConfigConditions[14].test(config)) goto l44;  // dependencies
+    sink.write(t4_literal20);
+    list0 = &config.dependencies;
+    if (list0->empty()) goto l43;
+    item0 = 0;
+l40:
+    sink.write(t4_literal21);
+    sink.write((*list0)[item0]);
+    if (++item0 < list0->size()) goto l40;
+l43:
+    sink.write(t4_literal22);
+l44:
+    sink.write(t4_literal23);
+    if (kProjectConfigConditions[13].test(config)) goto l47;  // library
+    sink.write(t4_literal24);
+l47:
+    sink.write(t4_literal25);
+    if (!kProjectConfigConditions[7].test(config)) goto l51;  // static_library
+    sink.write(t4_literal26);
+    goto l58;
+l51:
+    sink.write(t4_literal27);
+    if (!kProjectConfigConditions[8].test(config)) goto l54;  // shared_library
+    sink.write(t4_literal28);
+l54:
+    sink.write(t4_literal29);
+    if (!kProjectConfigConditions[14].test(config)) goto l57;  // dependencies
+    sink.write(t4_literal30);
+l57:
+    sink.write(t4_literal31);
+l58:
+    sink.write(t4_literal32);
+    if (!kProjectConfigConditions[13].test(config)) goto l61;  // library
+    sink.write(t4_literal33);
+l61:
+    sink.write(t4_literal34);
+    if (!kProjectConfigConditions[13].test(config)) goto l67;  // library
+    sink.write(t4_literal35);
+    sink.write(config.name);
+    sink.write(t4_literal36);
+    goto l68;
+l67:
+    sink.write(t4_literal37);
+l68:
+    return;
+}
+
+// generic/README.md
+inline constexpr std::string_view t5_literal0 = std::string_view("# ", 2);
+inline constexpr std::string_view t5_literal1 = std::string_view("\n"
+        "\n"
+        "## Description\n", 17);
+inline constexpr std::string_view t5_literal2 = std::string_view("\n"
+        "\n"
+        "## Goal\n", 10);
+inline constexpr std::string_view t5_literal3 = std::string_view("\n"
+        "\n"
+        "## Building\n"
+        "\n"
+        "### Using Makefile\n"
+        "```bash\n"
+        "make\n"
+        "```\n"
+        "\n"
+        "## Author\n", 62);
+inline constexpr std::string_view t5_literal4 = std::string_view("\n", 1);
+
+inline std::string render5(const ProjectConfig& config) {
+    std::string out;
+    out.reserve(92 + config.className.size() + config.description.size() + config.goal.size() + config.author.size());
+    out.append(t5_literal0);
+    out.append(config.className);
+    out.append(t5_literal1);
+    out.append(config.description);
+    out.append(t5_literal2);
+    out.append(config.goal);
+    out.append(t5_literal3);
+    out.append(config.author);
+    out.append(t5_literal4);
+    return out;
+}
+
+inline void renderTo5(const ProjectConfig& config, TemplateSink& sink) {
+    sink.write(t5_literal0);
+    sink.write(config.className);
+    sink.write(t5_literal1);
+    sink.write(config.description);
+    sink.write(t5_literal2);
+    sink.write(config.goal);
+    sink.write(t5_literal3);
+    sink.write(config.author);
+    sink.write(t5_literal4);
+}
+
+// generic/include/LikertScale.h
+inline constexpr std::string_view t6_literal0 = std::string_view("#ifndef LIKERT_SCALE_H\n"
+        "#define LIKERT_SCALE_H\n"
+        "\n"
+        "#include <string>\n"
+        "#include <vector>\n"
+        "\n"
+        "/**\n"
+        " * @class LikertScale\n"
+        " * @brief A simple class to display a Likert scale question and get a response.\n"
+        " */\n"
+        "class LikertScale {\n"
+        "public:\n"
+        "    /**\n"
+        "     * @brief Construct a new Likert Scale object\n"
+        "     * @param question The question to ask the user.\n"
+        "     * @param options The list of options for the scale (e.g., \"Strongly Disagree\" to \"Strongly Agree\").\n"
+        "     */\n"
+        "    LikertScale(const std::string& question, const std::vector<std::string>& options);\n"
+        "\n"
+        "    /**\n"
+        "     * @brief Displays the question and options, then waits for and validates user input.\n"
+        "     * @return The user's choice as an integer (1-based index).\n"
+        "     */\n"
+        "    int displayAndGetResponse();\n"
+        "\n"
+        "private:\n"
+        "    std::string question_;\n"
+        "    std::vector<std::string> options_;\n"
+        "};\n"
+        "\n"
+        "#endif // LIKERT_SCALE_H\n", 842);
+
+inline std::string render6(const ProjectConfig&) {
+    std::string out;
+    out.reserve(842);
+    out.append(t6_literal0);
+    return out;
+}
+
+inline void renderTo6(const ProjectConfig&, TemplateSink& sink) {
+    sink.write(t6_literal0);
+}
+
+// generic/partials/cmake_profiles
+inline constexpr std::string_view t7_literal0 = std::string_view("# Build profiles. Without a preset this is a Release build with link-time\n"
+        "# optimization; CMakePresets.json selects the others:\n"
+        "#   cmake --preset native        Release tuned for this machine (-march=native)\n"
+        "#   cmake --preset pgo-generate  Instrumented build: build it, run a typical workload,\n"
+        "#   cmake --preset pgo-use       then rebuild in the same directory with the profile\n"
+        "if(NOT CMAKE_BUILD_TYPE AND NOT CMAKE_CONFIGURATION_TYPES)\n"
+        "    set(CMAKE_BUILD_TYPE Release CACHE STRING \"Build type\" FORCE)\n"
+        "endif()\n"
+        "option(ENABLE_LTO \"Link-time optimization outside Debug builds\" ON)\n"
+        "option(ENABLE_NATIVE_ARCH \"Tune for the building machine (-march=native)\" OFF)\n"
+        "set(PGO_PHASE OFF CACHE STRING \"Profile-guided optimization: OFF, GENERATE or USE\")\n"
+        "set_property(CACHE PGO_PHASE PROPERTY STRINGS OFF GENERATE USE)\n"
+        "set(PGO_DIR \"${CMAKE_BINARY_DIR}/pgo-profiles\" CACHE PATH \"Where PGO profiles are written and read\")\n"
+        "\n"
+        "if(ENABLE_LTO AND NOT CMAKE_BUILD_TYPE STREQUAL \"Debug\")\n"
+        "    include(CheckIPOSupported)\n"
+        "    check_ipo_supported(RESULT lto_supported OUTPUT lto_error)\n"
+        "    if(lto_supported)\n"
+        "        set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)\n"
+        "    else()\n"
+        "        message(WARNING \"Link-time optimization is not available: ${lto_error}\")\n"
+        "    endif()\n"
+        "endif()\n"
+        "if(CMAKE_CXX_COMPILER_ID MATCHES \"GNU|Clang\")\n"
+        "    if(ENABLE_NATIVE_ARCH)\n"
+        "        add_compile_options(-march=native)\n"
+        "    endif()\n"
+        "    if(PGO_PHASE STREQUAL \"GENERATE\")\n"
+        "        add_compile_options(-fprofile-generate=${PGO_DIR})\n"
+        "        string(APPEND CMAKE_EXE_LINKER_FLAGS \" -fprofile-generate=${PGO_DIR}\")\n"
+        "        string(APPEND CMAKE_SHARED_LINKER_FLAGS \" -fprofile-generate=${PGO_DIR}\")\n"
+        "    elseif(PGO_PHASE STREQUAL \"USE\")\n"
+        "        # Clang needs the raw profiles merged first:\n"
+        "        #   llvm-profdata merge -o ${PGO_DIR}/default.profdata ${PGO_DIR}/*.profraw\n"
+        "        add_compile_options(-fprofile-use=${PGO_DIR})\n"
+        "        if(CMAKE_CXX_COMPILER_ID STREQUAL \"GNU\")\n"
+        "            add_compile_options(-fprofile-correction -Wno-missing-profile)\n"
+        "        endif()\n"
+        "    endif()\n"
+        "endif()\n"
+        "\n", 2021);
+
+inline std::string render7(const ProjectConfig&) {
+    std::string out;
+    out.reserve(2021);
+    out.append(t7_literal0);
+    return out;
+}
+
+inline void renderTo7(const ProjectConfig&, TemplateSink& sink) {
+    sink.write(t7_literal0);
+}
+
+// generic/partials/cmake_sources
+inline constexpr std::string_view t8_literal0 = std::string_view("    src/", 8);
+inline constexpr std::string_view t8_literal1 = std::string_view(".cpp\n", 5);
+inline constexpr std::string_view t8_literal2 = std::string_view("    src/LikertScale.cpp\n", 24);
+
+inline std::string render8(const ProjectConfig& config) {
+    std::string out;
+    out.reserve(37 + config.name.size());
+    out.append(t8_literal0);
+    out.append(config.name);
+    out.append(t8_literal1);
+    if (!kProjectConfigConditions[3].test(config)) goto l5;  // includeLikertScale
+    out.append(t8_literal2);
+l5:
+    return out;
+}
+
+inline void renderTo8(const ProjectConfig& config, TemplateSink& sink) {
+    sink.write(t8_literal0);
+    sink.write(config.name);
+    sink.write(t8_literal1);
+    if (!kProjectConfigConditions[3].test(config)) goto l5;  // includeLikertScale
+    sink.write(t8_literal2);
+l5:
+    return;
+}
+
+// Conditions are called by index; a reordered table needs a regenerated header.
+static_assert(kProjectConfigConditions[1].name == std::string_view("includeTests", 12), "regenerate this header");
+static_assert(kProjectConfigConditions[3].name == std::string_view("includeLikertScale", 18), "regenerate this header");
+static_assert(kProjectConfigConditions[7].name == std::string_view("static_library", 14), "regenerate this header");
+static_assert(kProjectConfigConditions[8].name == std::string_view("shared_library", 14), "regenerate this header");
+static_assert(kProjectConfigConditions[9].name == std::string_view("header_only", 11), "regenerate this header");
+static_assert(kProjectConfigConditions[11].name == std::string_view("unit_test", 9), "regenerate this header");
+static_assert(kProjectConfigConditions[12].name == std::string_view("executable", 10), "regenerate this header");
+static_assert(kProjectConfigConditions[13].name == std::string_view("library", 7), "regenerate this header");
+static_assert(kProjectConfigConditions[14].name == std::string_view("dependencies", 12), "regenerate this header");
+
+} // namespace PrecompiledTemplatesDetail
+
+inline constexpr PrecompiledTemplate kPrecompiledTemplatesData[] = {
+    {std::string_view("generic", 7), std::string_view(".gitignore", 10), &PrecompiledTemplatesDetail::render0, &PrecompiledTemplatesDetail::renderTo0},
+    {std::string_view("generic", 7), std::string_view("CMakeLists.txt", 14), &PrecompiledTemplatesDetail::render1, &PrecompiledTemplatesDetail::renderTo1},
+    {std::string_view("generic", 7), std::string_view("CMakePresets.json", 17), &PrecompiledTemplatesDetail::render2, &PrecompiledTemplatesDetail::renderTo2},
+    {std::string_view("generic", 7), std::string_view("LICENSE", 7), &PrecompiledTemplatesDetail::render3, &PrecompiledTemplatesDetail::renderTo3},
+    {std::string_view("generic", 7), std::string_view("Makefile", 8), &PrecompiledTemplatesDetail::render4, &PrecompiledTemplatesDetail::renderTo4},
+    {std::string_view("generic", 7), std::string_view("README.md", 9), &PrecompiledTemplatesDetail::render5, &PrecompiledTemplatesDetail::renderTo5},
+    {std::string_view("generic", 7), std::string_view("include/LikertScale.h", 21), &PrecompiledTemplatesDetail::render6, &PrecompiledTemplatesDetail::renderTo6},
+    {std::string_view("generic", 7), std::string_view("partials/cmake_profiles", 23), &PrecompiledTemplatesDetail::render7, &PrecompiledTemplatesDetail::renderTo7},
+    {std::string_view("generic", 7), std::string_view("partials/cmake_sources", 22), &PrecompiledTemplatesDetail::render8, &PrecompiledTemplatesDetail::renderTo8},
+};
+
+inline constexpr PrecompiledTemplateSet kPrecompiledTemplates(kPrecompiledTemplatesData, 9);
+
+#endif // PRECOMPILED_TEMPLATES_H
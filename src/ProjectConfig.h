@@ -0,0 +1,156 @@
+#ifndef PROJECT_CONFIG_H
+#define PROJECT_CONFIG_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+
+// Project template types
+enum class ProjectType {
+    CONSOLE_APP,
+    STATIC_LIBRARY,
+    SHARED_LIBRARY,
+    HEADER_ONLY,
+    GUI_APP,
+    UNIT_TEST
+};
+
+struct ProjectConfig {
+    std::string name;
+    std::string className;
+    std::string description;
+    std::string goal;
+    std::string author;
+    std::string version;
+    ProjectType type;
+    bool useCMake;
+    bool includeTests;
+    bool includeGitIgnore;
+    bool includeLikertScale;
+    bool includeDataDictionary;
+    bool includePrivacyPolicy;
+    std::vector<std::string> dependencies;
+};
+
+/**
+ * @brief A ProjectConfig string field that templates reference as `{{placeholder}}`.
+ */
+struct ProjectConfigField {
+    std::string_view placeholder;       ///< Name between the braces
+    std::string_view member;            ///< The ProjectConfig member, as spelled in generated code
+    std::string ProjectConfig::*field;
+};
+
+/**
+ * @brief The placeholders a template can use and the fields that fill them.
+ * template_precompiler resolves placeholders through this table at build
+ * time; projectSubstitutions() builds the equivalent runtime map.
+ */
+inline const ProjectConfigField kProjectConfigFields[] = {
+    {"project_name", "className", &ProjectConfig::className},
+    {"name", "name", &ProjectConfig::name},
+    {"description", "description", &ProjectConfig::description},
+    {"goal", "goal", &ProjectConfig::goal},
+    {"author", "author", &ProjectConfig::author},
+    {"version", "version", &ProjectConfig::version},
+};
+
+/**
+ * @brief Returns the field a placeholder name refers to, or nullptr.
+ */
+inline const ProjectConfigField* findProjectConfigField(std::string_view placeholder) {
+    for (const ProjectConfigField& field : kProjectConfigFields) {
+        if (field.placeholder == placeholder) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief A test on a ProjectConfig that templates branch on with `{{#if name}}`.
+ */
+struct ProjectConfigCondition {
+    std::string_view name;
+    bool (*test)(const ProjectConfig& config);
+};
+
+/**
+ * @brief The conditions a template can test: the boolean options, one per
+ * project type, and a few derived ones. TemplateProgram compiles a condition
+ * to its index in this table, and precompiled templates call the test at
+ * that index, so it is constexpr for them to check the index at build time.
+ */
+inline constexpr ProjectConfigCondition kProjectConfigConditions[] = {
+    {"useCMake", [](const ProjectConfig& config) { return config.useCMake; }},
+    {"includeTests", [](const ProjectConfig& config) { return config.includeTests; }},
+    {"includeGitIgnore", [](const ProjectConfig& config) { return config.includeGitIgnore; }},
+    {"includeLikertScale", [](const ProjectConfig& config) { return config.includeLikertScale; }},
+    {"includeDataDictionary", [](const ProjectConfig& config) { return config.includeDataDictionary; }},
+    {"includePrivacyPolicy", [](const ProjectConfig& config) { return config.includePrivacyPolicy; }},
+    {"console_app", [](const ProjectConfig& config) { return config.type == ProjectType::CONSOLE_APP; }},
+    {"static_library", [](const ProjectConfig& config) { return config.type == ProjectType::STATIC_LIBRARY; }},
+    {"shared_library", [](const ProjectConfig& config) { return config.type == ProjectType::SHARED_LIBRARY; }},
+    {"header_only", [](const ProjectConfig& config) { return config.type == ProjectType::HEADER_ONLY; }},
+    {"gui_app", [](const ProjectConfig& config) { return config.type == ProjectType::GUI_APP; }},
+    {"unit_test", [](const ProjectConfig& config) { return config.type == ProjectType::UNIT_TEST; }},
+    {"executable", [](const ProjectConfig& config) {
+        return config.type == ProjectType::CONSOLE_APP || config.type == ProjectType::GUI_APP;
+    }},
+    {"library", [](const ProjectConfig& config) {
+        return config.type == ProjectType::STATIC_LIBRARY || config.type == ProjectType::SHARED_LIBRARY ||
+               config.type == ProjectType::HEADER_ONLY;
+    }},
+    {"dependencies", [](const ProjectConfig& config) { return !config.dependencies.empty(); }},
+};
+
+/**
+ * @brief Returns the condition with the given name, or nullptr.
+ */
+inline const ProjectConfigCondition* findProjectConfigCondition(std::string_view name) {
+    for (const ProjectConfigCondition& condition : kProjectConfigConditions) {
+        if (condition.name == name) {
+            return &condition;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief A ProjectConfig list that templates iterate with `{{#each name}}`.
+ */
+struct ProjectConfigList {
+    std::string_view name;
+    std::string_view member;            ///< The ProjectConfig member, as spelled in generated code
+    std::vector<std::string> ProjectConfig::*list;
+};
+
+inline const ProjectConfigList kProjectConfigLists[] = {
+    {"dependencies", "dependencies", &ProjectConfig::dependencies},
+};
+
+/**
+ * @brief Returns the list with the given name, or nullptr.
+ */
+inline const ProjectConfigList* findProjectConfigList(std::string_view name) {
+    for (const ProjectConfigList& list : kProjectConfigLists) {
+        if (list.name == name) {
+            return &list;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Maps every `{{placeholder}}` in kProjectConfigFields to its value in `config`.
+ */
+inline std::map<std::string, std::string> projectSubstitutions(const ProjectConfig& config) {
+    std::map<std::string, std::string> substitutions;
+    for (const ProjectConfigField& field : kProjectConfigFields) {
+        substitutions["{{" + std::string(field.placeholder) + "}}"] = config.*field.field;
+    }
+    return substitutions;
+}
+
+#endif // PROJECT_CONFIG_H
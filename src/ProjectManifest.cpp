@@ -0,0 +1,577 @@
+#include "ProjectManifest.h"
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// A field as read from the manifest, before it is checked against its member.
+struct FieldValue {
+    enum class Kind { Text, Flag, List };
+    Kind kind = Kind::Text;
+    std::string text;
+    bool flag = false;
+    std::vector<std::string> items;
+};
+
+struct FlagField {
+    std::string_view name;
+    bool ProjectConfig::*member;
+};
+
+const FlagField kFlagFields[] = {
+    {"useCMake", &ProjectConfig::useCMake},
+    {"includeTests", &ProjectConfig::includeTests},
+    {"includeGitIgnore", &ProjectConfig::includeGitIgnore},
+    {"includeLikertScale", &ProjectConfig::includeLikertScale},
+    {"includeDataDictionary", &ProjectConfig::includeDataDictionary},
+    {"includePrivacyPolicy", &ProjectConfig::includePrivacyPolicy},
+};
+
+// In the order of the interactive menu, so the menu number is the index + 1.
+const std::pair<std::string_view, ProjectType> kProjectTypes[] = {
+    {"console_app", ProjectType::CONSOLE_APP},
+    {"static_library", ProjectType::STATIC_LIBRARY},
+    {"shared_library", ProjectType::SHARED_LIBRARY},
+    {"header_only", ProjectType::HEADER_ONLY},
+    {"gui_app", ProjectType::GUI_APP},
+    {"unit_test", ProjectType::UNIT_TEST},
+};
+
+const ProjectConfigField* findProjectConfigFieldByMember(std::string_view member) {
+    for (const ProjectConfigField& field : kProjectConfigFields) {
+        if (field.member == member) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+std::string_view trim(std::string_view text) {
+    std::size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string_view::npos) {
+        return std::string_view();
+    }
+    std::size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end + 1 - begin);
+}
+
+std::string lower(std::string_view text) {
+    std::string result(text);
+    for (char& c : result) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return result;
+}
+
+bool parseFlag(const FieldValue& value, bool& flag) {
+    if (value.kind == FieldValue::Kind::Flag) {
+        flag = value.flag;
+        return true;
+    }
+    if (value.kind != FieldValue::Kind::Text) {
+        return false;
+    }
+    const std::string text = lower(trim(value.text));
+    if (text == "true" || text == "yes" || text == "y" || text == "1") {
+        flag = true;
+    } else if (text == "false" || text == "no" || text == "n" || text == "0") {
+        flag = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> splitList(std::string_view text) {
+    std::vector<std::string> items;
+    while (!text.empty()) {
+        std::size_t separator = text.find(';');
+        std::string_view item = trim(text.substr(0, separator));
+        if (!item.empty()) {
+            items.emplace_back(item);
+        }
+        text = separator == std::string_view::npos ? std::string_view() : text.substr(separator + 1);
+    }
+    return items;
+}
+
+bool isField(std::string_view key) {
+    if (key == "dependencies" || key == "type") {
+        return true;
+    }
+    for (const FlagField& field : kFlagFields) {
+        if (key == field.name) {
+            return true;
+        }
+    }
+    return findProjectConfigFieldByMember(key) != nullptr;
+}
+
+// Sets one field of `project`; records the first problem in project.error.
+void assignField(ManifestProject& project, std::string_view key, const FieldValue& value, bool& class_name_set) {
+    if (!project.error.empty()) {
+        return;
+    }
+    ProjectConfig& config = project.config;
+    if (key == "dependencies") {
+        if (value.kind == FieldValue::Kind::List) {
+            config.dependencies = value.items;
+        } else if (value.kind == FieldValue::Kind::Text) {
+            config.dependencies = splitList(value.text);
+        } else {
+            project.error = "'dependencies' must be a list";
+        }
+        return;
+    }
+    if (key == "type") {
+        const std::string type = lower(trim(value.text));
+        for (std::size_t i = 0; i < std::size(kProjectTypes) && value.kind == FieldValue::Kind::Text; ++i) {
+            if (type == kProjectTypes[i].first || type == std::to_string(i + 1)) {
+                config.type = kProjectTypes[i].second;
+                return;
+            }
+        }
+        project.error = "unknown project type '" + value.text + "'";
+        return;
+    }
+    for (const FlagField& field : kFlagFields) {
+        if (key == field.name) {
+            if (!parseFlag(value, config.*field.member)) {
+                project.error = "'" + std::string(key) + "' must be true or false, not '" + value.text + "'";
+            }
+            return;
+        }
+    }
+    if (const ProjectConfigField* field = findProjectConfigFieldByMember(key)) {
+        if (value.kind != FieldValue::Kind::Text) {
+            project.error = "'" + std::string(key) + "' must be a string";
+        } else if (!value.text.empty()) {
+            config.*field->field = value.text;
+            class_name_set = class_name_set || key == "className";
+        }
+        return;
+    }
+    project.error = "unknown field '" + std::string(key) + "'";
+}
+
+void finishProject(ManifestProject& project, bool class_name_set) {
+    ProjectConfig& config = project.config;
+    if (!project.error.empty()) {
+        return;
+    }
+    if (config.name.empty()) {
+        project.error = "missing 'name'";
+    } else if (config.name == "." || config.name == ".." || config.name.find_first_of("/\\") != std::string::npos) {
+        project.error = "'name' must be a single path component, not '" + config.name + "'";
+    } else if (!class_name_set) {
+        config.className = config.name;
+        config.className[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(config.className[0])));
+    }
+}
+
+struct CsvRecord {
+    std::size_t line;
+    std::vector<std::string> fields;
+};
+
+// Splits CSV text into records. Quoted fields may contain commas, newlines
+// and doubled quotes and are kept exactly; unquoted fields are trimmed.
+std::vector<CsvRecord> splitCsv(std::string_view text) {
+    std::vector<CsvRecord> records;
+    CsvRecord record{1, {}};
+    std::string field;
+    bool quoted = false;      // The current field started with a quote
+    bool in_quotes = false;
+    bool blank = true;        // Nothing but whitespace on the record so far
+    std::size_t line = 1;
+    auto endField = [&]() {
+        record.fields.push_back(quoted ? field : std::string(trim(field)));
+        field.clear();
+        quoted = false;
+    };
+    auto endRecord = [&]() {
+        endField();
+        if (!blank) {
+            records.push_back(std::move(record));
+        }
+        record = CsvRecord{line, {}};
+        blank = true;
+    };
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        const char c = text[i];
+        if (c == '\n') {
+            ++line;
+        }
+        if (in_quotes) {
+            if (c == '"' && i + 1 < text.size() && text[i + 1] == '"') {
+                field += '"';
+                ++i;
+            } else if (c == '"') {
+                in_quotes = false;
+            } else {
+                field += c;
+            }
+            continue;
+        }
+        if (c == '"' && trim(field).empty()) {
+            field.clear();
+            quoted = in_quotes = true;
+            blank = false;
+        } else if (c == ',') {
+            endField();
+            blank = false;
+        } else if (c == '\n') {
+            endRecord();
+        } else if (c != '\r') {
+            field += c;
+            blank = blank && std::isspace(static_cast<unsigned char>(c));
+        }
+    }
+    if (in_quotes) {
+        throw std::runtime_error("Manifest ends inside a quoted field that starts on line " +
+                                 std::to_string(record.line));
+    }
+    endRecord();
+    return records;
+}
+
+std::vector<ManifestProject> parseCsv(std::string_view text) {
+    std::vector<CsvRecord> records = splitCsv(text);
+    if (records.empty()) {
+        throw std::runtime_error("CSV manifest has no header row");
+    }
+    const std::vector<std::string>& columns = records.front().fields;
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        if (!isField(columns[i])) {
+            throw std::runtime_error("CSV manifest: unknown column '" + columns[i] + "'");
+        }
+        for (std::size_t j = 0; j < i; ++j) {
+            if (columns[j] == columns[i]) {
+                throw std::runtime_error("CSV manifest: column '" + columns[i] + "' appears twice");
+            }
+        }
+    }
+
+    std::vector<ManifestProject> projects;
+    for (std::size_t r = 1; r < records.size(); ++r) {
+        ManifestProject project;
+        project.line = records[r].line;
+        project.config = defaultProjectConfig();
+        bool class_name_set = false;
+        const std::vector<std::string>& fields = records[r].fields;
+        if (fields.size() > columns.size()) {
+            project.error = "has " + std::to_string(fields.size()) + " fields but the header has " +
+                            std::to_string(columns.size());
+        }
+        for (std::size_t i = 0; i < fields.size() && i < columns.size(); ++i) {
+            // An empty cell keeps the default, like an empty answer to a prompt.
+            if (!fields[i].empty()) {
+                FieldValue value;
+                value.text = fields[i];
+                assignField(project, columns[i], value, class_name_set);
+            }
+        }
+        finishProject(project, class_name_set);
+        projects.push_back(std::move(project));
+    }
+    return projects;
+}
+
+// Parses one flat JSON object: string, boolean, number, null and
+// array-of-string values.
+class JsonLineParser {
+public:
+    explicit JsonLineParser(std::string_view text) : text_(text) {}
+
+    std::vector<std::pair<std::string, FieldValue>> parseObject() {
+        std::vector<std::pair<std::string, FieldValue>> members;
+        expect('{');
+        if (peek() == '}') {
+            ++pos_;
+        } else {
+            while (true) {
+                std::string key = parseString();
+                expect(':');
+                skipSpace();
+                if (text_.compare(pos_, 4, "null") == 0) {
+                    pos_ += 4;
+                } else {
+                    members.emplace_back(std::move(key), parseValue());
+                }
+                if (peek() == ',') {
+                    ++pos_;
+                    continue;
+                }
+                expect('}');
+                break;
+            }
+        }
+        if (peek() != '\0') {
+            fail("unexpected text after the object");
+        }
+        return members;
+    }
+
+private:
+    std::string_view text_;
+    std::size_t pos_ = 0;
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::invalid_argument("invalid JSON at column " + std::to_string(pos_ + 1) + ": " + message);
+    }
+
+    void skipSpace() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            ++pos_;
+        }
+    }
+
+    char peek() {
+        skipSpace();
+        return pos_ < text_.size() ? text_[pos_] : '\0';
+    }
+
+    void expect(char c) {
+        if (peek() != c) {
+            fail(std::string("expected '") + c + "'");
+        }
+        ++pos_;
+    }
+
+    FieldValue parseValue() {
+        FieldValue value;
+        const char c = peek();
+        if (c == '"') {
+            value.text = parseString();
+        } else if (c == '[') {
+            value.kind = FieldValue::Kind::List;
+            ++pos_;
+            if (peek() == ']') {
+                ++pos_;
+                return value;
+            }
+            while (true) {
+                if (peek() != '"') {
+                    fail("list elements must be strings");
+                }
+                value.items.push_back(parseString());
+                if (peek() == ',') {
+                    ++pos_;
+                    continue;
+                }
+                expect(']');
+                break;
+            }
+        } else if (text_.compare(pos_, 4, "true") == 0 || text_.compare(pos_, 5, "false") == 0) {
+            value.kind = FieldValue::Kind::Flag;
+            value.flag = text_[pos_] == 't';
+            value.text = value.flag ? "true" : "false";
+            pos_ += value.flag ? 4 : 5;
+        } else if (c == '-' || std::isdigit(static_cast<unsigned char>(c))) {
+            const std::size_t begin = pos_;
+            while (pos_ < text_.size() && std::string_view("+-.eE0123456789").find(text_[pos_]) != std::string_view::npos) {
+                ++pos_;
+            }
+            value.text = std::string(text_.substr(begin, pos_ - begin));
+        } else if (c == '{') {
+            fail("nested objects are not supported");
+        } else {
+            fail("expected a value");
+        }
+        return value;
+    }
+
+    std::string parseString() {
+        expect('"');
+        std::string out;
+        while (true) {
+            if (pos_ >= text_.size()) {
+                fail("unterminated string");
+            }
+            const char c = text_[pos_++];
+            if (c == '"') {
+                return out;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos_ >= text_.size()) {
+                fail("unterminated string");
+            }
+            const char escape = text_[pos_++];
+            switch (escape) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': appendUtf8(out, parseCodePoint()); break;
+                default: fail(std::string("unknown escape '\\") + escape + "'");
+            }
+        }
+    }
+
+    unsigned parseHex4() {
+        if (pos_ + 4 > text_.size()) {
+            fail("truncated \\u escape");
+        }
+        unsigned value = 0;
+        for (int i = 0; i < 4; ++i) {
+            const char c = text_[pos_++];
+            value <<= 4;
+            if (c >= '0' && c <= '9') {
+                value |= static_cast<unsigned>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                value |= static_cast<unsigned>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                value |= static_cast<unsigned>(c - 'A' + 10);
+            } else {
+                fail("bad \\u escape");
+            }
+        }
+        return value;
+    }
+
+    unsigned parseCodePoint() {
+        unsigned code = parseHex4();
+        if (code >= 0xD800 && code <= 0xDBFF) {
+            if (text_.compare(pos_, 2, "\\u") != 0) {
+                fail("unpaired surrogate");
+            }
+            pos_ += 2;
+            const unsigned low = parseHex4();
+            if (low < 0xDC00 || low > 0xDFFF) {
+                fail("unpaired surrogate");
+            }
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        } else if (code >= 0xDC00 && code <= 0xDFFF) {
+            fail("unpaired surrogate");
+        }
+        return code;
+    }
+
+    static void appendUtf8(std::string& out, unsigned code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+};
+
+std::vector<ManifestProject> parseJsonLines(std::string_view text) {
+    std::vector<ManifestProject> projects;
+    std::size_t line = 0;
+    while (!text.empty()) {
+        ++line;
+        const std::size_t newline = text.find('\n');
+        const std::string_view record = trim(text.substr(0, newline));
+        text = newline == std::string_view::npos ? std::string_view() : text.substr(newline + 1);
+        if (record.empty() || record[0] == '#') {
+            continue;
+        }
+
+        ManifestProject project;
+        project.line = line;
+        project.config = defaultProjectConfig();
+        bool class_name_set = false;
+        try {
+            std::vector<std::pair<std::string, FieldValue>> members = JsonLineParser(record).parseObject();
+            for (std::size_t i = 0; i < members.size() && project.error.empty(); ++i) {
+                for (std::size_t j = 0; j < i; ++j) {
+                    if (members[j].first == members[i].first) {
+                        project.error = "'" + members[i].first + "' is given twice";
+                    }
+                }
+                assignField(project, members[i].first, members[i].second, class_name_set);
+            }
+        } catch (const std::invalid_argument& e) {
+            project.error = e.what();
+        }
+        finishProject(project, class_name_set);
+        projects.push_back(std::move(project));
+    }
+    return projects;
+}
+
+} // namespace
+
+ProjectConfig defaultProjectConfig() {
+    ProjectConfig config;
+    config.author = "Unknown Author";
+    config.version = "1.0.0";
+    config.type = ProjectType::CONSOLE_APP;
+    config.useCMake = false;
+    config.includeTests = false;
+    config.includeGitIgnore = true;
+    config.includeLikertScale = false;
+    config.includeDataDictionary = false;
+    config.includePrivacyPolicy = false;
+    return config;
+}
+
+std::vector<ManifestProject> parseProjectManifest(std::string_view text, ManifestFormat format) {
+    std::vector<ManifestProject> projects = format == ManifestFormat::Csv ? parseCsv(text) : parseJsonLines(text);
+
+    // Two projects with one name would be generated into the same directory,
+    // concurrently. Names that differ only in case are the same directory on
+    // case-insensitive filesystems, so they are rejected everywhere.
+    std::map<std::string, const ManifestProject*> first_use;
+    for (ManifestProject& project : projects) {
+        if (!project.error.empty()) {
+            continue;
+        }
+        auto inserted = first_use.emplace(lower(project.config.name), &project);
+        if (!inserted.second) {
+            const ManifestProject& first = *inserted.first->second;
+            project.error = "project name '" + project.config.name + "' is already used on line " +
+                            std::to_string(first.line) +
+                            (first.config.name == project.config.name ? "" : " as '" + first.config.name + "'");
+        }
+    }
+    return projects;
+}
+
+ManifestFormat manifestFormatFor(const std::string& path, std::string_view text) {
+    const std::string extension = lower(std::filesystem::path(path).extension().string());
+    if (extension == ".csv") {
+        return ManifestFormat::Csv;
+    }
+    if (extension == ".jsonl" || extension == ".ndjson" || extension == ".json") {
+        return ManifestFormat::JsonLines;
+    }
+    const std::string_view content = trim(text);
+    return !content.empty() && content[0] == '{' ? ManifestFormat::JsonLines : ManifestFormat::Csv;
+}
+
+std::vector<ManifestProject> readProjectManifest(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open manifest: " + path);
+    }
+    const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    try {
+        return parseProjectManifest(text, manifestFormatFor(path, text));
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(path + ": " + e.what());
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef PROJECT_MANIFEST_H
+#define PROJECT_MANIFEST_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ProjectConfig.h"
+
+/**
+ * @brief One project read from a manifest.
+ */
+struct ManifestProject {
+    std::size_t line = 0;  ///< Line the record starts on, counting from 1
+    ProjectConfig config;
+    std::string error;     ///< Why the record cannot be generated; empty if it can
+};
+
+enum class ManifestFormat {
+    Csv,        ///< A header row of field names, then one project per row
+    JsonLines,  ///< One flat JSON object per line
+};
+
+/**
+ * @brief The configuration the interactive prompts produce when every answer is left empty.
+ */
+ProjectConfig defaultProjectConfig();
+
+/**
+ * @brief Parses a manifest of projects for batch generation.
+ *
+ * Fields are named after the ProjectConfig members: name, className,
+ * description, goal, author, version, type, useCMake, includeTests,
+ * includeGitIgnore, includeLikertScale, includeDataDictionary,
+ * includePrivacyPolicy and dependencies. Only `name` is required; the rest
+ * default as in interactive mode, and className defaults to the name with
+ * its first letter capitalised. `type` is a project type condition name
+ * (console_app, static_library, ...) or the menu number 1-6. Booleans are
+ * true/false, yes/no, y/n or 1/0. In CSV, dependencies are separated by
+ * ';'; in JSON Lines they may also be an array of strings. Blank lines and,
+ * in JSON Lines, lines starting with '#' are skipped.
+ *
+ * A record with a bad value, an unknown field, a name that is not a single
+ * path component or a name used by an earlier record (ignoring case, as
+ * some filesystems do) is returned with its error set, so that one bad row
+ * does not stop the others and no two projects share a directory.
+ * @throws std::runtime_error if a CSV manifest has no header row, repeats or
+ *         does not know a column, or ends inside a quoted field.
+ */
+std::vector<ManifestProject> parseProjectManifest(std::string_view text, ManifestFormat format);
+
+/**
+ * @brief Chooses a format from the extension (.csv, .jsonl, .ndjson, .json),
+ * or else from whether the first non-blank character is '{'.
+ */
+ManifestFormat manifestFormatFor(const std::string& path, std::string_view text);
+
+/**
+ * @brief Reads and parses a manifest file; see parseProjectManifest.
+ * @throws std::runtime_error if the file cannot be read or is malformed.
+ */
+std::vector<ManifestProject> readProjectManifest(const std::string& path);
+
+#endif // PROJECT_MANIFEST_H
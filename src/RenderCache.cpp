@@ -0,0 +1,73 @@
+#include "RenderCache.h"
+#include "ContentPool.h"
+#include <algorithm>
+
+std::uint64_t fingerprintValues(const std::vector<std::string_view>& values) {
+    std::uint64_t fingerprint = values.size();
+    for (std::string_view value : values) {
+        fingerprint = (fingerprint ^ hashContent(value)) * 0x9E3779B97F4A7C15ULL;
+        fingerprint ^= fingerprint >> 32;
+    }
+    return fingerprint;
+}
+
+std::shared_ptr<const std::string> RenderCache::find(const Key& key, const std::vector<std::string_view>& values) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(key);
+    if (found == index_.end() ||
+        !std::equal(found->second->values.begin(), found->second->values.end(), values.begin(), values.end())) {
+        ++stats_.misses;
+        return nullptr;
+    }
+    ++stats_.hits;
+    lru_.splice(lru_.begin(), lru_, found->second);
+    return found->second->output;
+}
+
+std::shared_ptr<const std::string> RenderCache::insert(const Key& key, const std::vector<std::string_view>& values,
+                                                       std::string output) {
+    std::size_t charge = output.size() + kEntryOverhead;
+    for (std::string_view value : values) {
+        charge += value.size();
+    }
+    auto shared = std::make_shared<const std::string>(std::move(output));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto existing = index_.find(key);
+    if (existing != index_.end()) {
+        eraseLocked(existing->second);
+    }
+    if (charge > budget_) {
+        ++stats_.rejected;
+        return shared;
+    }
+    while (stats_.bytes + charge > budget_) {
+        eraseLocked(std::prev(lru_.end()));
+        ++stats_.evictions;
+    }
+    lru_.push_front({key, std::vector<std::string>(values.begin(), values.end()), shared, charge});
+    index_.emplace(key, lru_.begin());
+    stats_.bytes += charge;
+    return shared;
+}
+
+void RenderCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    stats_.bytes = 0;
+}
+
+RenderCache::Stats RenderCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.entries = lru_.size();
+    stats.budget = budget_;
+    return stats;
+}
+
+void RenderCache::eraseLocked(std::list<Entry>::iterator entry) {
+    stats_.bytes -= entry->charge;
+    index_.erase(entry->key);
+    lru_.erase(entry);
+}
@@ -0,0 +1,117 @@
+#ifndef RENDER_CACHE_H
+#define RENDER_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 64-bit fingerprint of a sequence of placeholder values.
+ * The order of the values matters; the same values in the same order
+ * always give the same fingerprint within a process.
+ */
+std::uint64_t fingerprintValues(const std::vector<std::string_view>& values);
+
+/**
+ * @brief Bounded LRU cache of rendered template output.
+ *
+ * An entry is keyed by the template it was rendered from and the fingerprint
+ * of the values of the placeholders that template uses, so substitutions the
+ * template ignores do not split the cache. The values are stored with the
+ * output and compared on lookup, so a fingerprint collision is a miss, never
+ * wrong output. Every entry is charged its output, its values and a fixed
+ * overhead against the byte budget; the least recently used entries are
+ * evicted to stay within it. All methods are thread-safe.
+ */
+class RenderCache {
+public:
+    struct Key {
+        std::uint64_t generation;   ///< Load the template came from; see TemplateLoader::reload()
+        const void* source;         ///< Identifies the template within that load
+        std::uint64_t fingerprint;  ///< fingerprintValues() of the values below
+
+        bool operator==(const Key& other) const {
+            return generation == other.generation && source == other.source && fingerprint == other.fingerprint;
+        }
+    };
+
+    struct Stats {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+        std::uint64_t rejected = 0;  ///< Outputs larger than the whole budget, never stored
+        std::size_t entries = 0;
+        std::size_t bytes = 0;       ///< Charged against the budget
+        std::size_t budget = 0;
+
+        /**
+         * @brief hits / (hits + misses); 0 before the first lookup.
+         */
+        double hitRate() const {
+            const std::uint64_t lookups = hits + misses;
+            return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+        }
+    };
+
+    /**
+     * @brief Bytes charged per entry on top of its output and values, for the
+     * list node, the index slot and the string headers.
+     */
+    static constexpr std::size_t kEntryOverhead = 128;
+
+    explicit RenderCache(std::size_t byte_budget) : budget_(byte_budget) {}
+
+    /**
+     * @brief Returns the cached output for `key`, or nullptr. A hit makes the
+     * entry the most recently used. The output stays valid for as long as the
+     * caller holds it, even if the entry is evicted meanwhile.
+     * @param values The values `key.fingerprint` was computed from.
+     */
+    std::shared_ptr<const std::string> find(const Key& key, const std::vector<std::string_view>& values);
+
+    /**
+     * @brief Stores an output, evicting least recently used entries as needed.
+     * An existing entry for the same key is replaced.
+     * @return The stored output, which is returned even if it was too large to keep.
+     */
+    std::shared_ptr<const std::string> insert(const Key& key, const std::vector<std::string_view>& values,
+                                              std::string output);
+
+    /**
+     * @brief Drops every entry. The counters are kept.
+     */
+    void clear();
+
+    Stats stats() const;
+
+private:
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const {
+            return static_cast<std::size_t>(key.fingerprint ^ (key.generation * 0x9E3779B97F4A7C15ULL) ^
+                                            reinterpret_cast<std::uintptr_t>(key.source));
+        }
+    };
+
+    struct Entry {
+        Key key;
+        std::vector<std::string> values;
+        std::shared_ptr<const std::string> output;
+        std::size_t charge;
+    };
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_;  // Most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+    std::size_t budget_;
+    Stats stats_;
+
+    void eraseLocked(std::list<Entry>::iterator entry);
+};
+
+#endif // RENDER_CACHE_H
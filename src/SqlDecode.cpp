@@ -0,0 +1,179 @@
+#include "SqlDecode.h"
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define QM_SQL_DECODE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace SqlDecode {
+
+namespace {
+
+std::size_t findSpecialScalar(const char* data, std::size_t size) {
+    for (std::size_t i = 0; i < size; ++i) {
+        if (data[i] == '\'' || data[i] == '\\') {
+            return i;
+        }
+    }
+    return size;
+}
+
+#ifdef QM_SQL_DECODE_X86
+__attribute__((target("sse2")))
+std::size_t findSpecialSSE2(const char* data, std::size_t size) {
+    const __m128i quote = _mm_set1_epi8('\'');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+    }
+    return i + findSpecialScalar(data + i, size - i);
+}
+
+__attribute__((target("avx2")))
+std::size_t findSpecialAVX2(const char* data, std::size_t size) {
+    const __m256i quote = _mm256_set1_epi8('\'');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+    }
+    return i + findSpecialSSE2(data + i, size - i);
+}
+#endif
+
+Kernel detectKernel() {
+#ifdef QM_SQL_DECODE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Kernel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return Kernel::SSE2;
+    }
+#endif
+    return Kernel::Scalar;
+}
+
+char unescapeChar(char c) {
+    switch (c) {
+        case 'n': return '\n';
+        case 't': return '\t';
+        case 'r': return '\r';
+        case '0': return '\0';
+        default: return c; // \\, \', \" and anything else map to the character itself
+    }
+}
+
+bool isKnownEscape(char c) {
+    return c == 'n' || c == 't' || c == 'r' || c == '0' || c == '\\' || c == '\'' || c == '"';
+}
+
+} // namespace
+
+Kernel activeKernel() {
+    static const Kernel kernel = detectKernel();
+    return kernel;
+}
+
+bool isSupported(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Scalar: return true;
+        case Kernel::SSE2: return activeKernel() != Kernel::Scalar;
+        case Kernel::AVX2: return activeKernel() == Kernel::AVX2;
+    }
+    return false;
+}
+
+const char* kernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Scalar: return "scalar";
+        case Kernel::SSE2: return "sse2";
+        case Kernel::AVX2: return "avx2";
+    }
+    return "unknown";
+}
+
+std::size_t findSpecial(std::string_view text, Kernel kernel) {
+#ifdef QM_SQL_DECODE_X86
+    if (kernel == Kernel::AVX2) {
+        return findSpecialAVX2(text.data(), text.size());
+    }
+    if (kernel == Kernel::SSE2) {
+        return findSpecialSSE2(text.data(), text.size());
+    }
+#else
+    (void)kernel;
+#endif
+    return findSpecialScalar(text.data(), text.size());
+}
+
+std::size_t decodeLiteral(std::string_view text, std::string& out, Kernel kernel) {
+    std::size_t i = 0;
+    while (true) {
+        std::size_t special = i + findSpecial(text.substr(i), kernel);
+        if (special >= text.size()) {
+            return std::string_view::npos;
+        }
+        out.append(text.data() + i, special - i);
+
+        if (text[special] == '\\') {
+            if (special + 1 >= text.size()) {
+                return std::string_view::npos;
+            }
+            char next = text[special + 1];
+            if (!isKnownEscape(next)) {
+                out += '\\';
+            }
+            out += unescapeChar(next);
+            i = special + 2;
+        } else if (special + 1 < text.size() && text[special + 1] == '\'') {
+            out += '\'';
+            i = special + 2;
+        } else {
+            return special;
+        }
+    }
+}
+
+std::string decode(std::string_view raw, Kernel kernel) {
+    std::string out;
+    out.reserve(raw.size());
+    std::size_t i = 0;
+    while (i < raw.size()) {
+        std::size_t special = i + findSpecial(raw.substr(i), kernel);
+        out.append(raw.data() + i, special - i);
+        if (special >= raw.size()) {
+            break;
+        }
+
+        if (raw[special] == '\\' && special + 1 < raw.size()) {
+            char next = raw[special + 1];
+            if (!isKnownEscape(next)) {
+                out += '\\';
+            }
+            out += unescapeChar(next);
+            i = special + 2;
+        } else if (raw[special] == '\'' && special + 1 < raw.size() && raw[special + 1] == '\'') {
+            out += '\'';
+            i = special + 2;
+        } else {
+            out += raw[special];
+            i = special + 1;
+        }
+    }
+    return out;
+}
+
+} // namespace SqlDecode
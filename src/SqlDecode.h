@@ -0,0 +1,63 @@
+#ifndef SQL_DECODE_H
+#define SQL_DECODE_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+/**
+ * @brief Decoding of SQL string literal bodies.
+ *
+ * Template bodies use two escape conventions: SQL's doubled quote (`''`)
+ * and backslash sequences (`\n`, `\t`, `\r`, `\0`, `\\`, `\'`, `\"`).
+ * A backslash before any other character is kept as written.
+ *
+ * The hot loop searches for the next quote or backslash. It has SSE2 and
+ * AVX2 implementations on x86 and a portable scalar one; the fastest
+ * kernel the CPU supports is chosen once at startup. Every entry point
+ * also accepts an explicit kernel so the variants can be compared.
+ */
+namespace SqlDecode {
+
+enum class Kernel {
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+/**
+ * @brief The kernel used when none is specified.
+ */
+Kernel activeKernel();
+
+/**
+ * @brief Reports whether a kernel can run on this CPU and build.
+ */
+bool isSupported(Kernel kernel);
+
+const char* kernelName(Kernel kernel);
+
+/**
+ * @brief Finds the first quote or backslash.
+ * @return Its offset, or text.size() if there is none.
+ */
+std::size_t findSpecial(std::string_view text, Kernel kernel = activeKernel());
+
+/**
+ * @brief Decodes a string literal up to its closing quote in one pass.
+ * @param text The buffer, starting just after the opening quote.
+ * @param out Receives the decoded body (appended).
+ * @return The offset of the closing quote, or npos if the literal is unterminated.
+ */
+std::size_t decodeLiteral(std::string_view text, std::string& out, Kernel kernel = activeKernel());
+
+/**
+ * @brief Decodes a literal body whose closing quote has already been found.
+ * @param raw The text between the quotes.
+ * @return The decoded body.
+ */
+std::string decode(std::string_view raw, Kernel kernel = activeKernel());
+
+} // namespace SqlDecode
+
+#endif // SQL_DECODE_H
@@ -0,0 +1,307 @@
+#include "SqlScanner.h"
+#include "SqlDecode.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+bool isIdentifierChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' || c == '$';
+}
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+} // namespace
+
+std::size_t SqlScanner::findClosingQuote(std::string_view text, bool& has_escapes) {
+    std::size_t i = 0;
+    while (i < text.size()) {
+        std::size_t special = i + SqlDecode::findSpecial(text.substr(i));
+        if (special >= text.size()) {
+            return std::string_view::npos;
+        }
+        if (text[special] == '\\') {
+            has_escapes = true;
+            i = special + 2; // The escaped character can never close the literal
+        } else if (special + 1 < text.size() && text[special + 1] == '\'') {
+            has_escapes = true; // SQL's doubled quote ('') stands for a single quote
+            i = special + 2;
+        } else {
+            return special;
+        }
+    }
+    return std::string_view::npos;
+}
+
+void SqlScanner::readValues(std::string_view tuple, std::vector<Value>& values) {
+    SqlScanner scanner(tuple);
+    scanner.skipWhitespaceAndComments();
+    if (scanner.pos_ >= tuple.size() || tuple[scanner.pos_] != '(') {
+        scanner.fail("Expected a VALUES tuple", scanner.pos_);
+    }
+    Row row;
+    row.values = std::move(values);
+    scanner.readTuple(row);
+    values = std::move(row.values);
+}
+
+bool SqlScanner::next(Row& row) {
+    while (true) {
+        if (state_ == State::InValues) {
+            skipWhitespaceAndComments();
+            if (pos_ >= buffer_.size() || buffer_[pos_] != '(') {
+                ++skipped_statements_;
+                skipStatement();
+                state_ = State::BetweenStatements;
+                continue;
+            }
+
+            row.table = table_;
+            row.columns = &columns_;
+            readTuple(row);
+
+            skipWhitespaceAndComments();
+            if (pos_ < buffer_.size() && buffer_[pos_] == ',') {
+                ++pos_; // Another tuple of the same statement follows
+            } else {
+                skipStatement();
+                state_ = State::BetweenStatements;
+            }
+            return true;
+        }
+
+        skipWhitespaceAndComments();
+        if (pos_ >= buffer_.size()) {
+            return false;
+        }
+        if (matchKeyword("INSERT")) {
+            if (startInsert()) {
+                state_ = State::InValues;
+            } else {
+                ++skipped_statements_;
+                skipStatement();
+            }
+        } else {
+            skipStatement();
+        }
+    }
+}
+
+std::size_t SqlScanner::lineOf(const char* position) const {
+    std::size_t offset = std::min<std::size_t>(position - buffer_.data(), buffer_.size());
+    return 1 + std::count(buffer_.begin(), buffer_.begin() + offset, '\n');
+}
+
+void SqlScanner::fail(const std::string& what, std::size_t at) const {
+    throw std::runtime_error(what + " on line " + std::to_string(lineOf(buffer_.data() + at)));
+}
+
+void SqlScanner::skipWhitespaceAndComments() {
+    while (pos_ < buffer_.size()) {
+        char c = buffer_[pos_];
+        if (isSpace(c)) {
+            ++pos_;
+        } else if (c == '-' && pos_ + 1 < buffer_.size() && buffer_[pos_ + 1] == '-') {
+            std::size_t end = buffer_.find('\n', pos_);
+            pos_ = (end == std::string_view::npos) ? buffer_.size() : end + 1;
+        } else if (c == '/' && pos_ + 1 < buffer_.size() && buffer_[pos_ + 1] == '*') {
+            std::size_t end = buffer_.find("*/", pos_ + 2);
+            if (end == std::string_view::npos) {
+                fail("Unterminated comment", pos_);
+            }
+            pos_ = end + 2;
+        } else {
+            return;
+        }
+    }
+}
+
+bool SqlScanner::matchKeyword(std::string_view keyword) {
+    skipWhitespaceAndComments();
+    if (buffer_.size() - pos_ < keyword.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < keyword.size(); ++i) {
+        if (std::toupper(static_cast<unsigned char>(buffer_[pos_ + i])) != keyword[i]) {
+            return false;
+        }
+    }
+    std::size_t end = pos_ + keyword.size();
+    if (end < buffer_.size() && isIdentifierChar(buffer_[end])) {
+        return false;
+    }
+    pos_ = end;
+    return true;
+}
+
+std::string_view SqlScanner::readIdentifier() {
+    skipWhitespaceAndComments();
+    if (pos_ >= buffer_.size()) {
+        return {};
+    }
+
+    char open = buffer_[pos_];
+    if (open == '"' || open == '`' || open == '[') {
+        char close = (open == '[') ? ']' : open;
+        std::size_t end = buffer_.find(close, pos_ + 1);
+        if (end == std::string_view::npos) {
+            fail("Unterminated identifier", pos_);
+        }
+        std::string_view name = buffer_.substr(pos_ + 1, end - pos_ - 1);
+        pos_ = end + 1;
+        return name;
+    }
+
+    std::size_t start = pos_;
+    while (pos_ < buffer_.size() && isIdentifierChar(buffer_[pos_])) {
+        ++pos_;
+    }
+    return buffer_.substr(start, pos_ - start);
+}
+
+bool SqlScanner::readColumnList() {
+    columns_.clear();
+    skipWhitespaceAndComments();
+    if (pos_ >= buffer_.size() || buffer_[pos_] != '(') {
+        return true; // No column list
+    }
+    ++pos_;
+
+    while (true) {
+        std::string_view column = readIdentifier();
+        if (column.empty()) {
+            return false;
+        }
+        columns_.push_back(column);
+
+        skipWhitespaceAndComments();
+        if (pos_ >= buffer_.size()) {
+            return false;
+        }
+        if (buffer_[pos_] == ',') {
+            ++pos_;
+        } else if (buffer_[pos_] == ')') {
+            ++pos_;
+            return true;
+        } else {
+            return false;
+        }
+    }
+}
+
+bool SqlScanner::startInsert() {
+    if (!matchKeyword("INTO")) {
+        return false;
+    }
+    table_ = readIdentifier();
+    if (table_.empty() || !readColumnList()) {
+        return false;
+    }
+    return matchKeyword("VALUES");
+}
+
+void SqlScanner::readTuple(Row& row) {
+    const std::size_t start = pos_;
+    ++pos_; // Opening parenthesis
+    row.values.clear();
+
+    while (true) {
+        skipWhitespaceAndComments();
+        if (pos_ >= buffer_.size()) {
+            fail("Unterminated VALUES tuple", start);
+        }
+
+        char c = buffer_[pos_];
+        if (c == ')' && row.values.empty()) {
+            ++pos_;
+            break;
+        }
+
+        Value value;
+        if (c == '\'') {
+            std::size_t end = findClosingQuote(buffer_.substr(pos_ + 1), value.has_escapes);
+            if (end == std::string_view::npos) {
+                fail("Unterminated string literal", pos_);
+            }
+            value.raw = buffer_.substr(pos_ + 1, end);
+            value.quoted = true;
+            pos_ += end + 2;
+        } else {
+            // Bare token (NULL, number, function call); nested parentheses and strings are kept intact.
+            std::size_t token_start = pos_;
+            int depth = 0;
+            while (pos_ < buffer_.size()) {
+                char t = buffer_[pos_];
+                if (t == '\'') {
+                    bool ignored = false;
+                    std::size_t end = findClosingQuote(buffer_.substr(pos_ + 1), ignored);
+                    if (end == std::string_view::npos) {
+                        fail("Unterminated string literal", pos_);
+                    }
+                    pos_ += end + 2;
+                    continue;
+                }
+                if (t == '(') {
+                    ++depth;
+                } else if (t == ')') {
+                    if (depth == 0) break;
+                    --depth;
+                } else if (t == ',' && depth == 0) {
+                    break;
+                }
+                ++pos_;
+            }
+            std::size_t token_end = pos_;
+            while (token_end > token_start && isSpace(buffer_[token_end - 1])) {
+                --token_end;
+            }
+            value.raw = buffer_.substr(token_start, token_end - token_start);
+        }
+        row.values.push_back(value);
+
+        skipWhitespaceAndComments();
+        if (pos_ >= buffer_.size()) {
+            fail("Unterminated VALUES tuple", start);
+        }
+        if (buffer_[pos_] == ',') {
+            ++pos_;
+        } else if (buffer_[pos_] == ')') {
+            ++pos_;
+            break;
+        } else {
+            fail("Unexpected character in VALUES tuple", pos_);
+        }
+    }
+
+    row.text = buffer_.substr(start, pos_ - start);
+}
+
+void SqlScanner::skipStatement() {
+    while (pos_ < buffer_.size()) {
+        char c = buffer_[pos_];
+        if (c == ';') {
+            ++pos_;
+            return;
+        }
+        if (c == '\'') {
+            bool ignored = false;
+            std::size_t end = findClosingQuote(buffer_.substr(pos_ + 1), ignored);
+            if (end == std::string_view::npos) {
+                fail("Unterminated string literal", pos_);
+            }
+            pos_ += end + 2;
+        } else if ((c == '-' && pos_ + 1 < buffer_.size() && buffer_[pos_ + 1] == '-') ||
+                   (c == '/' && pos_ + 1 < buffer_.size() && buffer_[pos_ + 1] == '*')) {
+            skipWhitespaceAndComments();
+        } else if (c == '"' || c == '`') {
+            std::size_t end = buffer_.find(c, pos_ + 1);
+            pos_ = (end == std::string_view::npos) ? buffer_.size() : end + 1;
+        } else {
+            ++pos_;
+        }
+    }
+}
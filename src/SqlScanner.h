@@ -0,0 +1,95 @@
+#ifndef SQL_SCANNER_H
+#define SQL_SCANNER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief Single-pass scanner for the INSERT statements in a SQL dump.
+ *
+ * The scanner walks a buffer once and yields one Row per VALUES tuple of every
+ * `INSERT INTO <table> [(columns)] VALUES (...), (...);` statement. It
+ * understands statements spanning any number of lines, multi-row VALUES
+ * lists, `--` and block comments, quoted identifiers, and string literals
+ * with `''` or backslash escapes. Other statements (CREATE, DROP, ...) are
+ * skipped up to their terminating semicolon.
+ *
+ * All views point into the scanned buffer, which must outlive the rows.
+ * String values are returned still escaped; see SqlScanner::Value.
+ */
+class SqlScanner {
+public:
+    struct Value {
+        std::string_view raw;     ///< Text between the quotes (or the bare token), still escaped
+        bool quoted = false;      ///< True for string literals
+        bool has_escapes = false; ///< True if `raw` contains '' or backslash escapes
+    };
+
+    struct Row {
+        std::string_view table;
+        const std::vector<std::string_view>* columns = nullptr; ///< Empty when the INSERT lists no columns
+        std::vector<Value> values;
+        std::string_view text;    ///< The whole tuple, including its parentheses
+    };
+
+    explicit SqlScanner(std::string_view buffer) : buffer_(buffer) {}
+
+    /**
+     * @brief Advances to the next VALUES tuple.
+     * @param row Receives the tuple; its vectors are reused between calls.
+     * @return false at the end of the buffer.
+     * @throws std::runtime_error on an unterminated string, comment or tuple.
+     */
+    bool next(Row& row);
+
+    /**
+     * @brief Number of INSERT statements that were skipped because they could not be parsed.
+     */
+    std::size_t skippedStatements() const { return skipped_statements_; }
+
+    /**
+     * @brief Returns the 1-based line number of a position inside the buffer.
+     * Lines are only counted on request, so the scan itself never does it.
+     */
+    std::size_t lineOf(const char* position) const;
+
+    /**
+     * @brief Finds the closing quote of a string literal.
+     * Uses the vectorised search in SqlDecode to skip plain text.
+     * @param text The buffer, starting just after the opening quote.
+     * @param has_escapes Set to true if an escape sequence was crossed.
+     * @return The offset of the closing quote, or npos if the string is unterminated.
+     */
+    static std::size_t findClosingQuote(std::string_view text, bool& has_escapes);
+
+    /**
+     * @brief Re-reads one tuple that an earlier scan returned as Row::text.
+     * @param tuple The tuple, including its parentheses.
+     * @param values Receives the tuple's values, pointing into `tuple`.
+     * @throws std::runtime_error if the text is not a complete tuple.
+     */
+    static void readValues(std::string_view tuple, std::vector<Value>& values);
+
+private:
+    enum class State { BetweenStatements, InValues };
+
+    std::string_view buffer_;
+    std::size_t pos_ = 0;
+    State state_ = State::BetweenStatements;
+    std::string_view table_;
+    std::vector<std::string_view> columns_;
+    std::size_t skipped_statements_ = 0;
+
+    void skipWhitespaceAndComments();
+    [[noreturn]] void fail(const std::string& what, std::size_t at) const;
+    bool matchKeyword(std::string_view keyword);
+    std::string_view readIdentifier();
+    bool readColumnList();
+    void readTuple(Row& row);
+    void skipStatement();
+    bool startInsert();
+};
+
+#endif // SQL_SCANNER_H
@@ -0,0 +1,120 @@
+#include "TarWriter.h"
+#include "TemplateSink.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Offsets and widths of the ustar header fields used here.
+constexpr std::size_t kNameOffset = 0, kNameSize = 100;
+constexpr std::size_t kModeOffset = 100;
+constexpr std::size_t kUidOffset = 108;
+constexpr std::size_t kGidOffset = 116;
+constexpr std::size_t kSizeOffset = 124;
+constexpr std::size_t kMtimeOffset = 136;
+constexpr std::size_t kChecksumOffset = 148, kChecksumSize = 8;
+constexpr std::size_t kTypeOffset = 156;
+constexpr std::size_t kMagicOffset = 257;
+constexpr std::size_t kVersionOffset = 263;
+constexpr std::size_t kPrefixOffset = 345, kPrefixSize = 155;
+
+constexpr std::uint64_t kMaxSize = 077777777777ULL;  // 11 octal digits
+
+// Writes `value` as zero-padded octal in width - 1 digits and a NUL.
+void putOctal(char* field, std::size_t width, std::uint64_t value) {
+    field[width - 1] = '\0';
+    for (std::size_t i = width - 1; i-- > 0;) {
+        field[i] = static_cast<char>('0' + (value & 7));
+        value >>= 3;
+    }
+}
+
+[[noreturn]] void badPath(std::string_view path, const char* reason) {
+    throw std::invalid_argument("Cannot archive '" + std::string(path) + "': " + reason);
+}
+
+} // namespace
+
+void TarWriter::addDirectory(std::string_view path) {
+    std::string name(path);
+    if (!name.empty() && name.back() != '/') {
+        name += '/';
+    }
+    writeHeader(name, '5', 0);
+}
+
+void TarWriter::addFile(std::string_view path, std::string_view content) {
+    if (content.size() > kMaxSize) {
+        badPath(path, "file is too large for a ustar archive");
+    }
+    writeHeader(path, '0', content.size());
+    write(content);
+    static const char kZeros[kBlockSize] = {};
+    const std::size_t tail = content.size() % kBlockSize;
+    if (tail != 0) {
+        write(std::string_view(kZeros, kBlockSize - tail));
+    }
+}
+
+void TarWriter::finish() {
+    static const char kZeros[2 * kBlockSize] = {};
+    write(std::string_view(kZeros, sizeof(kZeros)));
+    out_.flush();
+}
+
+void TarWriter::writeHeader(std::string_view path, char type, std::uint64_t size) {
+    if (path.empty() || path == "/") {
+        badPath(path, "empty path");
+    }
+    if (path.front() == '/') {
+        badPath(path, "absolute path");
+    }
+    const std::string padded = "/" + std::string(path) + "/";
+    if (padded.find("/../") != std::string::npos) {
+        badPath(path, "path contains '..'");
+    }
+
+    // Paths that do not fit the name field are split into prefix and name at
+    // the last '/' the prefix can hold, which leaves the shortest name. A
+    // directory's trailing '/' stays with the name.
+    std::string_view prefix;
+    std::string_view name = path;
+    if (name.size() > kNameSize) {
+        const std::size_t split = path.rfind('/', std::min(kPrefixSize, path.size() - 2));
+        if (split == std::string_view::npos || split == 0 || path.size() - split - 1 > kNameSize) {
+            badPath(path, "path is too long for a ustar archive");
+        }
+        prefix = path.substr(0, split);
+        name = path.substr(split + 1);
+    }
+
+    char header[kBlockSize] = {};
+    std::memcpy(header + kNameOffset, name.data(), name.size());
+    putOctal(header + kModeOffset, 8, type == '5' ? 0755 : 0644);
+    putOctal(header + kUidOffset, 8, 0);
+    putOctal(header + kGidOffset, 8, 0);
+    putOctal(header + kSizeOffset, 12, size);
+    putOctal(header + kMtimeOffset, 12, mtime_ < 0 ? 0 : static_cast<std::uint64_t>(mtime_));
+    header[kTypeOffset] = type;
+    std::memcpy(header + kMagicOffset, "ustar", 6);
+    std::memcpy(header + kVersionOffset, "00", 2);
+    std::memcpy(header + kPrefixOffset, prefix.data(), prefix.size());
+
+    // The checksum is computed with its own field read as spaces.
+    std::memset(header + kChecksumOffset, ' ', kChecksumSize);
+    unsigned checksum = 0;
+    for (unsigned char c : header) {
+        checksum += c;
+    }
+    putOctal(header + kChecksumOffset, 7, checksum);
+    header[kChecksumOffset + 7] = ' ';
+
+    write(std::string_view(header, kBlockSize));
+}
+
+void TarWriter::write(std::string_view chunk) {
+    out_.write(chunk);
+    bytes_ += chunk.size();
+}
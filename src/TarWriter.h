@@ -0,0 +1,59 @@
+#ifndef TAR_WRITER_H
+#define TAR_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+class TemplateSink;
+
+/**
+ * @brief Writes a POSIX ustar archive to a sink as one sequential stream.
+ *
+ * Every entry is a 512-byte header followed by its content padded to a
+ * multiple of 512 bytes; finish() appends the two zero blocks that end the
+ * archive. Entries are owned by root with mode 0644 (files) or 0755
+ * (directories) and share one modification time, so the same output always
+ * gives the same bytes. Paths must be relative and are split into the
+ * ustar prefix and name fields when longer than 100 bytes.
+ */
+class TarWriter {
+public:
+    static constexpr std::size_t kBlockSize = 512;
+
+    /**
+     * @param out Receives the archive; must outlive the writer.
+     * @param mtime Modification time of every entry, in seconds since the epoch.
+     */
+    explicit TarWriter(TemplateSink& out, std::int64_t mtime = 0) : out_(out), mtime_(mtime) {}
+
+    /**
+     * @throws std::invalid_argument if the path is empty, absolute, contains
+     *         "..", or does not fit the ustar name and prefix fields.
+     */
+    void addDirectory(std::string_view path);
+
+    /**
+     * @throws std::invalid_argument as for addDirectory, or if the content is
+     *         larger than the 8 GiB a ustar size field can hold.
+     */
+    void addFile(std::string_view path, std::string_view content);
+
+    /**
+     * @brief Writes the end-of-archive marker and flushes the sink. Nothing
+     * may be added afterwards.
+     */
+    void finish();
+
+    std::uint64_t bytesWritten() const { return bytes_; }
+
+private:
+    TemplateSink& out_;
+    std::int64_t mtime_;
+    std::uint64_t bytes_ = 0;
+
+    void writeHeader(std::string_view path, char type, std::uint64_t size);
+    void write(std::string_view chunk);
+};
+
+#endif // TAR_WRITER_H
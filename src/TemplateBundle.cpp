@@ -0,0 +1,221 @@
+#include "TemplateBundle.h"
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace TemplateBundleFormat {
+
+std::uint32_t checksum(std::string_view content) {
+    std::uint32_t hash = 2166136261U;
+    for (unsigned char c : content) {
+        hash ^= c;
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+} // namespace TemplateBundleFormat
+
+using namespace TemplateBundleFormat;
+
+namespace {
+
+std::uint64_t alignTo(std::uint64_t value, std::uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+void writeTemplateBundle(const std::string& path, const std::vector<BundleRecord>& records) {
+    // Later records replace earlier ones with the same key; the map also
+    // orders the entries by (project_name, file_path).
+    std::map<std::pair<std::string_view, std::string_view>, std::size_t> latest;
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        latest[{records[i].project_name, records[i].file_path}] = i;
+    }
+    std::vector<const BundleRecord*> unique;
+    unique.reserve(latest.size());
+    for (const auto& pair : latest) {
+        unique.push_back(&records[pair.second]);
+    }
+
+    std::uint32_t bucket_count = 1;
+    while (bucket_count < unique.size() * 2) {
+        bucket_count <<= 1;
+    }
+
+    // Identical bodies are stored once; their entries share content_offset.
+    struct StoredContent {
+        std::uint64_t offset;
+        std::uint32_t checksum;
+    };
+    std::unordered_map<std::string_view, StoredContent> stored;
+
+    std::string strings;
+    std::vector<BundleEntryRecord> entries;
+    std::vector<std::uint32_t> buckets(bucket_count, 0);
+    for (const BundleRecord* record : unique) {
+        BundleEntryRecord entry = {};
+        entry.key_hash = hashTemplateKey(record->project_name, record->file_path);
+        entry.project_offset = static_cast<std::uint32_t>(strings.size());
+        entry.project_length = static_cast<std::uint32_t>(record->project_name.size());
+        strings += record->project_name;
+        entry.path_offset = static_cast<std::uint32_t>(strings.size());
+        entry.path_length = static_cast<std::uint32_t>(record->file_path.size());
+        strings += record->file_path;
+        entry.content_length = record->content.size();
+        auto [it, inserted] = stored.try_emplace(record->content, StoredContent{strings.size(), 0});
+        if (inserted) {
+            it->second.checksum = checksum(record->content);
+            strings += record->content;
+        }
+        entry.content_offset = it->second.offset;
+        entry.content_checksum = it->second.checksum;
+
+        std::uint32_t slot = static_cast<std::uint32_t>(entry.key_hash & (bucket_count - 1));
+        while (buckets[slot] != 0) {
+            slot = (slot + 1) & (bucket_count - 1);
+        }
+        entries.push_back(entry);
+        buckets[slot] = static_cast<std::uint32_t>(entries.size());
+    }
+
+    BundleHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.entry_count = static_cast<std::uint32_t>(entries.size());
+    header.bucket_count = bucket_count;
+    header.index_offset = sizeof(BundleHeader);
+    header.entries_offset = alignTo(header.index_offset + bucket_count * sizeof(std::uint32_t), 8);
+    header.strings_offset = header.entries_offset + entries.size() * sizeof(BundleEntryRecord);
+    header.strings_size = strings.size();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Could not create bundle: " + path);
+    }
+    const char padding[8] = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(buckets.data()), buckets.size() * sizeof(std::uint32_t));
+    out.write(padding, header.entries_offset - (header.index_offset + bucket_count * sizeof(std::uint32_t)));
+    out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(BundleEntryRecord));
+    out.write(strings.data(), strings.size());
+    if (!out) {
+        throw std::runtime_error("Failed to write bundle: " + path);
+    }
+}
+
+TemplateBundle::TemplateBundle(const std::string& path) : mapping_(path, MappedFile::Access::Random) {
+    if (mapping_.size() < sizeof(BundleHeader)) {
+        throw std::runtime_error("Bundle is truncated: " + path);
+    }
+    std::memcpy(&header_, mapping_.data(), sizeof(header_));
+    if (std::memcmp(header_.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a template bundle: " + path);
+    }
+    if (header_.version != kVersion) {
+        throw std::runtime_error("Unsupported bundle version " + std::to_string(header_.version) + ": " + path);
+    }
+
+    const std::uint64_t size = mapping_.size();
+    bool valid = header_.bucket_count != 0 &&
+                 (header_.bucket_count & (header_.bucket_count - 1)) == 0 &&
+                 header_.index_offset + std::uint64_t(header_.bucket_count) * sizeof(std::uint32_t) <= size &&
+                 header_.entries_offset + std::uint64_t(header_.entry_count) * sizeof(BundleEntryRecord) <= size &&
+                 header_.strings_offset + header_.strings_size <= size;
+    if (!valid) {
+        throw std::runtime_error("Bundle is corrupt: " + path);
+    }
+}
+
+std::size_t TemplateBundle::indexOf(std::string_view project_name, std::string_view file_path) const {
+    const std::uint64_t hash = hashTemplateKey(project_name, file_path);
+    const std::uint32_t mask = header_.bucket_count - 1;
+    const char* buckets = mapping_.data() + header_.index_offset;
+
+    std::uint32_t slot = static_cast<std::uint32_t>(hash & mask);
+    for (std::uint32_t probes = 0; probes < header_.bucket_count; ++probes) {
+        std::uint32_t bucket;
+        std::memcpy(&bucket, buckets + slot * sizeof(std::uint32_t), sizeof(bucket));
+        if (bucket == 0 || bucket > header_.entry_count) {
+            return npos;
+        }
+
+        BundleEntryRecord record;
+        std::memcpy(&record, mapping_.data() + header_.entries_offset + (bucket - 1) * sizeof(BundleEntryRecord), sizeof(record));
+        if (record.key_hash == hash) {
+            Entry candidate = entryAt(bucket - 1);
+            if (candidate.file_path == file_path && candidate.project_name == project_name) {
+                return bucket - 1;
+            }
+        }
+        slot = (slot + 1) & mask;
+    }
+    return npos;
+}
+
+bool TemplateBundle::find(std::string_view project_name, std::string_view file_path, Entry& entry) const {
+    std::size_t index = indexOf(project_name, file_path);
+    if (index == npos) {
+        return false;
+    }
+    entry = entryAt(index);
+    return true;
+}
+
+std::pair<std::size_t, std::size_t> TemplateBundle::projectRange(std::string_view project_name) const {
+    // Entries are sorted by project, so the range is found by two binary searches.
+    std::size_t low = 0;
+    std::size_t high = header_.entry_count;
+    while (low < high) {
+        std::size_t mid = low + (high - low) / 2;
+        if (projectAt(mid) < project_name) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    std::size_t begin = low;
+    high = header_.entry_count;
+    while (low < high) {
+        std::size_t mid = low + (high - low) / 2;
+        if (projectAt(mid) <= project_name) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return {begin, low};
+}
+
+std::string_view TemplateBundle::projectAt(std::size_t index) const {
+    return entryAt(index).project_name;
+}
+
+bool TemplateBundle::verify(const Entry& entry) {
+    return checksum(entry.content) == entry.checksum;
+}
+
+TemplateBundle::Entry TemplateBundle::entryAt(std::size_t index) const {
+    if (index >= header_.entry_count) {
+        throw std::out_of_range("Bundle entry index out of range");
+    }
+    BundleEntryRecord record;
+    std::memcpy(&record, mapping_.data() + header_.entries_offset + index * sizeof(BundleEntryRecord), sizeof(record));
+
+    if (std::uint64_t(record.project_offset) + record.project_length > header_.strings_size ||
+        std::uint64_t(record.path_offset) + record.path_length > header_.strings_size ||
+        record.content_offset + record.content_length > header_.strings_size) {
+        throw std::runtime_error("Bundle entry points outside the string table");
+    }
+
+    const char* strings = mapping_.data() + header_.strings_offset;
+    Entry entry;
+    entry.project_name = std::string_view(strings + record.project_offset, record.project_length);
+    entry.file_path = std::string_view(strings + record.path_offset, record.path_length);
+    entry.content = std::string_view(strings + record.content_offset, record.content_length);
+    entry.checksum = record.content_checksum;
+    return entry;
+}
@@ -0,0 +1,145 @@
+#ifndef TEMPLATE_BUNDLE_H
+#define TEMPLATE_BUNDLE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+#include "MappedFile.h"
+#include "TemplateIndex.h"
+
+/**
+ * Precompiled template bundle (.qmtb)
+ *
+ * A bundle holds already-unescaped template bodies so the loader can map it
+ * and serve lookups without parsing anything. All integers are stored in the
+ * host byte order; a bundle is built on the machine (or architecture) that
+ * deploys it. Entries are sorted by (project_name, file_path), so each
+ * project's templates are stored contiguously.
+ *
+ * Layout:
+ *   BundleHeader                         (fixed size, at offset 0)
+ *   uint32_t buckets[bucket_count]       (open-addressing index, entry + 1, 0 = empty)
+ *   BundleEntryRecord entries[entry_count]
+ *   string data                          (project names, file paths, bodies)
+ */
+namespace TemplateBundleFormat {
+
+constexpr char kMagic[4] = {'Q', 'M', 'T', 'B'};
+constexpr std::uint32_t kVersion = 2;
+
+struct BundleHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t entry_count;
+    std::uint32_t bucket_count;     ///< Always a power of two
+    std::uint64_t index_offset;
+    std::uint64_t entries_offset;
+    std::uint64_t strings_offset;
+    std::uint64_t strings_size;
+};
+
+struct BundleEntryRecord {
+    std::uint64_t key_hash;         ///< hashTemplateKey(project_name, file_path)
+    std::uint64_t content_offset;   ///< Relative to strings_offset
+    std::uint64_t content_length;
+    std::uint32_t project_offset;
+    std::uint32_t project_length;
+    std::uint32_t path_offset;
+    std::uint32_t path_length;
+    std::uint32_t content_checksum; ///< checksum() of the body
+    std::uint32_t reserved;
+};
+
+/**
+ * @brief 32-bit FNV-1a checksum of a template body.
+ */
+std::uint32_t checksum(std::string_view content);
+
+} // namespace TemplateBundleFormat
+
+/**
+ * @brief One template as written into a bundle.
+ */
+struct BundleRecord {
+    std::string project_name;
+    std::string file_path;
+    std::string content;
+};
+
+/**
+ * @brief Writes a .qmtb bundle.
+ * When several records share a (project_name, file_path) key the last one
+ * wins, matching the order in which TemplateLoader applies INSERT statements.
+ * Byte-identical bodies are written once and shared by their entries.
+ * @param path The output file.
+ * @param records The templates to store; content must already be unescaped.
+ * @throws std::runtime_error if the bundle cannot be written.
+ */
+void writeTemplateBundle(const std::string& path, const std::vector<BundleRecord>& records);
+
+/**
+ * @brief Read-only view of a mapped .qmtb bundle.
+ *
+ * Opening a bundle maps the file and validates its header; no per-entry
+ * work is done until a template is looked up.
+ */
+class TemplateBundle {
+public:
+    struct Entry {
+        std::string_view project_name;
+        std::string_view file_path;
+        std::string_view content;
+        std::uint32_t checksum;
+    };
+
+    /**
+     * @brief Maps and validates a bundle.
+     * @throws std::runtime_error if the file is missing, truncated or has the wrong magic/version.
+     */
+    explicit TemplateBundle(const std::string& path);
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /**
+     * @brief Looks up the position of a template.
+     * @return The entry index, or npos if the key is absent.
+     */
+    std::size_t indexOf(std::string_view project_name, std::string_view file_path) const;
+
+    /**
+     * @brief Looks up a template by project name and file path.
+     * @param entry Receives the entry when found.
+     * @return true if the key is present.
+     */
+    bool find(std::string_view project_name, std::string_view file_path, Entry& entry) const;
+
+    /**
+     * @brief Returns the half-open range of entry indices that belong to a project.
+     * An unknown project yields an empty range.
+     */
+    std::pair<std::size_t, std::size_t> projectRange(std::string_view project_name) const;
+
+    /**
+     * @brief Checks a looked-up entry against its stored checksum.
+     */
+    static bool verify(const Entry& entry);
+
+    std::size_t size() const { return header_.entry_count; }
+
+    /**
+     * @brief Returns the entry stored at the given position (0 <= index < size()).
+     */
+    Entry entryAt(std::size_t index) const;
+
+private:
+    std::string_view projectAt(std::size_t index) const;
+
+    MappedFile mapping_;
+    TemplateBundleFormat::BundleHeader header_;
+};
+
+#endif // TEMPLATE_BUNDLE_H
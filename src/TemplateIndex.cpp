@@ -0,0 +1,70 @@
+#include "TemplateIndex.h"
+#include <algorithm>
+#include <stdexcept>
+
+void TemplateIndex::build(std::vector<Key> keys) {
+    keys_ = std::move(keys);
+    hashes_.clear();
+    projects_.clear();
+
+    std::size_t slot_count = 1;
+    while (slot_count < keys_.size() * 2) {
+        slot_count <<= 1;
+    }
+    slots_.assign(slot_count, 0);
+    const std::size_t mask = slot_count - 1;
+
+    hashes_.reserve(keys_.size());
+    for (std::size_t i = 0; i < keys_.size(); ++i) {
+        std::uint64_t hash = hashTemplateKey(keys_[i].project_name, keys_[i].file_path);
+        hashes_.push_back(hash);
+        std::size_t slot = hash & mask;
+        while (slots_[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots_[slot] = static_cast<std::uint32_t>(i + 1);
+
+        if (projects_.empty() || projects_.back().name != keys_[i].project_name) {
+            projects_.push_back({keys_[i].project_name, i, i + 1});
+        } else {
+            projects_.back().end = i + 1;
+        }
+    }
+
+    std::sort(projects_.begin(), projects_.end(),
+              [](const ProjectSpan& a, const ProjectSpan& b) { return a.name < b.name; });
+    for (std::size_t i = 1; i < projects_.size(); ++i) {
+        if (projects_[i - 1].name == projects_[i].name) {
+            throw std::invalid_argument("Template index keys are not grouped by project: " +
+                                        std::string(projects_[i].name));
+        }
+    }
+}
+
+std::size_t TemplateIndex::find(std::string_view project_name, std::string_view file_path) const {
+    if (keys_.empty()) {
+        return npos;
+    }
+    const std::uint64_t hash = hashTemplateKey(project_name, file_path);
+    const std::size_t mask = slots_.size() - 1;
+    for (std::size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        std::uint32_t entry = slots_[slot];
+        if (entry == 0) {
+            return npos;
+        }
+        std::size_t index = entry - 1;
+        if (hashes_[index] == hash && keys_[index].file_path == file_path &&
+            keys_[index].project_name == project_name) {
+            return index;
+        }
+    }
+}
+
+std::pair<std::size_t, std::size_t> TemplateIndex::projectRange(std::string_view project_name) const {
+    auto it = std::lower_bound(projects_.begin(), projects_.end(), project_name,
+                               [](const ProjectSpan& span, std::string_view name) { return span.name < name; });
+    if (it == projects_.end() || it->name != project_name) {
+        return {0, 0};
+    }
+    return {it->begin, it->end};
+}
@@ -0,0 +1,82 @@
+#ifndef TEMPLATE_INDEX_H
+#define TEMPLATE_INDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Hash of a (project_name, file_path) key.
+ * 64-bit FNV-1a over the project name, a 0x1F separator and the file path.
+ * The .qmtb bundle format stores this value, so it must never change
+ * without a bundle version bump. It is constexpr so that embedded template
+ * tables (EmbeddedTemplates.h) can be searched at compile time.
+ */
+constexpr std::uint64_t hashTemplateKey(std::string_view project_name, std::string_view file_path) {
+    const std::uint64_t prime = 1099511628211ULL;
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (char c : project_name) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * prime;
+    }
+    hash = (hash ^ 0x1F) * prime;
+    for (char c : file_path) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * prime;
+    }
+    return hash;
+}
+
+/**
+ * @brief Immutable open-addressing index over (project_name, file_path) keys.
+ *
+ * The index mirrors `UNIQUE(project_name, file_path)` and `idx_project_name`
+ * from SQL/schema.sql. Entries are identified by their position in the
+ * caller's storage. The keys passed to build() must be sorted by project
+ * name, so every project occupies one contiguous run of positions, and they
+ * must stay alive for as long as the index is used.
+ */
+class TemplateIndex {
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    struct Key {
+        std::string_view project_name;
+        std::string_view file_path;
+    };
+
+    /**
+     * @brief Builds the index. Keys must be unique and grouped by project name.
+     * @throws std::invalid_argument if the keys are not grouped by project.
+     */
+    void build(std::vector<Key> keys);
+
+    /**
+     * @brief Looks up a key without allocating.
+     * @return The entry position, or npos if absent.
+     */
+    std::size_t find(std::string_view project_name, std::string_view file_path) const;
+
+    /**
+     * @brief Returns the half-open range of positions that belong to a project.
+     * An unknown project yields an empty range.
+     */
+    std::pair<std::size_t, std::size_t> projectRange(std::string_view project_name) const;
+
+    std::size_t size() const { return keys_.size(); }
+
+private:
+    struct ProjectSpan {
+        std::string_view name;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    std::vector<Key> keys_;
+    std::vector<std::uint64_t> hashes_;
+    std::vector<std::uint32_t> slots_;     // Entry position + 1; 0 marks an empty slot
+    std::vector<ProjectSpan> projects_;    // Sorted by name
+};
+
+#endif // TEMPLATE_INDEX_H
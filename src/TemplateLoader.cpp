@@ -1,110 +1,1252 @@
 #include "TemplateLoader.h"
+#include "SqlDecode.h"
+#include "TemplateProgram.h"
+#include "ThreadPool.h"
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <filesystem>
+#include <cctype>
+#include <algorithm>
+#include <tuple>
+#include <chrono>
+#include <future>
+#include <iterator>
 
-TemplateLoader::TemplateLoader(const std::string& sql_file_path) {
-    std::ifstream file(sql_file_path);
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open SQL file: " + sql_file_path);
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+bool isIncludeToken(std::string_view token) {
+    return token.size() > 5 && token.compare(0, 3, "{{>") == 0;
+}
+
+// "{{> partials/header.txt }}" -> "partials/header.txt"
+std::string_view includePath(std::string_view token) {
+    std::string_view path = token.substr(3, token.size() - 5);
+    std::size_t begin = path.find_first_not_of(" \t");
+    std::size_t end = path.find_last_not_of(" \t");
+    return begin == std::string_view::npos ? std::string_view() : path.substr(begin, end + 1 - begin);
+}
+
+// The value of each placeholder token; a token without a substitution stands for itself.
+std::vector<std::string_view> valuesOf(const std::vector<std::string>& tokens,
+                                       const std::map<std::string, std::string>& substitutions) {
+    std::vector<std::string_view> values(tokens.size());
+    for (std::size_t i = 0; i < tokens.size(); ++i) {
+        auto it = substitutions.find(tokens[i]);
+        values[i] = it != substitutions.end() ? std::string_view(it->second) : std::string_view(tokens[i]);
     }
+    return values;
+}
+
+// Collects rendered output into a string.
+class StringSink : public TemplateSink {
+public:
+    explicit StringSink(std::string& out) : out_(out) {}
+    void write(std::string_view chunk) override { out_.append(chunk); }
+
+private:
+    std::string& out_;
+};
 
-    std::string line;
-    while (std::getline(file, line)) {
-        // Simple check to see if the line is an INSERT statement
-        if (line.find("INSERT INTO templates") != std::string::npos) {
-            parseAndLoad(line);
+bool hasExtension(const std::string& path, const std::string& extension) {
+    return fs::path(path).extension() == extension;
+}
+
+// A bundle is only trusted when it was built after the SQL it came from.
+bool isFreshBundle(const std::string& bundle_path, const std::string& sql_file_path) {
+    std::error_code ec;
+    if (!fs::exists(bundle_path, ec)) {
+        return false;
+    }
+    if (!fs::exists(sql_file_path, ec)) {
+        return true;
+    }
+    auto bundle_time = fs::last_write_time(bundle_path, ec);
+    if (ec) return false;
+    auto sql_time = fs::last_write_time(sql_file_path, ec);
+    if (ec) return false;
+    return bundle_time >= sql_time;
+}
+
+bool hasWildcard(const std::string& name) {
+    return name.find_first_of("*?") != std::string::npos;
+}
+
+// Shell-style match supporting '*' (any run of characters) and '?' (one character).
+bool matchesWildcard(std::string_view name, std::string_view pattern) {
+    std::size_t n = 0;
+    std::size_t p = 0;
+    std::size_t star = std::string_view::npos;
+    std::size_t star_match = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            ++n;
+            ++p;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            star_match = n;
+        } else if (star != std::string_view::npos) {
+            p = star + 1;
+            n = ++star_match;
+        } else {
+            return false;
         }
     }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
 }
 
-std::string TemplateLoader::getTemplate(const std::string& key) const {
+/**
+ * Reports changes to the files a loader source names. It watches the
+ * directory rather than the file, because editors and deploy scripts often
+ * replace a file by renaming a new one over it. Uses inotify on Linux and
+ * falls back to polling modification times.
+ */
+class SourceWatcher {
+public:
+    SourceWatcher(const std::string& source_path, const std::string& bundle_path) {
+        fs::path source(source_path);
+        std::error_code ec;
+        watch_directory_ = fs::is_directory(source, ec);
+        directory_ = watch_directory_ ? source : (source.has_parent_path() ? source.parent_path() : fs::path("."));
+        name_ = source.filename().string();
+        bundle_name_ = fs::path(bundle_path).filename().string();
+
+#ifdef __linux__
+        fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd_ >= 0 && inotify_add_watch(fd_, directory_.c_str(),
+                                          IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_MOVED_FROM) < 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+        if (fd_ >= 0) {
+            return;
+        }
+        std::cerr << "Warning: inotify is unavailable, polling " << source_path << " for changes" << std::endl;
+#endif
+        signature_ = signature();
+    }
+
+    ~SourceWatcher() {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+#endif
+    }
+
+    SourceWatcher(const SourceWatcher&) = delete;
+    SourceWatcher& operator=(const SourceWatcher&) = delete;
+
+    // Blocks until a relevant file changes (true) or `stop` is set (false).
+    bool waitForChange(const std::atomic<bool>& stop) {
+        while (!stop.load()) {
+#ifdef __linux__
+            if (fd_ >= 0) {
+                struct pollfd ready = {fd_, POLLIN, 0};
+                if (poll(&ready, 1, 100) <= 0 || !drainEvents()) {
+                    continue;
+                }
+                // A save often arrives as several events; let it settle first.
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                drainEvents();
+                return true;
+            }
+#endif
+            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+            auto current = signature();
+            if (current != signature_) {
+                signature_ = std::move(current);
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    using Signature = std::vector<std::pair<std::string, fs::file_time_type>>;
+
+    bool watch_directory_ = false;
+    fs::path directory_;
+    std::string name_;
+    std::string bundle_name_;
+    Signature signature_;
+#ifdef __linux__
+    int fd_ = -1;
+#endif
+
+    bool isRelevant(const std::string& changed) const {
+        if (watch_directory_) {
+            return fs::path(changed).extension() == ".sql";
+        }
+        return changed == name_ || changed == bundle_name_ || (hasWildcard(name_) && matchesWildcard(changed, name_));
+    }
+
+    Signature signature() const {
+        Signature files;
+        std::error_code ec;
+        for (const fs::directory_entry& entry : fs::directory_iterator(directory_, ec)) {
+            std::string changed = entry.path().filename().string();
+            if (isRelevant(changed)) {
+                files.emplace_back(changed, entry.last_write_time(ec));
+            }
+        }
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+#ifdef __linux__
+    bool drainEvents() {
+        alignas(struct inotify_event) char events[4096];
+        bool relevant = false;
+        ssize_t length;
+        while ((length = read(fd_, events, sizeof(events))) > 0) {
+            for (char* at = events; at < events + length;) {
+                auto* event = reinterpret_cast<struct inotify_event*>(at);
+                if (event->len > 0 && isRelevant(event->name)) {
+                    relevant = true;
+                }
+                at += sizeof(struct inotify_event) + event->len;
+            }
+        }
+        return relevant;
+    }
+#endif
+};
+
+} // namespace
+
+TemplateLoader::TemplateLoader(const std::string& sql_file_path, LoadMode mode, std::size_t threads,
+                               TemplateMetrics* metrics)
+    : source_path_(sql_file_path), mode_(mode), threads_(threads), metrics_(metrics) {
+    auto started = std::chrono::steady_clock::now();
+    current_.store(loadSnapshot(nullptr).release());
+    if (metrics_) {
+        metrics_->recordLoad(TemplateMetrics::elapsedNs(started), false);
+    }
+}
+
+TemplateLoader::TemplateLoader(const EmbeddedTemplateSet& templates, TemplateMetrics* metrics)
+    : mode_(LoadMode::Mapped), threads_(0), metrics_(metrics), embedded_(&templates) {
+    auto started = std::chrono::steady_clock::now();
+    current_.store(loadSnapshot(nullptr).release());
+    if (metrics_) {
+        metrics_->recordLoad(TemplateMetrics::elapsedNs(started), false);
+    }
+}
+
+TemplateLoader::~TemplateLoader() {
+    stopWatching();
+    delete current_.load();
+}
+
+TemplateLoader::ReadGuard::ReadGuard(const TemplateLoader& loader) : loader_(&loader) {
+    // Register before loading the pointer: publish() swaps the pointer before
+    // it waits, so a reader it does not wait for can only see the new snapshot.
+    slot_ = loader.epoch_.load() & 1;
+    loader.readers_[slot_].fetch_add(1);
+    snapshot_ = loader.current_.load();
+}
+
+TemplateLoader::ReadGuard::ReadGuard(ReadGuard&& other) noexcept
+    : loader_(other.loader_), slot_(other.slot_), snapshot_(other.snapshot_) {
+    other.loader_ = nullptr;
+}
+
+TemplateLoader::ReadGuard::~ReadGuard() {
+    if (loader_) {
+        loader_->readers_[slot_].fetch_sub(1);
+    }
+}
+
+void TemplateLoader::publish(std::unique_ptr<Snapshot> next) {
+    Snapshot* previous = current_.exchange(next.release());
+
+    // Two epoch flips: the first drains readers registered in the old slot,
+    // the second drains any that registered in the other slot just before
+    // the flip. After both, nobody can still hold `previous`.
+    for (int phase = 0; phase < 2; ++phase) {
+        unsigned slot = epoch_.fetch_add(1) & 1;
+        while (readers_[slot].load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+    delete previous;
+}
+
+void TemplateLoader::reload() {
+    std::lock_guard<std::mutex> lock(reload_mutex_);
+    // Only reload() retires snapshots, so the current one stays valid while it
+    // is used as the source of reusable rows.
+    auto started = std::chrono::steady_clock::now();
+    std::unique_ptr<Snapshot> next = loadSnapshot(current_.load());
+    next->generation = reload_count_.load() + 1;
+    publish(std::move(next));
+    reload_count_.fetch_add(1);
+    // Entries of the old generation can no longer be hit; free them now
+    // rather than waiting for them to age out.
+    if (render_cache_) {
+        render_cache_->clear();
+    }
+    if (metrics_) {
+        metrics_->recordLoad(TemplateMetrics::elapsedNs(started), true);
+    }
+}
+
+void TemplateLoader::startWatching() {
+    if (watcher_.joinable() || embedded_) {
+        return;
+    }
+    // The watch is set up before returning, so no change made after this call is missed.
+    auto source = std::make_shared<SourceWatcher>(source_path_, bundlePathFor(source_path_));
+    stop_watching_.store(false);
+    watcher_ = std::thread([this, source]() {
+        while (source->waitForChange(stop_watching_)) {
+            try {
+                reload();
+            } catch (const std::exception& e) {
+                std::cerr << "Warning: Template reload failed, keeping the previous templates: " << e.what() << std::endl;
+            }
+        }
+    });
+}
+
+void TemplateLoader::stopWatching() {
+    if (!watcher_.joinable()) {
+        return;
+    }
+    stop_watching_.store(true);
+    watcher_.join();
+}
+
+std::unique_ptr<TemplateLoader::Snapshot> TemplateLoader::loadSnapshot(const Snapshot* previous) const {
+    auto snapshot = std::make_unique<Snapshot>();
+    if (embedded_) {
+        snapshot->embedded = embedded_;
+        snapshot->table_entries = std::make_unique<TemplateEntry[]>(embedded_->size());
+        return snapshot;
+    }
+    if (hasExtension(source_path_, ".qmtb")) {
+        snapshot->bundle = std::make_unique<TemplateBundle>(source_path_);
+        snapshot->table_entries = std::make_unique<TemplateEntry[]>(snapshot->bundle->size());
+        return snapshot;
+    }
+    std::vector<std::string> shard_paths = expandShardPaths(source_path_);
+    if (shard_paths.size() == 1 && shard_paths.front() == source_path_) {
+        std::string bundle_path = bundlePathFor(source_path_);
+        if (isFreshBundle(bundle_path, source_path_)) {
+            snapshot->bundle = std::make_unique<TemplateBundle>(bundle_path);
+            snapshot->table_entries = std::make_unique<TemplateEntry[]>(snapshot->bundle->size());
+            return snapshot;
+        }
+    }
+
+    // Shards are parsed independently; a single file is parsed on the calling thread.
+    std::vector<ParsedShard> shards(shard_paths.size());
+    if (shard_paths.size() == 1) {
+        shards[0] = parseShard(shard_paths[0], previous);
+    } else if (!shard_paths.empty()) {
+        ThreadPool pool(std::min(threads_ == 0 ? ThreadPool::defaultThreadCount() : threads_, shard_paths.size()));
+        std::vector<std::future<ParsedShard>> results;
+        results.reserve(shard_paths.size());
+        for (const std::string& path : shard_paths) {
+            results.push_back(pool.submit([this, &path, previous]() { return parseShard(path, previous); }));
+        }
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            shards[i] = results[i].get();
+        }
+    }
+
+    // Merging in shard path order makes conflicts deterministic: for a key
+    // defined in several shards, the shard whose path sorts last wins.
+    std::vector<PendingTemplate> pending;
+    for (ParsedShard& shard : shards) {
+        for (const std::string& warning : shard.warnings) {
+            std::cerr << warning << std::endl;
+        }
+        if (metrics_) {
+            std::uint64_t reused = 0;
+            std::uint64_t decoded = 0;
+            for (const PendingTemplate& parsed : shard.templates) {
+                reused += parsed.reuse != nullptr;
+                decoded += parsed.decoded.size();
+            }
+            metrics_->addStatements(shard.statement_parse.count, shard.skipped_statements, shard.statement_parse);
+            metrics_->addTemplates(shard.templates.size(), reused);
+            metrics_->addBytesScanned(shard.stats.bytes);
+            metrics_->addBytesDecoded(decoded);
+        }
+        std::move(shard.templates.begin(), shard.templates.end(), std::back_inserter(pending));
+        if (shard.mapping) {
+            snapshot->mappings.push_back(std::move(shard.mapping));
+        }
+        snapshot->shard_stats.push_back(shard.stats);
+    }
+    buildStore(*snapshot, std::move(pending));
+
+    // Copy mode already holds every body, so includes are expanded (and
+    // cycles and missing partials reported) while loading rather than on
+    // first render. Like any other load error, a missing partial is then a
+    // runtime_error naming the source.
+    if (mode_ == LoadMode::Copy) {
+        for (std::size_t i = 0; i < snapshot->entry_count; ++i) {
+            const std::vector<std::string>& tokens = snapshot->entries[i].body->compiled.placeholders();
+            if (std::any_of(tokens.begin(), tokens.end(), [](const std::string& token) { return isIncludeToken(token); })) {
+                try {
+                    expansionOf(*snapshot, snapshot->entries[i]);
+                } catch (const std::out_of_range& e) {
+                    throw std::runtime_error(source_path_ + ": " + e.what());
+                }
+            }
+        }
+    }
+    return snapshot;
+}
+
+std::vector<std::string> TemplateLoader::expandShardPaths(const std::string& path) {
+    std::vector<std::string> paths;
+    std::error_code ec;
+    if (fs::is_directory(path, ec)) {
+        for (const fs::directory_entry& entry : fs::directory_iterator(path)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".sql") {
+                paths.push_back(entry.path().string());
+            }
+        }
+        if (paths.empty()) {
+            throw std::runtime_error("No .sql files in template directory: " + path);
+        }
+    } else if (hasWildcard(fs::path(path).filename().string())) {
+        fs::path pattern(path);
+        fs::path directory = pattern.has_parent_path() ? pattern.parent_path() : fs::path(".");
+        std::string name_pattern = pattern.filename().string();
+        if (fs::is_directory(directory, ec)) {
+            for (const fs::directory_entry& entry : fs::directory_iterator(directory)) {
+                if (entry.is_regular_file() && matchesWildcard(entry.path().filename().string(), name_pattern)) {
+                    paths.push_back((pattern.has_parent_path() ? entry.path() : entry.path().filename()).string());
+                }
+            }
+        }
+        if (paths.empty()) {
+            throw std::runtime_error("No template files match: " + path);
+        }
+    } else {
+        paths.push_back(path);
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+TemplateLoader::ParsedShard TemplateLoader::parseShard(const std::string& sql_file_path, const Snapshot* previous) const {
+    ParsedShard shard;
+    shard.stats.path = sql_file_path;
+    auto started = std::chrono::steady_clock::now();
+
+    // Mapped and Lazy modes keep views into the mapping; Copy mode reads the file
+    // into a scratch buffer that is dropped once every entry owns its content.
+    std::string buffer;
+    std::string_view sql;
+    if (mode_ != LoadMode::Copy) {
+        // The scan below is the only sequential pass; see the end of this function.
+        shard.mapping = std::make_unique<MappedFile>(sql_file_path, MappedFile::Access::Sequential);
+        sql = shard.mapping->view();
+    } else {
+        std::ifstream file(sql_file_path, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open SQL file: " + sql_file_path);
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        buffer = contents.str();
+        sql = buffer;
+    }
+    shard.stats.bytes = sql.size();
+
     try {
-        return templates_.at(key);
-    } catch (const std::out_of_range&) {
-        throw std::out_of_range("Template with key '" + key + "' not found.");
+        SqlScanner scanner(sql);
+        SqlScanner::Row row;
+        // The clock is only read when metrics are enabled.
+        const bool timed = metrics_ != nullptr;
+        auto statement_start = timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        while (scanner.next(row)) {
+            if (!loadRow(row, previous, shard.templates)) {
+                shard.warnings.push_back("Warning: Could not parse SQL row on line " +
+                                         std::to_string(scanner.lineOf(row.text.data())) + " of " +
+                                         sql_file_path + ": " + std::string(row.text.substr(0, 80)));
+            }
+            if (timed) {
+                auto now = std::chrono::steady_clock::now();
+                shard.statement_parse.record(static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(now - statement_start).count()));
+                statement_start = now;
+            }
+        }
+        shard.skipped_statements = scanner.skippedStatements();
+        if (scanner.skippedStatements() > 0) {
+            shard.warnings.push_back("Warning: Skipped " + std::to_string(scanner.skippedStatements()) +
+                                     " malformed INSERT statement(s) in " + sql_file_path);
+        }
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(sql_file_path + ": " + e.what());
     }
+
+    // From here on bodies are read where and when they are first used, so the
+    // kernel should neither read ahead nor drop pages the scan has passed.
+    if (shard.mapping) {
+        shard.mapping->advise(mode_ == LoadMode::Lazy ? MappedFile::Access::Random : MappedFile::Access::Normal);
+    }
+
+    shard.stats.templates = shard.templates.size();
+    shard.stats.parse_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    return shard;
+}
+
+std::string TemplateLoader::getTemplate(const std::string& key) const {
+    return getTemplate(kDefaultProject, key);
+}
+
+std::string TemplateLoader::getTemplate(std::string_view project_name, std::string_view file_path) const {
+    ReadGuard guard(*this);
+    return std::string(contentOf(findEntry(guard.snapshot(), project_name, file_path)));
+}
+
+std::string_view TemplateLoader::getTemplateView(std::string_view key) const {
+    return getTemplateView(kDefaultProject, key);
+}
+
+std::string_view TemplateLoader::getTemplateView(std::string_view project_name, std::string_view file_path) const {
+    ReadGuard guard(*this);
+    return contentOf(findEntry(guard.snapshot(), project_name, file_path));
+}
+
+TemplateLoader::TemplateRange TemplateLoader::getProjectTemplates(std::string_view project_name) const {
+    ReadGuard guard(*this);
+    const Snapshot& snapshot = guard.snapshot();
+    auto range = snapshot.bundle     ? snapshot.bundle->projectRange(project_name)
+                 : snapshot.embedded ? snapshot.embedded->projectRange(project_name)
+                                     : snapshot.index.projectRange(project_name);
+    return TemplateRange(this, std::move(guard), range.first, range.second);
 }
 
 std::string TemplateLoader::getAndSubstitute(const std::string& key, const std::map<std::string, std::string>& substitutions) const {
-    std::string content = getTemplate(key);
+    auto started = metrics_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    ReadGuard guard(*this);
+    const TemplateEntry& entry = findEntry(guard.snapshot(), kDefaultProject, key);
+    std::string rendered;
+    if (!usesPlaceholderTokens(substitutions)) {
+        rendered = substituteByReplace(flatten(guard.snapshot(), entry), substitutions);
+    } else if (render_cache_) {
+        rendered = *renderCached(guard.snapshot(), entry, substitutions);
+    } else {
+        const CompiledTemplate& compiled = compiledOf(entry);
+        if (const Expansion* expansion = expansionOf(guard.snapshot(), entry)) {
+            StringSink sink(rendered);
+            renderExpansion(guard.snapshot(), *expansion, substitutions, sink);
+        } else {
+            rendered = compiled.render(substitutions);
+        }
+    }
+    if (metrics_) {
+        metrics_->recordRender(TemplateMetrics::elapsedNs(started));
+    }
+    return rendered;
+}
+
+void TemplateLoader::renderTo(const std::string& key, const std::map<std::string, std::string>& substitutions, TemplateSink& sink) const {
+    auto started = metrics_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    ReadGuard guard(*this);
+    const TemplateEntry& entry = findEntry(guard.snapshot(), kDefaultProject, key);
+    if (usesPlaceholderTokens(substitutions) && render_cache_) {
+        sink.write(*renderCached(guard.snapshot(), entry, substitutions));
+    } else if (usesPlaceholderTokens(substitutions)) {
+        render(guard.snapshot(), entry, substitutions, sink);
+    } else {
+        sink.write(substituteByReplace(flatten(guard.snapshot(), entry), substitutions));
+    }
+    if (metrics_) {
+        metrics_->recordRender(TemplateMetrics::elapsedNs(started));
+    }
+}
+
+TemplateLoader::RenderBatch TemplateLoader::renderBatch(
+    const std::string& key, const std::vector<std::map<std::string, std::string>>& substitution_sets) const {
+    auto started = metrics_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    ReadGuard guard(*this);
+    const Snapshot& snapshot = guard.snapshot();
+    const TemplateEntry& entry = findEntry(snapshot, kDefaultProject, key);
+    const CompiledTemplate& compiled = compiledOf(entry);
+    const Expansion* expansion = expansionOf(snapshot, entry);
+    const CompiledTemplate& program = expansion ? expansion->compiled : compiled;
+
+    // The size of an item is its literal bytes plus each value times the
+    // number of times its placeholder occurs, unless a partial is involved.
+    const std::vector<std::string>& tokens = program.placeholders();
+    std::vector<std::size_t> occurrences(tokens.size(), 0);
+    std::size_t literal_bytes = 0;
+    for (const CompiledTemplate::Segment& segment : program.segments()) {
+        if (segment.kind == CompiledTemplate::Segment::Kind::Literal) {
+            literal_bytes += segment.text.size();
+        } else {
+            ++occurrences[segment.placeholder];
+        }
+    }
+    const bool sized = !expansion || std::none_of(expansion->partials.begin(), expansion->partials.end(),
+                                                  [](const TemplateEntry* partial) { return partial != nullptr; });
+
+    const std::size_t count = substitution_sets.size();
+    std::vector<unsigned char> replaced(count);
+    bool any_replaced = false;
+    for (std::size_t i = 0; i < count; ++i) {
+        replaced[i] = !usesPlaceholderTokens(substitution_sets[i]);
+        any_replaced = any_replaced || replaced[i];
+    }
+    const std::string flat = any_replaced ? flatten(snapshot, entry) : std::string();
+
+    RenderBatch batch;
+    batch.offsets_.assign(count + 1, 0);
+    std::vector<std::string_view> values(sized ? count * tokens.size() : 0);
+    std::vector<std::string> separate(count);
+
+    // Items are independent, so both passes run over contiguous chunks.
+    const std::size_t chunks =
+        count < kParallelBatchThreshold
+            ? 1
+            : std::min(threads_ == 0 ? ThreadPool::defaultThreadCount() : threads_, count / kParallelBatchThreshold);
+    std::unique_ptr<ThreadPool> pool = chunks > 1 ? std::make_unique<ThreadPool>(chunks) : nullptr;
+    auto forEachItem = [&](auto&& visit) {
+        if (!pool) {
+            for (std::size_t i = 0; i < count; ++i) {
+                visit(i);
+            }
+            return;
+        }
+        std::vector<std::future<void>> done;
+        for (std::size_t c = 0; c < chunks; ++c) {
+            done.push_back(pool->submit([&visit, c, chunks, count]() {
+                for (std::size_t i = count * c / chunks; i < count * (c + 1) / chunks; ++i) {
+                    visit(i);
+                }
+            }));
+        }
+        for (std::future<void>& chunk : done) {
+            chunk.get();
+        }
+    };
+
+    forEachItem([&](std::size_t i) {
+        const std::map<std::string, std::string>& substitutions = substitution_sets[i];
+        if (replaced[i]) {
+            separate[i] = substituteByReplace(flat, substitutions);
+        } else if (!sized) {
+            StringSink sink(separate[i]);
+            renderExpansion(snapshot, *expansion, substitutions, sink);
+        } else {
+            std::size_t size = literal_bytes;
+            std::string_view* item = values.data() + i * tokens.size();
+            for (std::size_t p = 0; p < tokens.size(); ++p) {
+                auto it = substitutions.find(tokens[p]);
+                item[p] = it != substitutions.end() ? std::string_view(it->second) : std::string_view(tokens[p]);
+                size += item[p].size() * occurrences[p];
+            }
+            batch.offsets_[i + 1] = size;
+            return;
+        }
+        batch.offsets_[i + 1] = separate[i].size();
+    });
+
+    for (std::size_t i = 0; i < count; ++i) {
+        batch.offsets_[i + 1] += batch.offsets_[i];
+    }
+    batch.arena_.resize(batch.offsets_[count]);
+
+    forEachItem([&](std::size_t i) {
+        char* out = batch.arena_.data() + batch.offsets_[i];
+        if (replaced[i] || !sized) {
+            separate[i].copy(out, separate[i].size());
+            std::string().swap(separate[i]);
+            return;
+        }
+        const std::string_view* item = values.data() + i * tokens.size();
+        for (const CompiledTemplate::Segment& segment : program.segments()) {
+            std::string_view piece =
+                segment.kind == CompiledTemplate::Segment::Kind::Literal ? segment.text : item[segment.placeholder];
+            out = std::copy(piece.begin(), piece.end(), out);
+        }
+    });
+
+    if (metrics_ && count > 0) {
+        // One render per item, each charged an equal share of the batch.
+        const std::uint64_t share = TemplateMetrics::elapsedNs(started) / count;
+        for (std::size_t i = 0; i < count; ++i) {
+            metrics_->recordRender(share);
+        }
+    }
+    return batch;
+}
+
+bool TemplateLoader::fromBundle() const {
+    ReadGuard guard(*this);
+    return guard.snapshot().bundle != nullptr;
+}
+
+std::vector<TemplateLoader::ShardStats> TemplateLoader::shardStats() const {
+    ReadGuard guard(*this);
+    return guard.snapshot().shard_stats;
+}
+
+bool TemplateLoader::usesPlaceholderTokens(const std::map<std::string, std::string>& substitutions) {
     for (const auto& pair : substitutions) {
-        size_t pos = content.find(pair.first);
-        while (pos != std::string::npos) {
-            content.replace(pos, pair.first.length(), pair.second);
-            pos = content.find(pair.first, pos + pair.second.length());
+        if (!CompiledTemplate::isPlaceholderToken(pair.first)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<const TemplateProgram> TemplateLoader::getProgram(std::string_view project_name,
+                                                                  std::string_view file_path) const {
+    ReadGuard guard(*this);
+    const Snapshot& snapshot = guard.snapshot();
+    const TemplateEntry& entry = findEntry(snapshot, project_name, file_path);
+    // A failed compile leaves the flag unset, so the next caller reports the error again.
+    std::call_once(entry.program_compiled, [this, &snapshot, &entry]() {
+        expansionOf(snapshot, entry);
+        entry.program = std::make_shared<const TemplateProgram>(
+            TemplateProgram::compile(contentOf(entry), [this, &snapshot, &entry](std::string_view path) {
+                const TemplateEntry& partial = findPartial(snapshot, entry, path);
+                materialise(partial);
+                return std::string_view(partial.body->content);
+            }));
+    });
+    return entry.program;
+}
+
+void TemplateLoader::forEachTemplate(const std::function<void(std::string_view, std::string_view, std::string_view)>& visit) const {
+    ReadGuard guard(*this);
+    const Snapshot& snapshot = guard.snapshot();
+    if (snapshot.bundle) {
+        for (size_t i = 0; i < snapshot.bundle->size(); ++i) {
+            TemplateBundle::Entry entry = snapshot.bundle->entryAt(i);
+            visit(entry.project_name, entry.file_path, entry.content);
+        }
+        return;
+    }
+    if (snapshot.embedded) {
+        for (std::size_t i = 0; i < snapshot.embedded->size(); ++i) {
+            const EmbeddedTemplate& entry = (*snapshot.embedded)[i];
+            visit(entry.project_name, entry.file_path, entry.content);
+        }
+        return;
+    }
+    for (std::size_t i = 0; i < snapshot.entry_count; ++i) {
+        const TemplateEntry& entry = snapshot.entries[i];
+        visit(entry.project_name, entry.file_path, contentOf(entry));
+    }
+}
+
+std::string TemplateLoader::bundlePathFor(const std::string& sql_file_path) {
+    return fs::path(sql_file_path).replace_extension(".qmtb").string();
+}
+
+const TemplateLoader::TemplateEntry& TemplateLoader::findEntry(const Snapshot& snapshot, std::string_view project_name,
+                                                               std::string_view file_path) const {
+    std::size_t index = snapshot.bundle     ? snapshot.bundle->indexOf(project_name, file_path)
+                        : snapshot.embedded ? snapshot.embedded->find(project_name, file_path)
+                                            : snapshot.index.find(project_name, file_path);
+    if (index == TemplateIndex::npos) {
+        throw std::out_of_range("Template '" + std::string(file_path) + "' not found in project '" +
+                                std::string(project_name) + "'.");
+    }
+    return snapshot.bundle || snapshot.embedded ? tableEntryAt(snapshot, index) : snapshot.entries[index];
+}
+
+const TemplateLoader::TemplateEntry& TemplateLoader::tableEntryAt(const Snapshot& snapshot, std::size_t index) const {
+    // The entry exists from the start; only filling it in is done once. A
+    // checksum mismatch leaves the flag unset, so every lookup reports it.
+    TemplateEntry& entry = snapshot.table_entries[index];
+    std::call_once(entry.located, [&snapshot, &entry, index]() {
+        // Embedded bodies are compiled in, unescaped, and need no checks.
+        if (snapshot.embedded) {
+            const EmbeddedTemplate& found = (*snapshot.embedded)[index];
+            entry.project_name = std::string(found.project_name);
+            entry.file_path = std::string(found.file_path);
+            entry.raw = found.content;
+            return;
+        }
+
+        TemplateBundle::Entry found = snapshot.bundle->entryAt(index);
+        if (!TemplateBundle::verify(found)) {
+            throw std::runtime_error("Bundle checksum mismatch for template '" + std::string(found.file_path) + "'.");
+        }
+
+        // Bundle bodies are stored unescaped, so the entry only needs a view.
+        entry.project_name = std::string(found.project_name);
+        entry.file_path = std::string(found.file_path);
+        entry.raw = found.content;
+    });
+    return entry;
+}
+
+TemplateLoader::TemplateView TemplateLoader::viewAt(const Snapshot& snapshot, std::size_t index) const {
+    const TemplateEntry& entry = snapshot.bundle || snapshot.embedded ? tableEntryAt(snapshot, index) : snapshot.entries[index];
+    return {entry.project_name, entry.file_path, contentOf(entry)};
+}
+
+bool TemplateLoader::materialise(const TemplateEntry& entry) const {
+    // Concurrent first readers of the same entry must not both unescape it.
+    bool materialised = false;
+    std::call_once(entry.resolved, [&entry, &materialised]() {
+        materialised = true;
+        if (entry.content_column >= 0) {
+            std::vector<SqlScanner::Value> values;
+            SqlScanner::readValues(entry.tuple, values);
+            entry.raw = values[entry.content_column].raw;
+            entry.needs_unescape = values[entry.content_column].has_escapes;
+        }
+        if (entry.needs_unescape) {
+            entry.body = entry.pool->intern(SqlDecode::decode(entry.raw));
+        } else {
+            entry.body = ContentPool::wrap(entry.raw);
+        }
+        entry.ready.store(true);
+    });
+    if (metrics_ && materialised && entry.needs_unescape) {
+        metrics_->addBytesDecoded(entry.body->content.size());
+    }
+    return materialised;
+}
+
+std::string_view TemplateLoader::contentOf(const TemplateEntry& entry) const {
+    bool materialised = materialise(entry);
+    if (metrics_) {
+        metrics_->recordLookup(!materialised);
+    }
+    return entry.body->content;
+}
+
+const CompiledTemplate& TemplateLoader::compiledOf(const TemplateEntry& entry) const {
+    contentOf(entry);
+    return entry.body->compiled;
+}
+
+ContentPool::Stats TemplateLoader::contentStats() const {
+    ReadGuard guard(*this);
+    return guard.snapshot().content_pool.stats();
+}
+
+TemplateLoader::IncludeStats TemplateLoader::includeStats() const {
+    ReadGuard guard(*this);
+    const PartialCache& cache = guard.snapshot().partial_cache;
+    return {cache.hits.load(), cache.misses.load(), cache.size.load()};
+}
+
+namespace {
+
+std::size_t partialSlot(const void* partial, std::uint64_t fingerprint, std::size_t slots) {
+    std::uint64_t hash = fingerprint ^ (reinterpret_cast<std::uintptr_t>(partial) * 0x9E3779B97F4A7C15ULL);
+    return static_cast<std::size_t>(hash ^ (hash >> 29)) & (slots - 1);
+}
+
+} // namespace
+
+TemplateLoader::PartialCache::~PartialCache() {
+    std::atomic<const Rendered*>* table = slots.load();
+    if (!table) {
+        return;
+    }
+    for (std::size_t i = 0; i < kSlots; ++i) {
+        delete table[i].load();
+    }
+    delete[] table;
+}
+
+const TemplateLoader::PartialCache::Rendered* TemplateLoader::PartialCache::find(
+    const TemplateEntry* partial, std::uint64_t fingerprint, const std::vector<std::string_view>& values) const {
+    static_assert((kSlots & (kSlots - 1)) == 0, "kSlots must be a power of two");
+    const std::atomic<const Rendered*>* table = slots.load(std::memory_order_acquire);
+    if (!table) {
+        return nullptr;
+    }
+    const std::size_t start = partialSlot(partial, fingerprint, kSlots);
+    for (std::size_t probe = 0; probe < kMaxProbes; ++probe) {
+        const Rendered* rendered = table[(start + probe) & (kSlots - 1)].load(std::memory_order_acquire);
+        if (!rendered) {
+            return nullptr;
+        }
+        if (rendered->partial == partial && rendered->fingerprint == fingerprint &&
+            std::equal(rendered->values.begin(), rendered->values.end(), values.begin(), values.end())) {
+            return rendered;
+        }
+    }
+    return nullptr;
+}
+
+void TemplateLoader::PartialCache::insert(std::unique_ptr<Rendered> rendered) const {
+    if (full()) {
+        return;
+    }
+    std::atomic<const Rendered*>* table = slots.load(std::memory_order_acquire);
+    if (!table) {
+        auto* fresh = new std::atomic<const Rendered*>[kSlots]();
+        if (slots.compare_exchange_strong(table, fresh, std::memory_order_acq_rel)) {
+            table = fresh;
+        } else {
+            delete[] fresh;
+        }
+    }
+    const std::size_t start = partialSlot(rendered->partial, rendered->fingerprint, kSlots);
+    for (std::size_t probe = 0; probe < kMaxProbes; ++probe) {
+        std::atomic<const Rendered*>& slot = table[(start + probe) & (kSlots - 1)];
+        const Rendered* claimed = nullptr;
+        if (slot.compare_exchange_strong(claimed, rendered.get(), std::memory_order_acq_rel)) {
+            rendered.release();
+            size.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (claimed->partial == rendered->partial && claimed->fingerprint == rendered->fingerprint &&
+            claimed->values == rendered->values) {
+            return;
+        }
+    }
+}
+
+const TemplateLoader::Expansion* TemplateLoader::expansionOf(const Snapshot& snapshot, const TemplateEntry& entry) const {
+    if (!entry.expanded.load(std::memory_order_acquire)) {
+        std::vector<const TemplateEntry*> path;
+        checkIncludes(snapshot, entry, path);
+        expand(snapshot, entry);
+    }
+    return entry.expansion.get();
+}
+
+const TemplateLoader::TemplateEntry& TemplateLoader::findPartial(const Snapshot& snapshot, const TemplateEntry& entry,
+                                                                 std::string_view path) const {
+    try {
+        return findEntry(snapshot, entry.project_name, path);
+    } catch (const std::out_of_range&) {
+        throw std::out_of_range("Template '" + entry.file_path + "' in project '" + entry.project_name +
+                                "' includes '" + std::string(path) + "', which is not found.");
+    }
+}
+
+void TemplateLoader::checkIncludes(const Snapshot& snapshot, const TemplateEntry& entry,
+                                   std::vector<const TemplateEntry*>& path) const {
+    if (entry.expanded.load(std::memory_order_acquire)) {
+        return;
+    }
+    auto repeated = std::find(path.begin(), path.end(), &entry);
+    if (repeated != path.end()) {
+        std::string cycle;
+        for (; repeated != path.end(); ++repeated) {
+            cycle += (*repeated)->file_path + " -> ";
         }
+        throw std::runtime_error("Include cycle in project '" + entry.project_name + "': " + cycle + entry.file_path);
     }
-    return content;
+
+    // Expanding is part of rendering the including template, so it does not
+    // count as a lookup of its own.
+    materialise(entry);
+    path.push_back(&entry);
+    for (const std::string& token : entry.body->compiled.placeholders()) {
+        if (isIncludeToken(token)) {
+            checkIncludes(snapshot, findPartial(snapshot, entry, includePath(token)), path);
+        }
+    }
+    path.pop_back();
+}
+
+void TemplateLoader::expand(const Snapshot& snapshot, const TemplateEntry& entry) const {
+    // checkIncludes() has ruled out cycles, so the flags are taken in include
+    // order and the recursion cannot wait on a flag it holds.
+    std::call_once(entry.expansion_built, [this, &snapshot, &entry]() {
+        const CompiledTemplate& compiled = entry.body->compiled;
+        const std::vector<std::string>& tokens = compiled.placeholders();
+        if (std::none_of(tokens.begin(), tokens.end(), [](const std::string& token) { return isIncludeToken(token); })) {
+            entry.expanded.store(true, std::memory_order_release);
+            return;
+        }
+
+        // Partials without placeholders render the same for every substitution
+        // set, so their (expanded) text is copied in; the others stay as tokens.
+        auto expansion = std::make_unique<Expansion>();
+        std::map<std::string_view, const TemplateEntry*> dynamic;
+        for (const CompiledTemplate::Segment& segment : compiled.segments()) {
+            if (segment.kind == CompiledTemplate::Segment::Kind::Literal || !isIncludeToken(segment.text)) {
+                expansion->text += segment.text;
+                continue;
+            }
+            const TemplateEntry& partial = findPartial(snapshot, entry, includePath(segment.text));
+            expand(snapshot, partial);
+            const Expansion* inner = partial.expansion.get();
+            if ((inner ? inner->placeholders : partial.body->compiled.placeholders()).empty()) {
+                expansion->text += inner ? std::string_view(inner->text) : partial.body->content;
+            } else {
+                expansion->text += segment.text;
+                dynamic[segment.text] = &partial;
+            }
+        }
+
+        expansion->compiled = CompiledTemplate::compile(expansion->text);
+        std::vector<std::string>& placeholders = expansion->placeholders;
+        auto uses = [&placeholders](const std::string& token) {
+            if (std::find(placeholders.begin(), placeholders.end(), token) == placeholders.end()) {
+                placeholders.push_back(token);
+            }
+        };
+        for (const std::string& token : expansion->compiled.placeholders()) {
+            auto found = dynamic.find(token);
+            const TemplateEntry* partial = found != dynamic.end() ? found->second : nullptr;
+            expansion->partials.push_back(partial);
+            if (!partial) {
+                uses(token);
+            } else if (partial->expansion) {
+                std::for_each(partial->expansion->placeholders.begin(), partial->expansion->placeholders.end(), uses);
+            } else {
+                const std::vector<std::string>& inner = partial->body->compiled.placeholders();
+                std::for_each(inner.begin(), inner.end(), uses);
+            }
+        }
+        entry.expansion = std::move(expansion);
+        entry.expanded.store(true, std::memory_order_release);
+    });
 }
 
-void TemplateLoader::parseAndLoad(const std::string& sql_line) {
-    // This is a fragile parser. It assumes a very specific format.
-    // e.g., INSERT ... VALUES (..., 'file_path', ..., 'content');
+void TemplateLoader::render(const Snapshot& snapshot, const TemplateEntry& entry,
+                            const std::map<std::string, std::string>& substitutions, TemplateSink& sink) const {
+    const CompiledTemplate& compiled = compiledOf(entry);
+    if (const Expansion* expansion = expansionOf(snapshot, entry)) {
+        renderExpansion(snapshot, *expansion, substitutions, sink);
+    } else {
+        compiled.renderTo(substitutions, sink);
+    }
+}
 
-    // Find the VALUES clause
-    size_t values_pos = sql_line.find("VALUES");
-    if (values_pos == std::string::npos) {
-        return; // Not a valid insert statement for our purpose
+void TemplateLoader::renderExpansion(const Snapshot& snapshot, const Expansion& expansion,
+                                     const std::map<std::string, std::string>& substitutions, TemplateSink& sink) const {
+    std::vector<std::string_view> values = valuesOf(expansion.compiled.placeholders(), substitutions);
+    for (const CompiledTemplate::Segment& segment : expansion.compiled.segments()) {
+        if (segment.kind == CompiledTemplate::Segment::Kind::Literal) {
+            sink.write(segment.text);
+        } else if (const TemplateEntry* partial = expansion.partials[segment.placeholder]) {
+            renderPartial(snapshot, *partial, substitutions, sink);
+        } else {
+            sink.write(values[segment.placeholder]);
+        }
     }
+}
 
-    // Find the opening and closing parentheses of the values list
-    size_t open_paren = sql_line.find('(', values_pos);
-    size_t close_paren = sql_line.rfind(')');
-    if (open_paren == std::string::npos || close_paren == std::string::npos) {
+void TemplateLoader::renderPartial(const Snapshot& snapshot, const TemplateEntry& partial,
+                                   const std::map<std::string, std::string>& substitutions, TemplateSink& sink) const {
+    // The including template's expansion already expanded the partial.
+    const std::vector<std::string>& used =
+        partial.expansion ? partial.expansion->placeholders : partial.body->compiled.placeholders();
+    std::vector<std::string_view> values = valuesOf(used, substitutions);
+
+    // Hits are written from the cache as they are; a miss is rendered once,
+    // into the string the cache then keeps.
+    const PartialCache& cache = snapshot.partial_cache;
+    const std::uint64_t fingerprint = fingerprintValues(values);
+    if (const PartialCache::Rendered* cached = cache.find(&partial, fingerprint, values)) {
+        cache.hits.fetch_add(1, std::memory_order_relaxed);
+        sink.write(cached->output);
+        return;
+    }
+    cache.misses.fetch_add(1, std::memory_order_relaxed);
+    if (cache.full()) {
+        render(snapshot, partial, substitutions, sink);
         return;
     }
+    auto rendered = std::make_unique<PartialCache::Rendered>();
+    rendered->partial = &partial;
+    rendered->fingerprint = fingerprint;
+    rendered->values.assign(values.begin(), values.end());
+    StringSink into(rendered->output);
+    render(snapshot, partial, substitutions, into);
+    sink.write(rendered->output);
+    cache.insert(std::move(rendered));
+}
+
+std::shared_ptr<const std::string> TemplateLoader::renderCached(const Snapshot& snapshot, const TemplateEntry& entry,
+                                                                const std::map<std::string, std::string>& substitutions) const {
+    const CompiledTemplate& compiled = compiledOf(entry);
+    const Expansion* expansion = expansionOf(snapshot, entry);
+    std::vector<std::string_view> values =
+        valuesOf(expansion ? expansion->placeholders : compiled.placeholders(), substitutions);
+    const RenderCache::Key key{snapshot.generation, &entry, fingerprintValues(values)};
+    if (std::shared_ptr<const std::string> cached = render_cache_->find(key, values)) {
+        return cached;
+    }
+
+    std::string output;
+    if (expansion) {
+        StringSink sink(output);
+        renderExpansion(snapshot, *expansion, substitutions, sink);
+    } else {
+        output = compiled.render(substitutions);
+    }
+    return render_cache_->insert(key, values, std::move(output));
+}
 
-    std::string values_str = sql_line.substr(open_paren + 1, close_paren - open_paren - 1);
+void TemplateLoader::enableRenderCache(std::size_t byte_budget) {
+    render_cache_ = byte_budget == 0 ? nullptr : std::make_unique<RenderCache>(byte_budget);
+}
 
-    // We expect 3 values: 'project_name', 'file_path', 'content'
-    // Let's find the single quotes to extract the values
-    std::vector<std::string> parsed_values;
-    std::stringstream ss(values_str);
-    std::string item;
-    char delimiter = '\'';
+RenderCache::Stats TemplateLoader::renderCacheStats() const {
+    return render_cache_ ? render_cache_->stats() : RenderCache::Stats();
+}
 
-    // This logic is simplistic. It finds content between single quotes.
-    // It will break if there are escaped quotes inside the content, but for this
-    // specific format, we assume the content is clean after C++ escaping.
-    // A robust solution would need a proper SQL parsing library.
+std::string TemplateLoader::flatten(const Snapshot& snapshot, const TemplateEntry& entry) const {
+    const Expansion* expansion = expansionOf(snapshot, entry);
+    if (!expansion) {
+        return std::string(contentOf(entry));
+    }
+    std::string text;
+    for (const CompiledTemplate::Segment& segment : expansion->compiled.segments()) {
+        const TemplateEntry* partial =
+            segment.kind == CompiledTemplate::Segment::Kind::Placeholder ? expansion->partials[segment.placeholder] : nullptr;
+        text += partial ? flatten(snapshot, *partial) : std::string(segment.text);
+    }
+    return text;
+}
+
+namespace {
 
-    // A better simple approach: find the single quotes manually
-    size_t current_pos = 0;
-    while(parsed_values.size() < 3) {
-        size_t start_quote = values_str.find(delimiter, current_pos);
-        if (start_quote == std::string::npos) break;
-        size_t end_quote = values_str.find(delimiter, start_quote + 1);
-        if (end_quote == std::string::npos) break;
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
 
-        // Handle escaped quotes ''
-        while (values_str[end_quote + 1] == '\'') {
-            end_quote = values_str.find(delimiter, end_quote + 2);
-            if (end_quote == std::string::npos) break;
+// Position of a column in the tuple; INSERTs without a column list use
+// (project_name, file_path, content).
+int columnIndex(const std::vector<std::string_view>& columns, std::string_view name, int fallback) {
+    if (columns.empty()) {
+        return fallback;
+    }
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (equalsIgnoreCase(columns[i], name)) {
+            return static_cast<int>(i);
         }
-        if (end_quote == std::string::npos) break;
+    }
+    return -1;
+}
+
+} // namespace
 
-        std::string value = values_str.substr(start_quote + 1, end_quote - start_quote - 1);
-        parsed_values.push_back(value);
-        current_pos = end_quote + 1;
+bool TemplateLoader::loadRow(const SqlScanner::Row& row, const Snapshot* previous,
+                             std::vector<PendingTemplate>& pending) const {
+    if (!equalsIgnoreCase(row.table, "templates")) {
+        return true; // Rows for other tables are not ours to load
     }
 
+    const std::vector<std::string_view>& columns = *row.columns;
+    int project_index = columnIndex(columns, "project_name", 0);
+    int path_index = columnIndex(columns, "file_path", 1);
+    int content_index = columnIndex(columns, "content", 2);
+    int count = static_cast<int>(row.values.size());
+    if (project_index < 0 || path_index < 0 || content_index < 0 ||
+        project_index >= count || path_index >= count || content_index >= count) {
+        return false;
+    }
+
+    const SqlScanner::Value& project_value = row.values[project_index];
+    const SqlScanner::Value& path_value = row.values[path_index];
+    const SqlScanner::Value& content_value = row.values[content_index];
+    if (!path_value.quoted || !content_value.quoted) {
+        return false;
+    }
 
-    if (parsed_values.size() == 3) {
-        std::string project_name = parsed_values[0]; // Not used yet, but parsed
-        std::string file_path = parsed_values[1];
-        std::string content = parsed_values[2];
+    PendingTemplate& added = pending.emplace_back();
+    added.project_name = SqlDecode::decode(project_value.raw);
+    added.file_path = SqlDecode::decode(path_value.raw);
+    added.tuple_hash = hashContent(row.text);
 
-        // Un-escape SQL's double single-quotes back to a single quote
-        size_t pos = content.find("''");
-        while (pos != std::string::npos) {
-            content.replace(pos, 2, "'");
-            pos = content.find("''", pos + 1);
+    // On reload, an unchanged row whose body was already decoded is taken over
+    // from the previous snapshot instead of being decoded again.
+    if (previous && previous->entries) {
+        std::size_t index = previous->index.find(added.project_name, added.file_path);
+        if (index != TemplateIndex::npos) {
+            const TemplateEntry& old = previous->entries[index];
+            if (old.tuple_hash == added.tuple_hash && old.ready.load() && old.body->ownsContent()) {
+                added.reuse = &old;
+                return true;
+            }
         }
+    }
 
-        templates_[file_path] = content;
-        std::cout << "Loaded template: " << file_path << std::endl;
+    if (mode_ == LoadMode::Lazy) {
+        added.tuple = row.text;
+        added.content_column = content_index;
+    } else if (mode_ == LoadMode::Mapped) {
+        added.needs_unescape = content_value.has_escapes;
+        added.raw = content_value.raw;
     } else {
-        std::cerr << "Warning: Could not parse SQL line: " << sql_line << std::endl;
+        added.decoded = SqlDecode::decode(content_value.raw);
+    }
+    return true;
+}
+
+void TemplateLoader::buildStore(Snapshot& snapshot, std::vector<PendingTemplate> pending) const {
+    // The stable sort keeps rows with the same key in file order, so the last
+    // one of each run is the INSERT that wins.
+    std::stable_sort(pending.begin(), pending.end(), [](const PendingTemplate& a, const PendingTemplate& b) {
+        return std::tie(a.project_name, a.file_path) < std::tie(b.project_name, b.file_path);
+    });
+    auto sameKey = [](const PendingTemplate& a, const PendingTemplate& b) {
+        return a.project_name == b.project_name && a.file_path == b.file_path;
+    };
+
+    std::size_t unique_count = 0;
+    for (std::size_t i = 0; i < pending.size(); ++i) {
+        if (i + 1 == pending.size() || !sameKey(pending[i], pending[i + 1])) {
+            ++unique_count;
+        }
+    }
+
+    snapshot.entries = std::make_unique<TemplateEntry[]>(unique_count);
+    snapshot.entry_count = 0;
+    std::vector<TemplateIndex::Key> keys;
+    keys.reserve(unique_count);
+    for (std::size_t i = 0; i < pending.size(); ++i) {
+        if (i + 1 < pending.size() && sameKey(pending[i], pending[i + 1])) {
+            continue;
+        }
+        PendingTemplate& source = pending[i];
+        TemplateEntry& entry = snapshot.entries[snapshot.entry_count++];
+        entry.project_name = std::move(source.project_name);
+        entry.file_path = std::move(source.file_path);
+        entry.tuple_hash = source.tuple_hash;
+        entry.tuple = source.tuple;
+        entry.content_column = source.content_column;
+        entry.raw = source.raw;
+        entry.needs_unescape = source.needs_unescape;
+        entry.pool = &snapshot.content_pool;
+        if (source.reuse) {
+            // Owned bodies outlive the snapshot that created them.
+            std::call_once(entry.resolved, [&entry, &source]() {
+                entry.body = entry.pool->adopt(source.reuse->body);
+            });
+            entry.ready.store(true);
+        } else if (mode_ == LoadMode::Copy) {
+            std::call_once(entry.resolved, [&entry, &source]() {
+                entry.body = entry.pool->intern(std::move(source.decoded));
+            });
+            entry.ready.store(true);
+        }
+        keys.push_back({entry.project_name, entry.file_path});
     }
+    snapshot.index.build(std::move(keys));
 }
@@ -2,45 +2,662 @@
 #define TEMPLATE_LOADER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <functional>
+#include <iterator>
+#include <cstddef>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstdint>
 #include <stdexcept>
 
+#include "MappedFile.h"
+#include "CompiledTemplate.h"
+#include "TemplateSink.h"
+#include "TemplateBundle.h"
+#include "SqlScanner.h"
+#include "TemplateIndex.h"
+#include "TemplateMetrics.h"
+#include "ContentPool.h"
+#include "RenderCache.h"
+#include "EmbeddedTemplates.h"
+
+class TemplateProgram;
+
+/**
+ * @brief How a TemplateLoader holds the template bodies it reads.
+ */
+enum class LoadMode {
+    Copy,   ///< Read the file and keep an unescaped copy of every body.
+    Mapped, ///< Map the file once and keep views into it; bodies are unescaped on first use.
+    Lazy    ///< Map the file and record only each key and its tuple's byte range; the body is
+            ///< located, unescaped and compiled on first use.
+};
+
 class TemplateLoader {
+    struct Snapshot;
+
+    /**
+     * @brief Pins the published snapshot for the duration of a read.
+     * Constructing and destroying a guard are two atomic increments; readers
+     * never take a lock. See publish().
+     */
+    class ReadGuard {
+    public:
+        explicit ReadGuard(const TemplateLoader& loader);
+        ReadGuard(ReadGuard&& other) noexcept;
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ReadGuard& operator=(ReadGuard&&) = delete;
+        ~ReadGuard();
+
+        const Snapshot& snapshot() const { return *snapshot_; }
+
+    private:
+        const TemplateLoader* loader_;
+        unsigned slot_;
+        const Snapshot* snapshot_;
+    };
+
 public:
     /**
-     * @brief Constructs a TemplateLoader and loads templates from the given SQL file.
-     * @param sql_file_path The path to the .sql file containing template data.
+     * @brief Project that the single-key lookups (getTemplate("LICENSE"), ...) resolve in.
+     */
+    static constexpr std::string_view kDefaultProject = "generic";
+
+    /**
+     * @brief A template as seen through getProjectTemplates().
+     */
+    struct TemplateView {
+        std::string_view project_name;
+        std::string_view file_path;
+        std::string_view content;
+    };
+
+    /**
+     * @brief The templates of one project, in file_path order.
+     * Iterating resolves each body on first use, like getTemplateView. A range
+     * pins the snapshot it was taken from, so a pending reload waits until
+     * the range is destroyed; keep ranges short-lived.
+     */
+    class TemplateRange {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = TemplateView;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = TemplateView;
+
+            iterator(const TemplateLoader* loader, const Snapshot* snapshot, std::size_t index)
+                : loader_(loader), snapshot_(snapshot), index_(index) {}
+            TemplateView operator*() const { return loader_->viewAt(*snapshot_, index_); }
+            iterator& operator++() { ++index_; return *this; }
+            bool operator==(const iterator& other) const { return index_ == other.index_; }
+            bool operator!=(const iterator& other) const { return index_ != other.index_; }
+
+        private:
+            const TemplateLoader* loader_;
+            const Snapshot* snapshot_;
+            std::size_t index_;
+        };
+
+        TemplateRange(const TemplateLoader* loader, ReadGuard guard, std::size_t begin, std::size_t end)
+            : loader_(loader), guard_(std::move(guard)), begin_(begin), end_(end) {}
+        iterator begin() const { return iterator(loader_, &guard_.snapshot(), begin_); }
+        iterator end() const { return iterator(loader_, &guard_.snapshot(), end_); }
+        std::size_t size() const { return end_ - begin_; }
+        bool empty() const { return begin_ == end_; }
+
+    private:
+        const TemplateLoader* loader_;
+        ReadGuard guard_;
+        std::size_t begin_;
+        std::size_t end_;
+    };
+
+    /**
+     * @brief Load statistics for one SQL file.
      */
-    explicit TemplateLoader(const std::string& sql_file_path);
+    struct ShardStats {
+        std::string path;
+        std::size_t bytes = 0;
+        std::size_t templates = 0;   ///< Rows read, before duplicates are resolved
+        double parse_ms = 0.0;       ///< Reading and scanning, measured on the worker
+    };
 
     /**
-     * @brief Retrieves the raw content of a template.
-     * @param key The key of the template (e.g., "LICENSE", "README.md").
+     * @brief The outputs of renderBatch(), stored back to back in one buffer.
+     * Item i is arena()[offsets()[i], offsets()[i + 1]); offsets() has size() + 1 entries.
+     */
+    class RenderBatch {
+    public:
+        std::size_t size() const { return offsets_.size() - 1; }
+        bool empty() const { return size() == 0; }
+        std::string_view operator[](std::size_t index) const {
+            return std::string_view(arena_).substr(offsets_[index], offsets_[index + 1] - offsets_[index]);
+        }
+        std::string_view arena() const { return arena_; }
+        const std::vector<std::size_t>& offsets() const { return offsets_; }
+
+    private:
+        std::string arena_;
+        std::vector<std::size_t> offsets_ = {0};
+
+        friend class TemplateLoader;
+    };
+
+    /**
+     * @brief Batches at least this large are rendered on several threads.
+     */
+    static constexpr std::size_t kParallelBatchThreshold = 64;
+
+    /**
+     * @brief Constructs a TemplateLoader and loads templates from SQL.
+     *
+     * `sql_file_path` may name:
+     * - a single .sql file. If a precompiled bundle (see bundlePathFor) exists
+     *   next to it and is at least as new, the bundle is mapped instead and
+     *   nothing is parsed.
+     * - a path ending in ".qmtb", which is always opened as a bundle.
+     * - a directory, whose *.sql files are loaded as shards.
+     * - a pattern with '*' or '?' in its last component (e.g. "SQL/product_*.sql").
+     *
+     * Shards are parsed concurrently and merged in path order. When several
+     * shards define the same (project_name, file_path), the shard whose path
+     * sorts last wins.
+     * @param sql_file_path The file, directory or pattern to load.
+     * @param mode Whether to copy template bodies or keep views into a mapping of the file.
+     * @param threads Maximum number of threads for parsing shards and for
+     *        renderBatch(); 0 uses the hardware concurrency.
+     * @param metrics Receives load and render measurements; nullptr disables instrumentation.
+     *        Must outlive the loader.
+     * @throws std::runtime_error if a file cannot be read, a shard is malformed,
+     *         or a directory or pattern matches no files; in Copy mode, also if
+     *         a template includes a missing partial or its includes form a cycle.
+     */
+    explicit TemplateLoader(const std::string& sql_file_path, LoadMode mode = LoadMode::Copy, std::size_t threads = 0,
+                            TemplateMetrics* metrics = nullptr);
+
+    /**
+     * @brief Constructs a TemplateLoader over templates compiled into the binary.
+     * Nothing is read or parsed: lookups go through the set's perfect-hash
+     * index and bodies are views into its string tables. reload() and
+     * startWatching() have nothing to re-read and leave the set in place.
+     * @param templates A set generated by template_embedder; must outlive the loader.
+     * @param metrics Receives render measurements; nullptr disables instrumentation.
+     */
+    explicit TemplateLoader(const EmbeddedTemplateSet& templates, TemplateMetrics* metrics = nullptr);
+
+    /**
+     * @brief Stops watching (if enabled) and releases the loaded templates.
+     */
+    ~TemplateLoader();
+
+    TemplateLoader(const TemplateLoader&) = delete;
+    TemplateLoader& operator=(const TemplateLoader&) = delete;
+
+    /**
+     * @brief Retrieves the raw content of a template in the default project.
+     * @param key The file path of the template (e.g., "LICENSE", "README.md").
      * @return The template content as a string.
      * @throws std::out_of_range if the key is not found.
      */
     std::string getTemplate(const std::string& key) const;
 
+    /**
+     * @brief Retrieves the raw content of a template in a given project.
+     * @throws std::out_of_range if the (project_name, file_path) pair is not found.
+     */
+    std::string getTemplate(std::string_view project_name, std::string_view file_path) const;
+
+    /**
+     * @brief Retrieves the content of a template without copying it.
+     * The first call for a key may unescape the body once; later calls do not allocate.
+     * @param key The key of the template.
+     * @return A view that stays valid for the lifetime of the loader, or while
+     *         watching, until the next reload is published. Use getTemplate
+     *         for a copy that outlives reloads.
+     * @throws std::out_of_range if the key is not found.
+     */
+    std::string_view getTemplateView(std::string_view key) const;
+
+    /**
+     * @brief Retrieves the content of a template in a given project without copying it.
+     * @throws std::out_of_range if the (project_name, file_path) pair is not found.
+     */
+    std::string_view getTemplateView(std::string_view project_name, std::string_view file_path) const;
+
+    /**
+     * @brief Returns every template of a project.
+     * The templates of a project are stored contiguously, so this is a lookup
+     * in the per-project index rather than a scan of the whole store.
+     * @return An empty range if the project has no templates.
+     */
+    TemplateRange getProjectTemplates(std::string_view project_name) const;
+
     /**
      * @brief Retrieves a template and performs placeholder substitution.
+     * Rendering walks the template's precompiled segments once. Keys that are
+     * not `{{name}}` tokens fall back to plain find/replace over the content.
+     *
+     * A `{{> path}}` tag includes the template `path` of the same project.
+     * Includes are expanded once per snapshot, when the template is first
+     * rendered (at load time in Copy mode): partials without placeholders are
+     * flattened into the including body, and the others are rendered through
+     * a cache keyed by the partial and a hash of the values of the
+     * placeholders it uses. getTemplate and getTemplateView still return the
+     * body as written. The loader owns includes: getProgram() resolves a
+     * program's partials through the same lookup and checks, so both report
+     * a missing partial or a cycle alike.
      * @param key The key of the template.
      * @param substitutions A map of placeholders (e.g., "{{author}}") to their values.
      * @return The template content with all placeholders replaced.
+     * @throws std::out_of_range if the key, or a template it includes, is not found.
+     * @throws std::runtime_error if the template's includes form a cycle.
      */
     std::string getAndSubstitute(const std::string& key, const std::map<std::string, std::string>& substitutions) const;
 
+    /**
+     * @brief Renders a template with placeholder substitution directly into a sink.
+     * Unlike getAndSubstitute, no string holding the whole output is built
+     * unless a key forces the find/replace fallback.
+     * @param key The key of the template.
+     * @param substitutions A map of placeholders (e.g., "{{author}}") to their values.
+     * @param sink The destination for the rendered output.
+     * @throws std::out_of_range if the key, or a template it includes, is not found.
+     * @throws std::runtime_error if the template's includes form a cycle.
+     */
+    void renderTo(const std::string& key, const std::map<std::string, std::string>& substitutions, TemplateSink& sink) const;
+
+    /**
+     * @brief Renders one template once per substitution set, into one buffer.
+     * The template is looked up, compiled and expanded once for the whole
+     * batch. Item sizes are computed first, so the arena is allocated once
+     * and every item is written straight into its slice; items whose size
+     * depends on an included partial, or whose keys force the find/replace
+     * fallback, are rendered separately and copied in. Batches of
+     * kParallelBatchThreshold items or more are split across threads. The
+     * render cache is not consulted.
+     * @param key The key of the template.
+     * @param substitution_sets One map of placeholders to values per output.
+     * @return The outputs, in the order of `substitution_sets`.
+     * @throws std::out_of_range if the key, or a template it includes, is not found.
+     * @throws std::runtime_error if the template's includes form a cycle.
+     */
+    RenderBatch renderBatch(const std::string& key,
+                            const std::vector<std::map<std::string, std::string>>& substitution_sets) const;
+
+    /**
+     * @brief Returns a template compiled to a TemplateProgram, with its
+     * `{{> path}}` partials inlined from the same project.
+     * Each template is compiled once per snapshot, by its first caller, and
+     * the program is shared by every later one; a reload compiles it again
+     * from the new body. Includes are checked the way getAndSubstitute
+     * checks them before the program is compiled, so a missing partial or a
+     * cycle is reported the same way by both. The program owns its text and
+     * stays usable after a reload.
+     * @throws std::out_of_range if the template, or a template it includes, is not found.
+     * @throws std::runtime_error if the template's includes form a cycle.
+     * @throws std::invalid_argument if the template is not a valid program; see TemplateProgram::compile.
+     */
+    std::shared_ptr<const TemplateProgram> getProgram(std::string_view project_name, std::string_view file_path) const;
+
+    /**
+     * @brief Calls `visit` with the project name, file path and content of every loaded template.
+     * Templates are visited in (project_name, file_path) order.
+     */
+    void forEachTemplate(const std::function<void(std::string_view project_name, std::string_view file_path,
+                                                  std::string_view content)>& visit) const;
+
+    /**
+     * @brief Reports whether templates are served from a precompiled bundle.
+     */
+    bool fromBundle() const;
+
+    /**
+     * @brief Reports whether templates are served from an EmbeddedTemplateSet.
+     */
+    bool fromEmbedded() const { return embedded_ != nullptr; }
+
+    /**
+     * @brief Returns the bundle path that corresponds to a SQL file (same name, ".qmtb" extension).
+     */
+    static std::string bundlePathFor(const std::string& sql_file_path);
+
+    /**
+     * @brief Resolves a directory or pattern to the sorted list of SQL files it names.
+     * A plain file path is returned as-is.
+     */
+    static std::vector<std::string> expandShardPaths(const std::string& path);
+
+    /**
+     * @brief Per-file load statistics, in merge order. Empty when loaded from a bundle.
+     */
+    std::vector<ShardStats> shardStats() const;
+
+    /**
+     * @brief Re-reads the source and publishes the result as a new snapshot.
+     *
+     * Every statement is scanned again, but rows whose tuple text is
+     * unchanged reuse the previous snapshot's decoded and compiled body.
+     * The new snapshot is swapped in with one atomic store. Readers that
+     * started earlier finish on the old snapshot, which is freed once they
+     * have all left. If loading fails, the current snapshot stays in place.
+     * @throws std::runtime_error if the source cannot be loaded.
+     */
+    void reload();
+
+    /**
+     * @brief Watches the source file(s) and reloads in the background when they change.
+     * Uses inotify on Linux and polls modification times elsewhere. Reload
+     * failures are reported on std::cerr and leave the current templates in
+     * place. Calling it while already watching has no effect.
+     *
+     * In Mapped and Lazy modes the published snapshot reads from the mapped
+     * file, so update sources by renaming a new file over the old one; a
+     * file truncated and rewritten in place changes under its readers.
+     */
+    void startWatching();
+
+    /**
+     * @brief Stops the background watcher, waiting for an in-progress reload to finish.
+     */
+    void stopWatching();
+
+    /**
+     * @brief Number of snapshots published by reload() since construction.
+     */
+    std::size_t reloadCount() const { return reload_count_.load(); }
+
+    /**
+     * @brief The metrics passed to the constructor, or nullptr when instrumentation is disabled.
+     */
+    TemplateMetrics* metrics() const { return metrics_; }
+
+    /**
+     * @brief Content deduplication statistics of the current snapshot.
+     * Counts the decoded bodies materialised so far: all of them in Copy mode,
+     * only those already used in Mapped and Lazy modes. Bodies that are views
+     * into a mapping or bundle are not counted, as they hold no copy.
+     */
+    ContentPool::Stats contentStats() const;
+
+    /**
+     * @brief Counters of the current snapshot's cache of rendered partials.
+     */
+    struct IncludeStats {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::size_t cached = 0;  ///< Rendered partials held; at most kMaxCachedPartials
+    };
+
+    /**
+     * @brief Upper bound on the rendered partials a snapshot keeps. Once it
+     * is reached, further partials are rendered without being cached.
+     */
+    static constexpr std::size_t kMaxCachedPartials = 4096;
+
+    IncludeStats includeStats() const;
+
+    /**
+     * @brief Caches the output of getAndSubstitute and renderTo, or turns the cache off.
+     * Entries are keyed by template and by the fingerprint of the values of
+     * the placeholders that template uses (its partials' included), so
+     * rendering the same configuration again is a lookup and a copy. A reload
+     * empties the cache. Renders that fall back to find/replace are not
+     * cached. Enable the cache before the loader is shared between threads.
+     * @param byte_budget Upper bound on the bytes the cache holds; 0 disables it.
+     */
+    void enableRenderCache(std::size_t byte_budget);
+
+    /**
+     * @brief Hit, miss and eviction counters of the render cache; all zero while it is disabled.
+     */
+    RenderCache::Stats renderCacheStats() const;
+
 
 private:
-    std::map<std::string, std::string> templates_;
+    struct Expansion;
+
+    /**
+     * @brief A loaded template body.
+     * In Mapped mode `raw` points into the file mapping and the body is only
+     * decoded (SQL and backslash escapes) the first time it is requested. In Copy mode the body is
+     * unescaped into `decoded` while loading. In Lazy mode only `tuple` is
+     * recorded; `raw` is found by re-reading the tuple on first use.
+     * `body` holds the content and its compiled segments once resolved.
+     *
+     * Decoded bodies are interned in the snapshot's ContentPool, so entries
+     * with byte-identical content share one body, and a reload can hand an
+     * unchanged row's body to the next snapshot without redoing the work.
+     */
+    struct TemplateEntry {
+        std::string project_name;
+        std::string file_path;
+        std::uint64_t tuple_hash = 0;
+        std::string_view tuple;
+        int content_column = -1;
+        mutable std::string_view raw;
+        mutable bool needs_unescape = false;
+        mutable std::once_flag resolved;
+        mutable std::atomic<bool> ready{false};
+        ContentPool* pool = nullptr;  ///< Where decoded bodies are interned; null for table entries
+        mutable std::shared_ptr<const TemplateBody> body;
+        mutable std::once_flag expansion_built;
+        mutable std::atomic<bool> expanded{false};
+        mutable std::unique_ptr<const Expansion> expansion;  ///< Null if the body includes nothing
+        mutable std::once_flag program_compiled;
+        mutable std::shared_ptr<const TemplateProgram> program;  ///< Set by getProgram()
+        mutable std::once_flag located;  ///< Bundle and embedded entries: names and raw are set on first lookup
+    };
+
+    /**
+     * @brief A body with its `{{> path}}` includes resolved.
+     * Static partials are copied into `text`; includes of partials that have
+     * placeholders stay in `text` as tokens and are listed in `partials`.
+     */
+    struct Expansion {
+        std::string text;
+        CompiledTemplate compiled;                    ///< Segments of `text`
+        std::vector<const TemplateEntry*> partials;   ///< By placeholder index; null for ordinary placeholders
+        std::vector<std::string> placeholders;        ///< Every placeholder the output depends on, partials' included
+    };
+
+    /**
+     * @brief Rendered dynamic partials of one snapshot, keyed by the partial
+     * and the fingerprint of its placeholder values. The values are kept to
+     * rule out fingerprint collisions.
+     *
+     * Readers take no lock. The table is a fixed array of slots, allocated by
+     * the first insert; each slot is claimed once by compare-and-swap and
+     * never emptied, so a published output can be written straight to a sink
+     * and stays valid for the snapshot's lifetime. A partial whose probe run
+     * is full is rendered without being cached.
+     */
+    struct PartialCache {
+        struct Rendered {
+            const TemplateEntry* partial = nullptr;
+            std::uint64_t fingerprint = 0;
+            std::vector<std::string> values;
+            std::string output;
+        };
+        static constexpr std::size_t kSlots = 2 * kMaxCachedPartials;
+        static constexpr std::size_t kMaxProbes = 16;
+
+        PartialCache() = default;
+        PartialCache(const PartialCache&) = delete;
+        PartialCache& operator=(const PartialCache&) = delete;
+        ~PartialCache();
+
+        const Rendered* find(const TemplateEntry* partial, std::uint64_t fingerprint,
+                             const std::vector<std::string_view>& values) const;
+        /// Publishes `rendered` unless the cache is full or another thread published the same key first.
+        void insert(std::unique_ptr<Rendered> rendered) const;
+        bool full() const { return size.load(std::memory_order_relaxed) >= kMaxCachedPartials; }
+
+        mutable std::atomic<std::atomic<const Rendered*>*> slots{nullptr};
+        mutable std::atomic<std::size_t> size{0};
+        mutable std::atomic<std::uint64_t> hits{0};
+        mutable std::atomic<std::uint64_t> misses{0};
+    };
+
+    /**
+     * @brief A parsed row waiting to be placed in the store.
+     * Entries hold a once_flag and cannot move, so rows are collected here,
+     * sorted and deduplicated, and only then turned into TemplateEntry objects.
+     */
+    struct PendingTemplate {
+        std::string project_name;
+        std::string file_path;
+        std::uint64_t tuple_hash = 0;
+        std::string_view tuple;
+        int content_column = -1;
+        std::string_view raw;
+        bool needs_unescape = false;
+        std::string decoded;
+        const TemplateEntry* reuse = nullptr;  ///< Unchanged entry of the previous snapshot
+    };
+
+    /**
+     * @brief The output of parsing one SQL file, produced on a worker thread.
+     * Warnings are printed by loadSnapshot() so that output follows shard order.
+     */
+    struct ParsedShard {
+        std::vector<PendingTemplate> templates;
+        std::vector<std::string> warnings;
+        std::unique_ptr<MappedFile> mapping;
+        ShardStats stats;
+        std::size_t skipped_statements = 0;
+        HistogramSummary statement_parse;  ///< Only filled when metrics are enabled
+    };
+
+    /**
+     * @brief Everything one load produced. Immutable once published, apart from
+     * the lazily resolved parts of its entries.
+     */
+    struct Snapshot {
+        std::uint64_t generation = 0;  ///< 0 for the first load, then the reload count
+        std::vector<std::unique_ptr<MappedFile>> mappings;
+        std::vector<ShardStats> shard_stats;
+
+        // Entries sorted by (project_name, file_path); index refers to them by position.
+        std::unique_ptr<TemplateEntry[]> entries;
+        std::size_t entry_count = 0;
+        TemplateIndex index;
+        ContentPool content_pool;
+
+        // Bundle and embedded sources: one entry per table row, allocated
+        // with the snapshot and filled in on first lookup (bundle entries
+        // after their checksum is verified).
+        std::unique_ptr<TemplateBundle> bundle;
+        const EmbeddedTemplateSet* embedded = nullptr;
+        std::unique_ptr<TemplateEntry[]> table_entries;
+
+        // Each entry's includes are expanded once, under its own once_flag.
+        PartialCache partial_cache;
+    };
+
+    std::string source_path_;
+    LoadMode mode_;
+    std::size_t threads_;
+    TemplateMetrics* metrics_;
+    const EmbeddedTemplateSet* embedded_ = nullptr;
+    std::unique_ptr<RenderCache> render_cache_;
+
+    // The published snapshot and the two reader counters used to retire old
+    // ones: readers register in the slot of the current epoch, and publish()
+    // advances the epoch twice, waiting for each slot to drain.
+    std::atomic<Snapshot*> current_{nullptr};
+    std::atomic<unsigned> epoch_{0};
+    mutable std::atomic<std::size_t> readers_[2] = {};
+    std::atomic<std::size_t> reload_count_{0};
+    std::mutex reload_mutex_;
+
+    std::thread watcher_;
+    std::atomic<bool> stop_watching_{false};
+
+    /**
+     * @brief Parses one VALUES tuple of an INSERT INTO templates statement.
+     * The project_name, file_path and content columns are located through the
+     * statement's column list. In Copy mode the content is unescaped
+     * immediately; in Mapped mode the row keeps a view into the mapping; in
+     * Lazy mode it keeps the tuple's range and the content's column.
+     * @param row A tuple produced by SqlScanner.
+     * @param pending Receives the parsed row.
+     * @return false if the tuple lacks one of the required columns.
+     */
+    bool loadRow(const SqlScanner::Row& row, const Snapshot* previous, std::vector<PendingTemplate>& pending) const;
+
+    /**
+     * @brief Reads and scans one SQL file. Safe to call from several threads at once.
+     * @param previous The snapshot being replaced, whose unchanged rows are reused; may be null.
+     * @throws std::runtime_error naming the file if it cannot be read or is malformed.
+     */
+    ParsedShard parseShard(const std::string& sql_file_path, const Snapshot* previous) const;
+
+    /**
+     * @brief Loads the source into a new, unpublished snapshot.
+     */
+    std::unique_ptr<Snapshot> loadSnapshot(const Snapshot* previous) const;
+
+    /**
+     * @brief Moves the parsed rows into the sorted entry array and builds the index.
+     * A later row for the same (project_name, file_path) replaces an earlier one.
+     */
+    void buildStore(Snapshot& snapshot, std::vector<PendingTemplate> pending) const;
+
+    /**
+     * @brief Makes `next` the snapshot new readers see, then frees the old one
+     * once every reader that could still be using it has finished.
+     */
+    void publish(std::unique_ptr<Snapshot> next);
+
+    const TemplateEntry& findEntry(const Snapshot& snapshot, std::string_view project_name,
+                                   std::string_view file_path) const;
+    const TemplateEntry& tableEntryAt(const Snapshot& snapshot, std::size_t index) const;
+    TemplateView viewAt(const Snapshot& snapshot, std::size_t index) const;
+    bool materialise(const TemplateEntry& entry) const;
+    std::string_view contentOf(const TemplateEntry& entry) const;
+    const CompiledTemplate& compiledOf(const TemplateEntry& entry) const;
+
+    /**
+     * @brief Returns the entry's expansion, building it (and its partials') on first use.
+     * @return nullptr if the body includes no partials.
+     */
+    const Expansion* expansionOf(const Snapshot& snapshot, const TemplateEntry& entry) const;
+
+    /**
+     * @brief Follows the includes of an entry not yet expanded, without
+     * taking any entry's once_flag, and reports a cycle or missing partial.
+     * Run before expand(): two threads expanding a cycle from different ends
+     * would otherwise each wait for the other's flag.
+     * @throws std::runtime_error naming the chain if the includes form a cycle.
+     */
+    void checkIncludes(const Snapshot& snapshot, const TemplateEntry& entry,
+                       std::vector<const TemplateEntry*>& path) const;
+    void expand(const Snapshot& snapshot, const TemplateEntry& entry) const;
 
     /**
-     * @brief Parses a simple SQL INSERT statement to extract file_path and content.
-     * This is a very basic parser and not a full SQL parser.
-     * It expects a specific format: INSERT INTO templates (..., file_path, ..., content) VALUES (..., 'path', ..., 'content');
-     * @param sql_line A line containing a SQL INSERT statement.
+     * @brief Looks up the partial `path` that `entry` includes, in entry's project.
+     * @throws std::out_of_range naming both templates if the partial is not found.
      */
-    void parseAndLoad(const std::string& sql_line);
+    const TemplateEntry& findPartial(const Snapshot& snapshot, const TemplateEntry& entry, std::string_view path) const;
+    void render(const Snapshot& snapshot, const TemplateEntry& entry, const std::map<std::string, std::string>& substitutions,
+                TemplateSink& sink) const;
+    void renderExpansion(const Snapshot& snapshot, const Expansion& expansion,
+                         const std::map<std::string, std::string>& substitutions, TemplateSink& sink) const;
+    void renderPartial(const Snapshot& snapshot, const TemplateEntry& partial,
+                       const std::map<std::string, std::string>& substitutions, TemplateSink& sink) const;
+    std::string flatten(const Snapshot& snapshot, const TemplateEntry& entry) const;
+    std::shared_ptr<const std::string> renderCached(const Snapshot& snapshot, const TemplateEntry& entry,
+                                                    const std::map<std::string, std::string>& substitutions) const;
+    static bool usesPlaceholderTokens(const std::map<std::string, std::string>& substitutions);
 };
 
 #endif // TEMPLATE_LOADER_H
@@ -0,0 +1,184 @@
+#include "TemplateMetrics.h"
+#include <sstream>
+
+namespace {
+
+std::size_t bucketFor(std::uint64_t nanoseconds) {
+    std::size_t bucket = 0;
+    while (nanoseconds > 1 && bucket + 1 < HistogramSummary::kBuckets) {
+        nanoseconds >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void updateMax(std::atomic<std::uint64_t>& max, std::uint64_t value) {
+    std::uint64_t current = max.load(std::memory_order_relaxed);
+    while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void writeHistogram(std::ostringstream& out, const HistogramSummary& histogram) {
+    out << "{\"count\": " << histogram.count
+        << ", \"mean\": " << histogram.meanNs()
+        << ", \"p50\": " << histogram.percentileNs(50)
+        << ", \"p90\": " << histogram.percentileNs(90)
+        << ", \"p99\": " << histogram.percentileNs(99)
+        << ", \"max\": " << histogram.max_ns
+        << ", \"buckets\": [";
+    bool first = true;
+    for (std::size_t i = 0; i < HistogramSummary::kBuckets; ++i) {
+        if (histogram.buckets[i] == 0) continue;
+        out << (first ? "" : ", ") << "{\"le\": " << (std::uint64_t(2) << i) << ", \"count\": " << histogram.buckets[i] << "}";
+        first = false;
+    }
+    out << "]}";
+}
+
+} // namespace
+
+void HistogramSummary::record(std::uint64_t nanoseconds) {
+    ++buckets[bucketFor(nanoseconds)];
+    ++count;
+    total_ns += nanoseconds;
+    if (nanoseconds > max_ns) {
+        max_ns = nanoseconds;
+    }
+}
+
+double HistogramSummary::meanNs() const {
+    return count == 0 ? 0.0 : static_cast<double>(total_ns) / static_cast<double>(count);
+}
+
+std::uint64_t HistogramSummary::percentileNs(double percentile) const {
+    if (count == 0) {
+        return 0;
+    }
+    std::uint64_t rank = static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(count) + 0.5);
+    if (rank == 0) rank = 1;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            std::uint64_t upper = std::uint64_t(2) << i;
+            return upper < max_ns ? upper : max_ns;
+        }
+    }
+    return max_ns;
+}
+
+void LatencyHistogram::record(std::uint64_t nanoseconds) {
+    buckets_[bucketFor(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    total_ns_.fetch_add(nanoseconds, std::memory_order_relaxed);
+    updateMax(max_ns_, nanoseconds);
+}
+
+void LatencyHistogram::merge(const HistogramSummary& local) {
+    if (local.count == 0) {
+        return;
+    }
+    for (std::size_t i = 0; i < HistogramSummary::kBuckets; ++i) {
+        if (local.buckets[i] != 0) {
+            buckets_[i].fetch_add(local.buckets[i], std::memory_order_relaxed);
+        }
+    }
+    count_.fetch_add(local.count, std::memory_order_relaxed);
+    total_ns_.fetch_add(local.total_ns, std::memory_order_relaxed);
+    updateMax(max_ns_, local.max_ns);
+}
+
+HistogramSummary LatencyHistogram::summary() const {
+    HistogramSummary summary;
+    for (std::size_t i = 0; i < HistogramSummary::kBuckets; ++i) {
+        summary.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    summary.count = count_.load(std::memory_order_relaxed);
+    summary.total_ns = total_ns_.load(std::memory_order_relaxed);
+    summary.max_ns = max_ns_.load(std::memory_order_relaxed);
+    return summary;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    total_ns_.store(0, std::memory_order_relaxed);
+    max_ns_.store(0, std::memory_order_relaxed);
+}
+
+void TemplateMetrics::addStatements(std::uint64_t scanned, std::uint64_t skipped, const HistogramSummary& parse_times) {
+    statements_scanned_.fetch_add(scanned, std::memory_order_relaxed);
+    statements_skipped_.fetch_add(skipped, std::memory_order_relaxed);
+    statement_parse_.merge(parse_times);
+}
+
+void TemplateMetrics::addTemplates(std::uint64_t loaded, std::uint64_t reused) {
+    templates_loaded_.fetch_add(loaded, std::memory_order_relaxed);
+    templates_reused_.fetch_add(reused, std::memory_order_relaxed);
+}
+
+void TemplateMetrics::recordRender(std::uint64_t nanoseconds) {
+    renders_.fetch_add(1, std::memory_order_relaxed);
+    render_.record(nanoseconds);
+}
+
+void TemplateMetrics::recordLoad(std::uint64_t nanoseconds, bool reload) {
+    if (reload) {
+        reloads_.fetch_add(1, std::memory_order_relaxed);
+    }
+    load_.record(nanoseconds);
+}
+
+TemplateMetrics::Report TemplateMetrics::report() const {
+    Report report;
+    report.statements_scanned = statements_scanned_.load(std::memory_order_relaxed);
+    report.statements_skipped = statements_skipped_.load(std::memory_order_relaxed);
+    report.templates_loaded = templates_loaded_.load(std::memory_order_relaxed);
+    report.templates_reused = templates_reused_.load(std::memory_order_relaxed);
+    report.bytes_scanned = bytes_scanned_.load(std::memory_order_relaxed);
+    report.bytes_decoded = bytes_decoded_.load(std::memory_order_relaxed);
+    report.cache_hits = cache_hits_.load(std::memory_order_relaxed);
+    report.cache_misses = cache_misses_.load(std::memory_order_relaxed);
+    report.renders = renders_.load(std::memory_order_relaxed);
+    report.reloads = reloads_.load(std::memory_order_relaxed);
+    report.statement_parse = statement_parse_.summary();
+    report.render = render_.summary();
+    report.load = load_.summary();
+    return report;
+}
+
+std::string TemplateMetrics::toJson() const {
+    Report r = report();
+    std::ostringstream out;
+    out << "{\n"
+        << "  \"statements_scanned\": " << r.statements_scanned << ",\n"
+        << "  \"statements_skipped\": " << r.statements_skipped << ",\n"
+        << "  \"templates_loaded\": " << r.templates_loaded << ",\n"
+        << "  \"templates_reused\": " << r.templates_reused << ",\n"
+        << "  \"bytes_scanned\": " << r.bytes_scanned << ",\n"
+        << "  \"bytes_decoded\": " << r.bytes_decoded << ",\n"
+        << "  \"cache_hits\": " << r.cache_hits << ",\n"
+        << "  \"cache_misses\": " << r.cache_misses << ",\n"
+        << "  \"renders\": " << r.renders << ",\n"
+        << "  \"reloads\": " << r.reloads << ",\n"
+        << "  \"statement_parse_ns\": ";
+    writeHistogram(out, r.statement_parse);
+    out << ",\n  \"render_ns\": ";
+    writeHistogram(out, r.render);
+    out << ",\n  \"load_ns\": ";
+    writeHistogram(out, r.load);
+    out << "\n}";
+    return out.str();
+}
+
+void TemplateMetrics::reset() {
+    for (auto* counter : {&statements_scanned_, &statements_skipped_, &templates_loaded_, &templates_reused_,
+                          &bytes_scanned_, &bytes_decoded_, &cache_hits_, &cache_misses_, &renders_, &reloads_}) {
+        counter->store(0, std::memory_order_relaxed);
+    }
+    statement_parse_.reset();
+    render_.reset();
+    load_.reset();
+}
@@ -0,0 +1,127 @@
+#ifndef TEMPLATE_METRICS_H
+#define TEMPLATE_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Plain latency histogram with power-of-two nanosecond buckets.
+ * Bucket i counts samples in [2^i, 2^(i+1)) ns; bucket 0 also holds 0 ns.
+ * Not thread-safe: use it as a local accumulator or as a copied result.
+ */
+struct HistogramSummary {
+    static constexpr std::size_t kBuckets = 40; // Up to about 18 minutes
+
+    std::array<std::uint64_t, kBuckets> buckets{};
+    std::uint64_t count = 0;
+    std::uint64_t total_ns = 0;
+    std::uint64_t max_ns = 0;
+
+    void record(std::uint64_t nanoseconds);
+    double meanNs() const;
+
+    /**
+     * @brief Estimates a percentile (0-100) from the buckets.
+     * @return The upper bound of the bucket containing the percentile, capped at max_ns.
+     */
+    std::uint64_t percentileNs(double percentile) const;
+};
+
+/**
+ * @brief Thread-safe counterpart of HistogramSummary, updated with relaxed atomics.
+ */
+class LatencyHistogram {
+public:
+    void record(std::uint64_t nanoseconds);
+    void merge(const HistogramSummary& local);
+    HistogramSummary summary() const;
+    void reset();
+
+private:
+    std::array<std::atomic<std::uint64_t>, HistogramSummary::kBuckets> buckets_{};
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> total_ns_{0};
+    std::atomic<std::uint64_t> max_ns_{0};
+};
+
+/**
+ * @brief Load and render instrumentation for a TemplateLoader.
+ *
+ * A loader only records into a TemplateMetrics that is passed to its
+ * constructor; without one, every instrumentation point is a single null
+ * check and no clock is read. Counters are atomics, so a metrics object can
+ * be read (report(), toJson()) while the loader is in use, and one object
+ * may be shared by several loaders.
+ */
+class TemplateMetrics {
+public:
+    /**
+     * @brief A point-in-time copy of every metric.
+     */
+    struct Report {
+        std::uint64_t statements_scanned = 0;  ///< INSERT tuples read by the scanner
+        std::uint64_t statements_skipped = 0;  ///< Malformed INSERT statements
+        std::uint64_t templates_loaded = 0;    ///< Rows of the templates table
+        std::uint64_t templates_reused = 0;    ///< Rows a reload took over unchanged
+        std::uint64_t bytes_scanned = 0;
+        std::uint64_t bytes_decoded = 0;       ///< Body bytes produced by unescaping
+        std::uint64_t cache_hits = 0;          ///< Lookups of an already materialised body
+        std::uint64_t cache_misses = 0;        ///< Lookups that decoded or compiled a body
+        std::uint64_t renders = 0;
+        std::uint64_t reloads = 0;
+        HistogramSummary statement_parse;      ///< Per tuple: scanning plus loading the row
+        HistogramSummary render;               ///< getAndSubstitute and renderTo calls
+        HistogramSummary load;                 ///< Whole loads, including reloads
+    };
+
+    TemplateMetrics() = default;
+    TemplateMetrics(const TemplateMetrics&) = delete;
+    TemplateMetrics& operator=(const TemplateMetrics&) = delete;
+
+    void addStatements(std::uint64_t scanned, std::uint64_t skipped, const HistogramSummary& parse_times);
+    void addTemplates(std::uint64_t loaded, std::uint64_t reused);
+    void addBytesScanned(std::uint64_t bytes) { bytes_scanned_.fetch_add(bytes, std::memory_order_relaxed); }
+    void addBytesDecoded(std::uint64_t bytes) { bytes_decoded_.fetch_add(bytes, std::memory_order_relaxed); }
+    void recordLookup(bool hit) { (hit ? cache_hits_ : cache_misses_).fetch_add(1, std::memory_order_relaxed); }
+    void recordRender(std::uint64_t nanoseconds);
+    void recordLoad(std::uint64_t nanoseconds, bool reload);
+
+    Report report() const;
+
+    /**
+     * @brief Serialises report() as a JSON object. Histograms include count,
+     * mean, p50/p90/p99, max and their non-empty buckets.
+     */
+    std::string toJson() const;
+
+    void reset();
+
+    /**
+     * @brief Nanoseconds elapsed since a steady_clock time point.
+     */
+    static std::uint64_t elapsedNs(std::chrono::steady_clock::time_point start) {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+private:
+    std::atomic<std::uint64_t> statements_scanned_{0};
+    std::atomic<std::uint64_t> statements_skipped_{0};
+    std::atomic<std::uint64_t> templates_loaded_{0};
+    std::atomic<std::uint64_t> templates_reused_{0};
+    std::atomic<std::uint64_t> bytes_scanned_{0};
+    std::atomic<std::uint64_t> bytes_decoded_{0};
+    std::atomic<std::uint64_t> cache_hits_{0};
+    std::atomic<std::uint64_t> cache_misses_{0};
+    std::atomic<std::uint64_t> renders_{0};
+    std::atomic<std::uint64_t> reloads_{0};
+    LatencyHistogram statement_parse_;
+    LatencyHistogram render_;
+    LatencyHistogram load_;
+};
+
+#endif // TEMPLATE_METRICS_H
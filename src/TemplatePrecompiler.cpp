@@ -0,0 +1,235 @@
+#include "TemplatePrecompiler.h"
+#include "GeneratedSource.h"
+#include "TemplateProgram.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+using Op = TemplateProgram::Op;
+
+// The expression a Text, Field or Item instruction writes: a literal
+// constant, a ProjectConfig member, or the current element of a loop.
+struct Operand {
+    std::string expression;
+    std::size_t literal_bytes = 0;  // For literals; fields add their size() instead
+    bool field = false;
+};
+
+std::string loopList(std::size_t depth) { return "list" + std::to_string(depth); }
+std::string loopItem(std::size_t depth) { return "item" + std::to_string(depth); }
+
+// Lowers a program to the statements of a render function. Jumps become
+// gotos to labels placed only before their targets; each loop nesting level
+// has a list pointer and an index, declared first so that no goto skips an
+// initialisation. `write` turns an expression into the statement that
+// outputs it, and `end_label` is what follows a label at the very end.
+std::string lowerProgram(const TemplateProgram& program, const std::vector<Operand>& operands,
+                         const std::function<std::string(const std::string&)>& write, const std::string& end_label) {
+    const std::vector<TemplateProgram::Instruction>& code = program.code();
+    std::set<std::size_t> targets;
+    std::size_t depth = 0;
+    std::size_t max_depth = 0;
+    for (const TemplateProgram::Instruction& instruction : code) {
+        if (instruction.op != Op::Text && instruction.op != Op::Field && instruction.op != Op::Item) {
+            targets.insert(instruction.b);
+        }
+        if (instruction.op == Op::EachBegin) {
+            max_depth = std::max(max_depth, ++depth);
+        } else if (instruction.op == Op::EachNext) {
+            --depth;
+        }
+    }
+
+    std::ostringstream body;
+    for (std::size_t level = 0; level < max_depth; ++level) {
+        body << "    const std::vector<std::string>* " << loopList(level) << " = nullptr;\n"
+             << "    std::size_t " << loopItem(level) << " = 0;\n";
+    }
+    // Loops are nested blocks, so the depth at each instruction is static.
+    for (std::size_t pc = 0; pc < code.size(); ++pc) {
+        if (targets.count(pc)) {
+            body << "l" << pc << ":\n";
+        }
+        const TemplateProgram::Instruction& instruction = code[pc];
+        switch (instruction.op) {
+            case Op::Text:
+            case Op::Field:
+                body << "    " << write(operands[pc].expression) << "\n";
+                break;
+            case Op::Item:
+                body << "    " << write("(*" + loopList(depth - 1) + ")[" + loopItem(depth - 1) + "]") << "\n";
+                break;
+            case Op::JumpIfNot:
+            case Op::JumpIf:
+                body << "    if (" << (instruction.op == Op::JumpIfNot ? "!" : "") << "kProjectConfigConditions["
+                     << instruction.a << "].test(config)) goto l" << instruction.b << ";  // "
+                     << kProjectConfigConditions[instruction.a].name << "\n";
+                break;
+            case Op::Jump:
+                body << "    goto l" << instruction.b << ";\n";
+                break;
+            case Op::EachBegin:
+                body << "    " << loopList(depth) << " = &config." << kProjectConfigLists[instruction.a].member << ";\n"
+                     << "    if (" << loopList(depth) << "->empty()) goto l" << instruction.b << ";\n"
+                     << "    " << loopItem(depth) << " = 0;\n";
+                ++depth;
+                break;
+            case Op::EachNext:
+                --depth;
+                body << "    if (++" << loopItem(depth) << " < " << loopList(depth) << "->size()) goto l"
+                     << instruction.b << ";\n";
+                break;
+        }
+    }
+    if (targets.count(code.size())) {
+        body << "l" << code.size() << ":\n" << end_label;
+    }
+    return body.str();
+}
+
+// "kPrecompiledTemplates" -> "PrecompiledTemplatesDetail"
+std::string detailNamespaceFor(const std::string& symbol) {
+    bool prefixed = symbol.size() > 1 && symbol[0] == 'k' && std::isupper(static_cast<unsigned char>(symbol[1]));
+    return (prefixed ? symbol.substr(1) : symbol) + "Detail";
+}
+
+} // namespace
+
+PrecompileReport writePrecompiledTemplates(const std::string& path, const std::vector<BundleRecord>& records,
+                                          const std::string& symbol, const std::string& source) {
+    // Later records replace earlier ones with the same key; the map also
+    // orders the templates by (project_name, file_path).
+    std::map<std::pair<std::string_view, std::string_view>, std::size_t> latest;
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        latest[{records[i].project_name, records[i].file_path}] = i;
+    }
+
+    const std::string guard = GeneratedSource::includeGuardFor(path);
+    const std::string detail = detailNamespaceFor(symbol);
+    PrecompileReport report;
+    std::set<std::uint32_t> conditions;  // Indices the generated code relies on
+    std::ostringstream out;
+    std::ostringstream table;
+    out << "// Generated by template_precompiler from " << source << ". Do not edit.\n"
+        << "#ifndef " << guard << "\n"
+        << "#define " << guard << "\n\n"
+        << "#include <cstddef>\n"
+        << "#include <string>\n"
+        << "#include <string_view>\n"
+        << "#include <vector>\n\n"
+        << "#include \"TemplatePrecompiler.h\"\n\n"
+        << "namespace " << detail << " {\n";
+
+    std::size_t index = 0;
+    for (const auto& pair : latest) {
+        const BundleRecord& record = records[pair.second];
+        const std::string key = record.project_name + "/" + record.file_path;
+        auto partials = [&](std::string_view partial_path) -> std::string_view {
+            auto found = latest.find({record.project_name, partial_path});
+            if (found == latest.end()) {
+                throw std::invalid_argument(key + " includes unknown partial '" + std::string(partial_path) + "'");
+            }
+            return records[found->second].content;
+        };
+        TemplateProgram program = TemplateProgram::compile(record.content, partials);
+        for (const std::string& token : program.unresolved()) {
+            report.unresolved.push_back(key + ": " + token);
+        }
+        const std::string prefix = "t" + std::to_string(index) + "_";
+
+        out << "\n// " << key << "\n";
+        std::vector<Operand> operands(program.code().size());
+        std::size_t literal_count = 0;
+        bool reads_config = false;
+        bool writes = false;
+        for (std::size_t pc = 0; pc < program.code().size(); ++pc) {
+            const TemplateProgram::Instruction& instruction = program.code()[pc];
+            if (instruction.op == Op::Text) {
+                std::string_view text = program.text().substr(instruction.a, instruction.b);
+                std::string name = prefix + "literal" + std::to_string(literal_count++);
+                out << "inline constexpr std::string_view " << name << " = "
+                    << GeneratedSource::viewLiteral(text, true) << ";\n";
+                operands[pc] = {name, text.size(), false};
+            } else if (instruction.op == Op::Field) {
+                operands[pc] = {"config." + std::string(kProjectConfigFields[instruction.a].member), 0, true};
+            }
+            if (instruction.op == Op::JumpIfNot || instruction.op == Op::JumpIf) {
+                conditions.insert(instruction.a);
+            }
+            reads_config |= instruction.op != Op::Text && instruction.op != Op::Jump;
+            writes |= instruction.op == Op::Text || instruction.op == Op::Field || instruction.op == Op::Item;
+        }
+
+        // Parameters a function does not read stay unnamed, so generated code
+        // compiles cleanly with -Wunused-parameter.
+        const std::string config_parameter = reads_config ? "const ProjectConfig& config" : "const ProjectConfig&";
+        const std::string sink_parameter = writes ? "TemplateSink& sink" : "TemplateSink&";
+
+        // The reservation is exact for templates without logic and covers
+        // every branch otherwise; only loop elements can grow the string.
+        std::size_t literal_size = 0;
+        for (const Operand& operand : operands) {
+            literal_size += operand.literal_bytes;
+        }
+        std::vector<std::pair<std::string, std::size_t>> field_uses;  // In order of first use
+        for (const Operand& operand : operands) {
+            if (operand.field) {
+                auto use = std::find_if(field_uses.begin(), field_uses.end(),
+                                        [&operand](const auto& counted) { return counted.first == operand.expression; });
+                if (use == field_uses.end()) {
+                    field_uses.push_back({operand.expression, 1});
+                } else {
+                    ++use->second;
+                }
+            }
+        }
+        out << "\ninline std::string render" << index << "(" << config_parameter << ") {\n"
+            << "    std::string out;\n"
+            << "    out.reserve(" << literal_size;
+        for (const auto& use : field_uses) {
+            out << " + " << (use.second > 1 ? std::to_string(use.second) + " * " : "") << use.first << ".size()";
+        }
+        out << ");\n"
+            << lowerProgram(program, operands,
+                            [](const std::string& expression) { return "out.append(" + expression + ");"; }, "")
+            << "    return out;\n}\n";
+
+        out << "\ninline void renderTo" << index << "(" << config_parameter << ", " << sink_parameter << ") {\n"
+            << lowerProgram(program, operands,
+                            [](const std::string& expression) { return "sink.write(" + expression + ");"; },
+                            "    return;\n")
+            << "}\n";
+
+        table << "    {" << GeneratedSource::viewLiteral(record.project_name, false) << ", "
+              << GeneratedSource::viewLiteral(record.file_path, false) << ", &" << detail << "::render" << index
+              << ", &" << detail << "::renderTo" << index << "},\n";
+        ++index;
+    }
+    if (!conditions.empty()) {
+        out << "\n// Conditions are called by index; a reordered table needs a regenerated header.\n";
+        for (std::uint32_t condition : conditions) {
+            out << "static_assert(kProjectConfigConditions[" << condition << "].name == "
+                << GeneratedSource::viewLiteral(kProjectConfigConditions[condition].name, false)
+                << ", \"regenerate this header\");\n";
+        }
+    }
+    out << "\n} // namespace " << detail << "\n\n";
+
+    if (index == 0) {
+        out << "inline constexpr PrecompiledTemplateSet " << symbol << "(nullptr, 0);\n";
+    } else {
+        out << "inline constexpr PrecompiledTemplate " << symbol << "Data[] = {\n" << table.str() << "};\n\n"
+            << "inline constexpr PrecompiledTemplateSet " << symbol << "(" << symbol << "Data, " << index << ");\n";
+    }
+    out << "\n#endif // " << guard << "\n";
+
+    GeneratedSource::writeFile(path, out.str());
+    return report;
+}
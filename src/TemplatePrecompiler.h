@@ -0,0 +1,87 @@
+#ifndef TEMPLATE_PRECOMPILER_H
+#define TEMPLATE_PRECOMPILER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ProjectConfig.h"
+#include "TemplateSink.h"
+#include "TemplateBundle.h"
+
+/**
+ * @brief A template compiled to C++ by template_precompiler.
+ * Both functions write the template's literal text with every placeholder
+ * resolved to a ProjectConfig field and every branch and loop turned into
+ * control flow; nothing is looked up or interpreted at render time.
+ */
+struct PrecompiledTemplate {
+    std::string_view project_name;
+    std::string_view file_path;
+    std::string (*render)(const ProjectConfig& config);                  ///< Pre-sized; one allocation unless a loop outgrows it
+    void (*renderTo)(const ProjectConfig& config, TemplateSink& sink);   ///< Segment by segment
+};
+
+/**
+ * @brief The precompiled templates of a generated header (see PrecompiledTemplates.h).
+ */
+class PrecompiledTemplateSet {
+public:
+    constexpr PrecompiledTemplateSet(const PrecompiledTemplate* templates, std::size_t count)
+        : templates_(templates), count_(count) {}
+
+    constexpr std::size_t size() const { return count_; }
+    constexpr const PrecompiledTemplate& operator[](std::size_t index) const { return templates_[index]; }
+
+    /**
+     * @brief Looks up a template. The set only holds the handful of built-in
+     * templates, so a linear scan is enough.
+     * @return The template, or nullptr if it was not precompiled.
+     */
+    constexpr const PrecompiledTemplate* find(std::string_view project_name, std::string_view file_path) const {
+        for (std::size_t i = 0; i < count_; ++i) {
+            if (templates_[i].file_path == file_path && templates_[i].project_name == project_name) {
+                return &templates_[i];
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    const PrecompiledTemplate* templates_;
+    std::size_t count_;
+};
+
+/**
+ * @brief What writePrecompiledTemplates() could not resolve at build time.
+ */
+struct PrecompileReport {
+    std::vector<std::string> unresolved;   ///< Placeholders that matched no field, as "project/path: {{name}}"
+};
+
+/**
+ * @brief Writes a C++ header with one pair of render functions per template.
+ *
+ * Each template is first compiled to a TemplateProgram, with `{{> path}}`
+ * partials resolved among the records of the same project, and its bytecode
+ * is then lowered to C++ one instruction at a time: each field becomes a
+ * direct read of its ProjectConfig member, literal text becomes string
+ * constants, conditions become calls of their kProjectConfigConditions
+ * test, and jumps and loops become gotos, so the generated functions
+ * produce exactly what TemplateProgram::render does. Placeholders that name
+ * no field are kept as literal text, exactly as CompiledTemplate renders a
+ * token that has no substitution. When several records share a
+ * (project_name, file_path) key the last one wins.
+ * @param path The header to write; its file name also gives the include guard.
+ * @param records The templates to compile; content must already be unescaped.
+ * @param symbol Name of the PrecompiledTemplateSet constant, e.g. "kPrecompiledTemplates".
+ * @param source Where the templates came from, for the header comment.
+ * @return The unresolved placeholders, for reporting.
+ * @throws std::invalid_argument if a template does not compile or includes a partial not in `records`.
+ * @throws std::runtime_error if the header cannot be written.
+ */
+PrecompileReport writePrecompiledTemplates(const std::string& path, const std::vector<BundleRecord>& records,
+                                          const std::string& symbol, const std::string& source);
+
+#endif // TEMPLATE_PRECOMPILER_H
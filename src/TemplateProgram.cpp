@@ -0,0 +1,305 @@
+#include "TemplateProgram.h"
+#include "CompiledTemplate.h"
+#include "TemplateSink.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+    std::size_t begin = text.find_first_not_of(" \t");
+    if (begin == std::string_view::npos) {
+        return std::string_view();
+    }
+    std::size_t end = text.find_last_not_of(" \t");
+    return text.substr(begin, end + 1 - begin);
+}
+
+// Splits "keyword argument" at the first space.
+std::pair<std::string_view, std::string_view> splitTag(std::string_view tag) {
+    std::size_t space = tag.find_first_of(" \t");
+    if (space == std::string_view::npos) {
+        return {tag, std::string_view()};
+    }
+    return {tag.substr(0, space), trim(tag.substr(space))};
+}
+
+} // namespace
+
+/**
+ * Turns template source into TemplateProgram bytecode. Open blocks are kept
+ * on a stack with the jumps that still need a target; a block's jumps are
+ * patched when its `{{else}}` or closing tag is reached.
+ */
+class TemplateProgramCompiler {
+public:
+    using Op = TemplateProgram::Op;
+
+    TemplateProgramCompiler(TemplateProgram& program, const TemplateProgram::PartialResolver& partials)
+        : program_(program), partials_(partials) {}
+
+    void compile(std::string_view source, std::size_t depth) {
+        // A partial may only close blocks it opened itself.
+        const std::size_t outer_floor = floor_;
+        floor_ = blocks_.size();
+        CompiledTemplate tokens = CompiledTemplate::compile(source);
+        for (const CompiledTemplate::Segment& segment : tokens.segments()) {
+            if (segment.kind == CompiledTemplate::Segment::Kind::Literal) {
+                emitText(segment.text);
+            } else {
+                compileTag(segment.text, depth);
+            }
+        }
+        if (blocks_.size() != floor_) {
+            fail("{{#" + std::string(blocks_.back().keyword) + "}} is never closed");
+        }
+        floor_ = outer_floor;
+    }
+
+private:
+    struct Block {
+        std::string_view keyword;            // "if", "unless" or "each"
+        std::size_t branch;                  // Pending JumpIfNot/JumpIf/EachBegin, or npos after {{else}}
+        std::vector<std::size_t> exits;      // Jumps to the end of the block
+    };
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    TemplateProgram& program_;
+    const TemplateProgram::PartialResolver& partials_;
+    std::vector<Block> blocks_;
+    std::size_t floor_ = 0;  // Blocks below this index belong to an enclosing template
+    std::size_t loop_depth_ = 0;
+    std::size_t label_ = 0;  // Text emitted before this instruction may not be extended
+
+    [[noreturn]] static void fail(const std::string& message) {
+        throw std::invalid_argument("Template program: " + message);
+    }
+
+    std::uint32_t here() const { return static_cast<std::uint32_t>(program_.code_.size()); }
+
+    std::size_t emit(Op op, std::size_t a = 0, std::size_t b = 0) {
+        program_.code_.push_back({op, static_cast<std::uint32_t>(a), static_cast<std::uint32_t>(b)});
+        return program_.code_.size() - 1;
+    }
+
+    // Makes the next instruction a jump target, so that no later text is
+    // merged into an instruction the jump would skip.
+    std::uint32_t label() {
+        label_ = program_.code_.size();
+        return here();
+    }
+
+    void patch(std::size_t instruction) { program_.code_[instruction].b = label(); }
+
+    void emitText(std::string_view text) {
+        if (text.empty()) {
+            return;
+        }
+        std::vector<TemplateProgram::Instruction>& code = program_.code_;
+        const std::size_t offset = program_.text_.size();
+        program_.text_.append(text);
+        if (code.size() > label_ && code.back().op == Op::Text) {
+            code.back().b += static_cast<std::uint32_t>(text.size());
+        } else {
+            emit(Op::Text, offset, text.size());
+        }
+    }
+
+    std::size_t condition(std::string_view name) const {
+        const ProjectConfigCondition* found = findProjectConfigCondition(name);
+        if (!found) {
+            fail("unknown condition '" + std::string(name) + "'");
+        }
+        return static_cast<std::size_t>(found - kProjectConfigConditions);
+    }
+
+    Block& innermost(std::string_view closing) {
+        if (blocks_.size() == floor_) {
+            fail("{{" + std::string(closing) + "}} without an open block");
+        }
+        return blocks_.back();
+    }
+
+    void compileTag(std::string_view token, std::size_t depth) {
+        const std::string_view tag = token.substr(2, token.size() - 4);
+        if (tag.empty()) {
+            emitText(token);
+            return;
+        }
+
+        if (tag[0] == '#') {
+            auto [keyword, argument] = splitTag(tag.substr(1));
+            if (keyword == "if") {
+                blocks_.push_back({"if", emit(Op::JumpIfNot, condition(argument)), {}});
+            } else if (keyword == "unless") {
+                blocks_.push_back({"unless", emit(Op::JumpIf, condition(argument)), {}});
+            } else if (keyword == "each") {
+                const ProjectConfigList* list = findProjectConfigList(argument);
+                if (!list) {
+                    fail("unknown list '" + std::string(argument) + "'");
+                }
+                if (loop_depth_ == TemplateProgram::kMaxLoopDepth) {
+                    fail("loops nested more than " + std::to_string(TemplateProgram::kMaxLoopDepth) + " deep");
+                }
+                blocks_.push_back({"each", emit(Op::EachBegin, list - kProjectConfigLists), {}});
+                ++loop_depth_;
+                label();
+            } else {
+                fail("unknown block " + std::string(token));
+            }
+            return;
+        }
+
+        if (tag[0] == '/') {
+            Block& block = innermost(tag);
+            if (trim(tag.substr(1)) != block.keyword) {
+                fail(std::string(token) + " closes {{#" + std::string(block.keyword) + "}}");
+            }
+            if (block.keyword == "each") {
+                emit(Op::EachNext, 0, block.branch + 1);
+                --loop_depth_;
+            }
+            if (block.branch != npos) {
+                patch(block.branch);
+            }
+            for (std::size_t exit : block.exits) {
+                patch(exit);
+            }
+            blocks_.pop_back();
+            return;
+        }
+
+        auto [keyword, argument] = splitTag(tag);
+        if (keyword == "else") {
+            Block& block = innermost(tag);
+            if (block.keyword == "each" || block.branch == npos) {
+                fail("unexpected " + std::string(token));
+            }
+            block.exits.push_back(emit(Op::Jump));
+            patch(block.branch);
+            block.branch = npos;
+            if (!argument.empty()) {
+                auto [chained, name] = splitTag(argument);
+                if (chained != "if" || block.keyword != "if") {
+                    fail("unexpected " + std::string(token));
+                }
+                block.branch = emit(Op::JumpIfNot, condition(name));
+            }
+            return;
+        }
+
+        if (tag[0] == '>') {
+            const std::string_view path = trim(tag.substr(1));
+            if (!partials_) {
+                fail("no resolver for partial '" + std::string(path) + "'");
+            }
+            if (depth == TemplateProgram::kMaxPartialDepth) {
+                fail("partials nested more than " + std::to_string(TemplateProgram::kMaxPartialDepth) +
+                     " deep at '" + std::string(path) + "'; do they include each other?");
+            }
+            compile(partials_(path), depth + 1);
+            return;
+        }
+
+        if (tag == "this") {
+            if (loop_depth_ == 0) {
+                fail("{{this}} outside {{#each}}");
+            }
+            emit(Op::Item);
+            return;
+        }
+
+        if (const ProjectConfigField* field = findProjectConfigField(tag)) {
+            emit(Op::Field, static_cast<std::size_t>(field - kProjectConfigFields));
+            return;
+        }
+        std::vector<std::string>& unresolved = program_.unresolved_;
+        if (std::find(unresolved.begin(), unresolved.end(), token) == unresolved.end()) {
+            unresolved.emplace_back(token);
+        }
+        emitText(token);
+    }
+};
+
+TemplateProgram TemplateProgram::compile(std::string_view source, const PartialResolver& partials) {
+    TemplateProgram program;
+    TemplateProgramCompiler(program, partials).compile(source, 0);
+    return program;
+}
+
+template <typename Write>
+void TemplateProgram::run(const ProjectConfig& config, Write&& write) const {
+    struct Loop {
+        const std::vector<std::string>* list;
+        std::size_t index;
+    };
+    Loop loops[kMaxLoopDepth];
+    std::size_t depth = 0;
+
+    const Instruction* code = code_.data();
+    const std::size_t size = code_.size();
+    std::size_t pc = 0;
+    while (pc < size) {
+        const Instruction& instruction = code[pc++];
+        switch (instruction.op) {
+            case Op::Text:
+                write(std::string_view(text_.data() + instruction.a, instruction.b));
+                break;
+            case Op::Field:
+                write(config.*kProjectConfigFields[instruction.a].field);
+                break;
+            case Op::Item:
+                write((*loops[depth - 1].list)[loops[depth - 1].index]);
+                break;
+            case Op::JumpIfNot:
+                if (!kProjectConfigConditions[instruction.a].test(config)) {
+                    pc = instruction.b;
+                }
+                break;
+            case Op::JumpIf:
+                if (kProjectConfigConditions[instruction.a].test(config)) {
+                    pc = instruction.b;
+                }
+                break;
+            case Op::Jump:
+                pc = instruction.b;
+                break;
+            case Op::EachBegin: {
+                const std::vector<std::string>& list = config.*kProjectConfigLists[instruction.a].list;
+                if (list.empty()) {
+                    pc = instruction.b;
+                } else {
+                    loops[depth++] = {&list, 0};
+                }
+                break;
+            }
+            case Op::EachNext: {
+                Loop& loop = loops[depth - 1];
+                if (++loop.index < loop.list->size()) {
+                    pc = instruction.b;
+                } else {
+                    --depth;
+                }
+                break;
+            }
+        }
+    }
+}
+
+std::string TemplateProgram::render(const ProjectConfig& config) const {
+    std::string out;
+    out.reserve(text_.size());
+    run(config, [&out](std::string_view piece) { out.append(piece); });
+    return out;
+}
+
+void TemplateProgram::renderTo(const ProjectConfig& config, TemplateSink& sink) const {
+    run(config, [&sink](std::string_view piece) { sink.write(piece); });
+}
+
+bool TemplateProgram::isFlat() const {
+    return std::all_of(code_.begin(), code_.end(), [](const Instruction& instruction) {
+        return instruction.op == Op::Text || instruction.op == Op::Field;
+    });
+}
@@ -0,0 +1,116 @@
+#ifndef TEMPLATE_PROGRAM_H
+#define TEMPLATE_PROGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ProjectConfig.h"
+
+class TemplateSink;
+
+/**
+ * @brief A template with logic, compiled to bytecode over ProjectConfig.
+ *
+ * On top of `{{name}}` placeholders (resolved through kProjectConfigFields)
+ * the language has:
+ *
+ *   {{#if cond}} ... {{else if cond}} ... {{else}} ... {{/if}}
+ *   {{#unless cond}} ... {{else}} ... {{/unless}}
+ *   {{#each list}} ... {{this}} ... {{/each}}
+ *   {{> path}}
+ *
+ * Conditions are the names in kProjectConfigConditions and lists those in
+ * kProjectConfigLists. `{{> path}}` inlines another template, found through
+ * the resolver passed to compile(), so partials cost nothing at render time.
+ * Templates from a TemplateLoader should be compiled with
+ * TemplateLoader::getProgram(), which validates includes as the loader's
+ * other renders do; kMaxPartialDepth only stops resolvers that do not.
+ * Tags are replaced exactly; no whitespace around them is trimmed.
+ *
+ * Names, conditions and lists are resolved to table indices when the
+ * template is compiled and adjacent literal text is merged into one
+ * instruction, so rendering is a single loop over a flat instruction array
+ * with no lookups and no allocation beyond the output itself. A program
+ * owns its literal text and does not refer to the source after compile().
+ */
+class TemplateProgram {
+public:
+    enum class Op : std::uint8_t {
+        Text,       ///< Write text bytes [a, a + b)
+        Field,      ///< Write the kProjectConfigFields[a] member
+        Item,       ///< Write the current element of the innermost loop
+        JumpIfNot,  ///< Jump to b unless kProjectConfigConditions[a] holds
+        JumpIf,     ///< Jump to b if kProjectConfigConditions[a] holds
+        Jump,       ///< Jump to b
+        EachBegin,  ///< Start a loop over kProjectConfigLists[a]; jump to b if it is empty
+        EachNext,   ///< Advance the innermost loop; jump back to b while elements remain
+    };
+
+    struct Instruction {
+        Op op;
+        std::uint32_t a;
+        std::uint32_t b;
+    };
+
+    /**
+     * @brief Returns the source of the template named by a `{{> path}}` tag.
+     * The view only needs to stay valid until compile() returns; a resolver
+     * signals an unknown partial by throwing.
+     */
+    using PartialResolver = std::function<std::string_view(std::string_view path)>;
+
+    static constexpr std::size_t kMaxPartialDepth = 16;  ///< Deeper nesting is taken to be a cycle
+    static constexpr std::size_t kMaxLoopDepth = 8;
+
+    TemplateProgram() = default;
+
+    /**
+     * @brief Compiles a template body, inlining its partials.
+     * Placeholders that name no field are kept as literal text, as
+     * CompiledTemplate does for a token without a substitution.
+     * @param partials Resolves `{{> path}}` tags; may be empty if the template has none.
+     * @throws std::invalid_argument on unbalanced or unknown block tags, unknown
+     *         conditions or lists, `{{this}}` outside a loop, a partial without
+     *         a resolver, or partials nested deeper than kMaxPartialDepth.
+     */
+    static TemplateProgram compile(std::string_view source, const PartialResolver& partials = PartialResolver());
+
+    /**
+     * @brief Runs the program and returns the output.
+     */
+    std::string render(const ProjectConfig& config) const;
+
+    /**
+     * @brief Runs the program, writing each piece of output to a sink.
+     */
+    void renderTo(const ProjectConfig& config, TemplateSink& sink) const;
+
+    const std::vector<Instruction>& code() const { return code_; }
+    std::string_view text() const { return text_; }
+
+    /**
+     * @brief Whether the program only writes text and fields, i.e. has no branches or loops.
+     */
+    bool isFlat() const;
+
+    /**
+     * @brief The `{{name}}` tokens that matched no field, in order of first use.
+     */
+    const std::vector<std::string>& unresolved() const { return unresolved_; }
+
+private:
+    std::vector<Instruction> code_;
+    std::string text_;
+    std::vector<std::string> unresolved_;
+
+    template <typename Write>
+    void run(const ProjectConfig& config, Write&& write) const;
+
+    friend class TemplateProgramCompiler;
+};
+
+#endif // TEMPLATE_PROGRAM_H
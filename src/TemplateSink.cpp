@@ -0,0 +1,77 @@
+#include "TemplateSink.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+void OstreamSink::write(std::string_view chunk) {
+    out_.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    if (!out_) {
+        throw std::runtime_error("Failed to write rendered template to stream");
+    }
+}
+
+void OstreamSink::flush() {
+    out_.flush();
+}
+
+FdSink::~FdSink() {
+    try {
+        flush();
+    } catch (...) {
+        // Destructors must not throw; callers that care call flush() themselves.
+    }
+}
+
+void FdSink::write(std::string_view chunk) {
+    if (chunk.size() >= kBufferSize) {
+        flush();
+        writeAll(chunk.data(), chunk.size());
+        return;
+    }
+    if (used_ + chunk.size() > kBufferSize) {
+        flush();
+    }
+    std::memcpy(buffer_ + used_, chunk.data(), chunk.size());
+    used_ += chunk.size();
+}
+
+void FdSink::flush() {
+    if (used_ > 0) {
+        std::size_t pending = used_;
+        used_ = 0;
+        writeAll(buffer_, pending);
+    }
+}
+
+void FdSink::writeAll(const char* data, std::size_t length) {
+    while (length > 0) {
+#ifdef _WIN32
+        int written = ::_write(fd_, data, static_cast<unsigned int>(length));
+#else
+        ssize_t written = ::write(fd_, data, length);
+#endif
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string("Failed to write rendered template: ") + std::strerror(errno));
+        }
+        data += written;
+        length -= static_cast<std::size_t>(written);
+    }
+}
+
+void BufferSink::write(std::string_view chunk) {
+    if (size_ < capacity_) {
+        std::size_t room = capacity_ - size_;
+        std::size_t count = chunk.size() < room ? chunk.size() : room;
+        std::memcpy(buffer_ + size_, chunk.data(), count);
+    }
+    size_ += chunk.size();
+}
@@ -0,0 +1,93 @@
+#ifndef TEMPLATE_SINK_H
+#define TEMPLATE_SINK_H
+
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <cstddef>
+
+/**
+ * @brief Destination for rendered template output.
+ *
+ * Rendering writes a template segment by segment, so a sink sees many small
+ * writes and never the whole output at once.
+ */
+class TemplateSink {
+public:
+    virtual ~TemplateSink() = default;
+
+    /**
+     * @brief Appends a chunk of rendered output.
+     * @throws std::runtime_error if the underlying destination fails.
+     */
+    virtual void write(std::string_view chunk) = 0;
+
+    /**
+     * @brief Pushes any buffered output to the underlying destination.
+     */
+    virtual void flush() {}
+};
+
+/**
+ * @brief Writes rendered output to a std::ostream.
+ */
+class OstreamSink : public TemplateSink {
+public:
+    explicit OstreamSink(std::ostream& out) : out_(out) {}
+
+    void write(std::string_view chunk) override;
+    void flush() override;
+
+private:
+    std::ostream& out_;
+};
+
+/**
+ * @brief Writes rendered output to a POSIX file descriptor through a small buffer.
+ * The descriptor is not closed by the sink. Output still buffered when the
+ * sink is destroyed is flushed, but errors at that point are ignored; call
+ * flush() explicitly to observe them.
+ */
+class FdSink : public TemplateSink {
+public:
+    explicit FdSink(int fd) : fd_(fd) {}
+    ~FdSink() override;
+
+    FdSink(const FdSink&) = delete;
+    FdSink& operator=(const FdSink&) = delete;
+
+    void write(std::string_view chunk) override;
+    void flush() override;
+
+private:
+    static constexpr std::size_t kBufferSize = 64 * 1024;
+
+    int fd_;
+    std::size_t used_ = 0;
+    char buffer_[kBufferSize];
+
+    void writeAll(const char* data, std::size_t length);
+};
+
+/**
+ * @brief Writes rendered output into a caller-provided buffer.
+ * Output that does not fit is dropped, but size() keeps counting, so a
+ * truncated render reports exactly how large the buffer needs to be.
+ */
+class BufferSink : public TemplateSink {
+public:
+    BufferSink(char* buffer, std::size_t capacity) : buffer_(buffer), capacity_(capacity) {}
+
+    void write(std::string_view chunk) override;
+
+    std::size_t size() const { return size_; }
+    bool truncated() const { return size_ > capacity_; }
+    std::string_view view() const { return std::string_view(buffer_, size_ < capacity_ ? size_ : capacity_); }
+
+private:
+    char* buffer_;
+    std::size_t capacity_;
+    std::size_t size_ = 0;
+};
+
+#endif // TEMPLATE_SINK_H
@@ -0,0 +1,98 @@
+#include "TextArena.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+TextArena::TextArena(std::size_t block_size) : block_size_(std::max<std::size_t>(block_size, 1)) {}
+
+TextArena::~TextArena() = default;
+
+TextBuilder TextArena::builder(std::size_t size_hint) {
+    if (building_) {
+        throw std::logic_error("TextArena: a builder is already in progress");
+    }
+    if (blocks_.empty() || blocks_.back().size - used_ < size_hint) {
+        addBlock(size_hint);
+    }
+    building_ = true;
+    Block& block = blocks_.back();
+    return TextBuilder(*this, block.data.get() + used_, block.size - used_);
+}
+
+void TextArena::clear() {
+    if (building_) {
+        throw std::logic_error("TextArena: cannot clear while a builder is in progress");
+    }
+    if (blocks_.size() > 1) {
+        blocks_.erase(blocks_.begin() + 1, blocks_.end());
+    }
+    used_ = 0;
+}
+
+std::size_t TextArena::bytes() const {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i + 1 < blocks_.size(); ++i) {
+        total += blocks_[i].size;
+    }
+    return blocks_.empty() ? 0 : total + used_;
+}
+
+void TextArena::addBlock(std::size_t at_least) {
+    Block block;
+    block.size = std::max(block_size_, at_least);
+    block.data.reset(new char[block.size]);
+    blocks_.push_back(std::move(block));
+    used_ = 0;
+}
+
+TextBuilder::~TextBuilder() {
+    if (arena_) {
+        arena_->building_ = false;
+    }
+}
+
+char* TextBuilder::reserve(std::size_t count) {
+    if (capacity_ - length_ < count) {
+        // The text so far is the unfinished tail of the last block; copy it
+        // to the start of a new one. The space it leaves is not reused.
+        const char* old = start_;
+        arena_->addBlock(2 * (length_ + count));
+        TextArena::Block& block = arena_->blocks_.back();
+        std::memcpy(block.data.get(), old, length_);
+        start_ = block.data.get();
+        capacity_ = block.size;
+    }
+    return start_ + length_;
+}
+
+TextBuilder& TextBuilder::append(std::string_view text) {
+    std::memcpy(reserve(text.size()), text.data(), text.size());
+    length_ += text.size();
+    return *this;
+}
+
+TextBuilder& TextBuilder::appendUpper(std::string_view text) {
+    char* out = reserve(text.size());
+    for (char c : text) {
+        *out++ = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    length_ += text.size();
+    return *this;
+}
+
+TextBuilder& TextBuilder::appendLower(std::string_view text) {
+    char* out = reserve(text.size());
+    for (char c : text) {
+        *out++ = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    length_ += text.size();
+    return *this;
+}
+
+std::string_view TextBuilder::finish() {
+    arena_->used_ += length_;
+    arena_->building_ = false;
+    arena_ = nullptr;
+    return std::string_view(start_, length_);
+}
@@ -0,0 +1,111 @@
+#ifndef TEXT_ARENA_H
+#define TEXT_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+class TextBuilder;
+
+/**
+ * @brief Append-only storage for generated text, released all at once.
+ *
+ * Text is built with a TextBuilder, one builder at a time, at the end of the
+ * arena's current block. Blocks are at least kDefaultBlockSize bytes, so a
+ * whole generated project usually fits in one allocation instead of taking
+ * one or more for every `+` of a std::string chain. Views returned by
+ * TextBuilder::finish() stay valid until clear() or the arena's destruction.
+ */
+class TextArena {
+public:
+    static constexpr std::size_t kDefaultBlockSize = 64 * 1024;
+
+    explicit TextArena(std::size_t block_size = kDefaultBlockSize);
+    ~TextArena();
+
+    TextArena(const TextArena&) = delete;
+    TextArena& operator=(const TextArena&) = delete;
+
+    /**
+     * @brief Starts a new text at the end of the arena.
+     * @param size_hint Expected length. If the current block has less room, a
+     *        new block is started up front rather than when the text outgrows it.
+     * @throws std::logic_error if another builder of this arena is unfinished.
+     */
+    TextBuilder builder(std::size_t size_hint = 0);
+
+    /**
+     * @brief Forgets all text, keeping the first block for reuse.
+     * @throws std::logic_error if a builder is unfinished.
+     */
+    void clear();
+
+    std::size_t blocks() const { return blocks_.size(); }  ///< Blocks held, one allocation each
+    std::size_t bytes() const;                             ///< Block bytes up to the end of the last finished text
+
+private:
+    friend class TextBuilder;
+
+    struct Block {
+        std::unique_ptr<char[]> data;
+        std::size_t size = 0;
+    };
+
+    std::vector<Block> blocks_;
+    std::size_t used_ = 0;  // Bytes finished in blocks_.back()
+    std::size_t block_size_;
+    bool building_ = false;
+
+    void addBlock(std::size_t at_least);
+};
+
+/**
+ * @brief Appends text to the end of a TextArena.
+ *
+ * The text is contiguous: if it outgrows the room left in the block, it is
+ * moved once to a new block of at least twice its size. A builder that is
+ * destroyed without finish() leaves nothing behind.
+ */
+class TextBuilder {
+public:
+    ~TextBuilder();
+
+    TextBuilder(const TextBuilder&) = delete;
+    TextBuilder& operator=(const TextBuilder&) = delete;
+
+    TextBuilder& append(std::string_view text);
+    TextBuilder& operator<<(std::string_view text) { return append(text); }
+    TextBuilder& operator<<(char c) { return append(std::string_view(&c, 1)); }
+
+    /**
+     * @brief Appends `text` with ASCII letters converted, like StringUtils::toUpper/toLower.
+     */
+    TextBuilder& appendUpper(std::string_view text);
+    TextBuilder& appendLower(std::string_view text);
+
+    std::size_t size() const { return length_; }
+    std::string_view view() const { return std::string_view(start_, length_); }
+
+    /**
+     * @brief Keeps the text in the arena and returns it. Nothing may be
+     * appended afterwards.
+     */
+    std::string_view finish();
+
+private:
+    friend class TextArena;
+
+    TextArena* arena_;
+    char* start_;
+    std::size_t length_ = 0;
+    std::size_t capacity_;
+
+    TextBuilder(TextArena& arena, char* start, std::size_t capacity)
+        : arena_(&arena), start_(start), capacity_(capacity) {}
+
+    // Returns where the next `count` bytes go, moving the text if it must.
+    char* reserve(std::size_t count);
+};
+
+#endif // TEXT_ARENA_H
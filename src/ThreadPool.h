@@ -0,0 +1,65 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Fixed-size pool of worker threads that run submitted tasks in FIFO order.
+ *
+ * The destructor finishes every task that was already submitted, then joins
+ * the workers. An exception thrown by a task is delivered through the
+ * future that submit() returned.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Starts the workers.
+     * @param threads Number of workers; 0 uses the hardware concurrency.
+     */
+    explicit ThreadPool(std::size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queues a task.
+     * @return A future for the task's result.
+     */
+    template <typename Task>
+    std::future<std::invoke_result_t<std::decay_t<Task>>> submit(Task&& task) {
+        using Result = std::invoke_result_t<std::decay_t<Task>>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+        std::future<Result> result = packaged->get_future();
+        enqueue([packaged]() { (*packaged)(); });
+        return result;
+    }
+
+    std::size_t size() const { return workers_.size(); }
+
+    /**
+     * @brief The worker count used for a requested count of 0.
+     */
+    static std::size_t defaultThreadCount();
+
+private:
+    void enqueue(std::function<void()> job);
+    void workerLoop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> jobs_;
+    std::mutex mutex_;
+    std::condition_variable available_;
+    bool stopping_ = false;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,43 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "TemplateLoader.h"
+#include "TemplateBundle.h"
+#include "EmbeddedTemplates.h"
+
+/**
+ * Template Embedder
+ *
+ * Compiles a template SQL file into a C++ header of constexpr tables with a
+ * perfect-hash index, so template_generator carries its default templates
+ * in the binary and needs no I/O or parsing to find them:
+ *
+ *   template_embedder [input.sql] [output.h] [symbol]
+ *
+ * Defaults to SQL/data.sql -> src/DefaultTemplates.h, defining
+ * kDefaultTemplates. Rerun it whenever the SQL changes; build_all does so
+ * before building template_generator.
+ */
+
+int main(int argc, char* argv[]) {
+    try {
+        std::string input = argc > 1 ? argv[1] : "SQL/data.sql";
+        std::string output = argc > 2 ? argv[2] : "src/DefaultTemplates.h";
+        std::string symbol = argc > 3 ? argv[3] : "kDefaultTemplates";
+
+        TemplateLoader loader(input);
+        std::vector<BundleRecord> records;
+        loader.forEachTemplate([&records](std::string_view project_name, std::string_view file_path, std::string_view content) {
+            records.push_back({std::string(project_name), std::string(file_path), std::string(content)});
+        });
+
+        writeEmbeddedTemplates(output, records, symbol, input);
+        std::cout << "Embedded " << records.size() << " template(s) from " << input << " into " << output
+                  << " as " << symbol << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -1,14 +1,33 @@
 #include <iostream>
-#include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 #include <filesystem>
 #include <map>
+#include <memory>
+#include <set>
 #include <cstddef>
 #include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <future>
+#include <stdexcept>
 
+#include "OutputPlan.h"
+#include "ProjectConfig.h"
+#include "ProjectManifest.h"
+#include "TarWriter.h"
 #include "TemplateLoader.h"
+#include "TemplateProgram.h"
+#include "TextArena.h"
+#include "ThreadPool.h"
+#include "DefaultTemplates.h"
+#include "PrecompiledTemplates.h"
 
 namespace fs = std::filesystem;
 
@@ -58,62 +77,117 @@ std::string escapeSql(const std::string& input) {
 }
 } // namespace StringUtils
 
-// Project template types
-enum class ProjectType {
-    CONSOLE_APP,
-    STATIC_LIBRARY,
-    SHARED_LIBRARY,
-    HEADER_ONLY,
-    GUI_APP,
-    UNIT_TEST
-};
-
-struct ProjectConfig {
-    std::string name;
-    std::string className;
-    std::string description;
-    std::string goal;
-    std::string author;
-    std::string version;
-    ProjectType type;
-    bool useCMake;
-    bool includeTests;
-    bool includeGitIgnore;
-    bool includeLikertScale;
-    bool includeDataDictionary;
-    bool includePrivacyPolicy;
-    std::vector<std::string> dependencies;
-};
-
 class TemplateGenerator {
 private:
     const ProjectConfig& config_;
     const TemplateLoader& loader_;
+    TarWriter* archive_;
     
+    OutputPlan plan_;
+    TextArena arena_;
+
+    // Generation only records directories and files in plan_; they are
+    // created and written by generateProject once the plan is complete.
     void createDirectory(const std::string& path) {
-        if (!fs::exists(path)) {
-            fs::create_directories(path);
-            std::cout << "Created directory: " << path << std::endl;
-        }
+        plan_.addDirectory(path);
     }
 
-    void writeFile(const std::string& filename, const std::string& content) {
-        std::ofstream file(filename);
-        if (file.is_open()) {
-            file << content;
-            std::cout << "Generated: " << filename << std::endl;
+    // Generated text is built in arena_ and borrowed by the plan, so a
+    // project's files share one allocation instead of a string each.
+    void writeFile(const std::string& filename, TextBuilder& content) {
+        plan_.addBorrowedFile(filename, content.finish());
+    }
+
+    // A generous estimate of a file's size: its fixed text, the class name
+    // `class_names` times, and every free-text answer once.
+    std::size_t sizeHint(std::size_t literal_bytes, std::size_t class_names) const {
+        return literal_bytes + class_names * config_.className.size() + 4 * config_.name.size() +
+               config_.description.size() + config_.goal.size() + config_.author.size() + config_.version.size();
+    }
+
+    // Streams a loader template straight into the file without building the
+    // rendered content in memory first. Every built-in template, branches,
+    // loops and partials included, is also compiled to C++ (see
+    // template_precompiler) that fills placeholders straight from config_.
+    // Templates loaded with --templates run as the TemplateProgram the loader
+    // compiled for them, once per loaded snapshot and shared by every project
+    // of a manifest. Rendering happens on an I/O thread of the plan.
+    void writeTemplate(const std::string& filename, const std::string& key) {
+        plan_.addFile(filename, [this, key](TemplateSink& sink) {
+            const PrecompiledTemplate* precompiled =
+                loader_.fromEmbedded() ? kPrecompiledTemplates.find(TemplateLoader::kDefaultProject, key) : nullptr;
+            if (precompiled) {
+                precompiled->renderTo(config_, sink);
+            } else {
+                loader_.getProgram(TemplateLoader::kDefaultProject, key)->renderTo(config_, sink);
+            }
+        });
+    }
+
+    // Creates the planned directories, writes the planned files and reports
+    // both. Files of an existing project whose content has not changed are
+    // left alone, so regenerating keeps the project's builds incremental.
+    void writePlan(const OutputPlan& plan, double plan_ms) {
+        OutputPlan::Report report = archive_ ? plan.writeArchive(*archive_) : plan.writeIncremental(config_.name);
+        for (const std::string& directory : report.created_directories) {
+            std::cout << (archive_ ? "Archived directory: " : "Created directory: ") << directory << std::endl;
+        }
+        const std::set<std::string> updated(report.updated.begin(), report.updated.end());
+        for (const std::string& file : report.written) {
+            std::cout << (archive_ ? "Archived: " : updated.count(file) ? "Updated: " : "Generated: ") << file
+                      << std::endl;
+        }
+        if (!report.unchanged.empty()) {
+            std::cout << "Unchanged: " << report.unchanged.size() << " file(s)" << std::endl;
+        }
+        for (const std::string& file : report.stale) {
+            std::cout << "No longer generated, left in place: " << file << std::endl;
+        }
+        for (const auto& failure : report.failures) {
+            std::cerr << "Error: Could not create " << failure.first << ": " << failure.second << std::endl;
+        }
+        if (archive_) {
+            std::cout << "\nTiming: plan " << plan_ms << " ms, render " << report.files_ms << " ms, archive "
+                      << report.archive_ms << " ms (" << report.written.size() << " files, " << report.bytes
+                      << " bytes, " << report.io_threads << " render threads)\n";
         } else {
-            std::cerr << "Error: Could not create " << filename << std::endl;
+            std::cout << "\nTiming: plan " << plan_ms << " ms, directories " << report.directories_ms << " ms, files "
+                      << report.files_ms << " ms, sync " << report.sync_ms << " ms (" << report.written.size()
+                      << " files, " << report.bytes << " bytes, "
+                      << (report.unchanged.empty() ? "" : std::to_string(report.unchanged.size()) + " unchanged, ")
+                      << report.io_threads << " I/O threads)\n";
+        }
+        if (!report.failures.empty()) {
+            throw std::runtime_error(std::to_string(report.failures.size()) + " output(s) of project '" +
+                                     config_.name + "' could not be written");
         }
     }
 
 public:
-    TemplateGenerator(const ProjectConfig& config, const TemplateLoader& loader)
-        : config_(config), loader_(loader) {}
+    // With an archive, generateProject() adds the project to it instead of
+    // writing files; the caller finishes the archive.
+    TemplateGenerator(const ProjectConfig& config, const TemplateLoader& loader, TarWriter* archive = nullptr)
+        : config_(config), loader_(loader), archive_(archive) {}
 
     void generateProject() {
         std::cout << "\n=== Generating Project Structure ===\n";
+        auto started = std::chrono::steady_clock::now();
+        OutputPlan plan = planProject();
+        writePlan(plan, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count());
         
+        std::cout << "\nProject '" << config_.name << "' generated successfully!\n";
+        std::cout << "Navigate to the project directory: cd " << config_.name << std::endl;
+    }
+
+    // Records every directory and file of the project without touching the
+    // filesystem. Files rendered from templates are rendered when the plan is
+    // written, and the others are borrowed from arena_, so the generator must
+    // outlive the plan's write() and calling planProject() again invalidates
+    // the previous plan.
+    OutputPlan planProject() {
+        plan_ = OutputPlan();
+        arena_.clear();
+
         // Create project directory
         createDirectory(config_.name);
         
@@ -135,86 +209,85 @@ public:
         generateMainFile();
         generateHeaderFile();
         
-        if (config.type != ProjectType::HEADER_ONLY) {
+        if (config_.type != ProjectType::HEADER_ONLY) {
             generateImplementationFile();
         }
         
-        if (config.useCMake) {
+        if (config_.useCMake) {
             generateCMakeFile();
         } else {
             generateMakefile();
         }
         
-        if (config.includeTests) {
+        if (config_.includeTests) {
             generateTestFile();
         }
         
-        if (config.includeGitIgnore) {
+        if (config_.includeGitIgnore) {
             generateGitIgnore();
         }
         
-        if (config.includeLikertScale) {
-            writeFile(config.name + "/include/LikertScale.h", generateLikertScaleHeader());
-            writeFile(config.name + "/src/LikertScale.cpp", generateLikertScaleImplementation());
+        if (config_.includeLikertScale) {
+            writeTemplate(config_.name + "/include/LikertScale.h", "include/LikertScale.h");
+            generateLikertScaleImplementation();
         }
 
-        if (config.includeDataDictionary) {
-            writeFile(config.name + "/data_dictionary.md", generateDataDictionary());
+        if (config_.includeDataDictionary) {
+            generateDataDictionary();
         }
 
-        if (config.includePrivacyPolicy) {
-            writeFile(config.name + "/PRIVACY_POLICY.md", generatePrivacyPolicy());
+        if (config_.includePrivacyPolicy) {
+            generatePrivacyPolicy();
         }
 
         generateReadme();
         generateLicense();
-        
-        std::cout << "\nProject '" << config_.name << "' generated successfully!\n";
-        std::cout << "Navigate to the project directory: cd " << config_.name << std::endl;
+
+        return std::move(plan_);
     }
     
 private:
     void generateMainFile() {
-        if (config.type == ProjectType::STATIC_LIBRARY || 
-            config.type == ProjectType::SHARED_LIBRARY ||
-            config.type == ProjectType::HEADER_ONLY) {
+        if (config_.type == ProjectType::STATIC_LIBRARY || 
+            config_.type == ProjectType::SHARED_LIBRARY ||
+            config_.type == ProjectType::HEADER_ONLY) {
             return; // Libraries don't need main files
         }
         
-        std::string content;
+        TextBuilder content = arena_.builder(sizeHint(1024, 2));
         std::string filename = config_.name + "/src/main.cpp";
         
         switch (config_.type) {
             case ProjectType::CONSOLE_APP:
-                content = generateConsoleMain();
+                generateConsoleMain(content);
                 break;
             case ProjectType::GUI_APP:
-                content = generateGuiMain();
+                generateGuiMain(content);
                 break;
             case ProjectType::UNIT_TEST:
-                content = generateTestMain();
+                generateTestMain(content);
                 break;
             default:
-                content = generateConsoleMain();
+                generateConsoleMain(content);
         }
         
         writeFile(filename, content);
     }
     
-    std::string generateConsoleMain() {
-        std::string content = "#include <iostream>\n"
-                             "#include \"../include/" + config_.name + ".h\"\n";
+    void generateConsoleMain(TextBuilder& content) {
+        content << "#include <iostream>\n"
+                   "#include \"../include/" << config_.name << ".h\"\n";
 
         if (config_.includeLikertScale) {
-            content += "#include \"../include/LikertScale.h\"\n"
+            content << "#include \"../include/LikertScale.h\"\n"
                        "#include <vector>\n";
         }
 
-        content += "\nint main() {\n"
-                   "    std::cout << \"Launching " + config_.className + " Application...\" << std::endl;\n\n";
+        content << "\nint main() {\n"
+                   "    std::cout << \"Launching " << config_.className << " Application...\" << std::endl;\n\n";
 
         if (config_.includeLikertScale) {
-            content += "    // Example usage of LikertScale\n"
+            content << "    // Example usage of LikertScale\n"
                        "    std::vector<std::string> options = {\n"
                        "        \"Strongly Disagree\",\n"
                        "        \"Disagree\",\n"
@@ -227,536 +300,392 @@ private:
                        "    std::cout << \"\\nYou selected option: \" << response << \" - \" << options[response - 1] << std::endl;\n\n";
         }
 
-        content += "    " + config_.className + " app;\n"
+        content << "    " << config_.className << " app;\n"
                    "    return app.run();\n"
                    "}\n";
-
-        return content;
     }
     
-    std::string generateGuiMain() {
-        return "#include <iostream>\n"
-               "#include \"../include/" + config_.name + ".h\"\n\n"
-               "// TODO: Include GUI framework headers (Qt, GTK, etc.)\n\n"
-               "int main(int argc, char* argv[]) {\n"
-               "    std::cout << \"Launching " + config_.className + " GUI Application...\" << std::endl;\n\n"
-               "    // TODO: Initialize GUI framework\n"
-               "    " + config_.className + " app;\n"
-               "    return app.run();\n"
-               "}\n";
+    void generateGuiMain(TextBuilder& content) {
+        content << "#include <iostream>\n"
+                   "#include \"../include/" << config_.name << ".h\"\n\n"
+                   "// TODO: Include GUI framework headers (Qt, GTK, etc.)\n\n"
+                   "int main(int argc, char* argv[]) {\n"
+                   "    std::cout << \"Launching " << config_.className << " GUI Application...\" << std::endl;\n\n"
+                   "    // TODO: Initialize GUI framework\n"
+                   "    " << config_.className << " app;\n"
+                   "    return app.run();\n"
+                   "}\n";
     }
     
-    std::string generateTestMain() {
-        return "#include <iostream>\n"
-               "#include \"../include/" + config_.name + ".h\"\n\n"
-               "// Simple test runner - consider using Google Test, Catch2, or similar\n"
-               "int main() {\n"
-               "    std::cout << \"Running " + config_.className + " Tests...\" << std::endl;\n\n"
-               "    " + config_.className + "Test test;\n"
-               "    return test.runAllTests();\n"
-               "}\n";
+    void generateTestMain(TextBuilder& content) {
+        content << "#include <iostream>\n"
+                   "#include \"../include/" << config_.name << ".h\"\n\n"
+                   "// Simple test runner - consider using Google Test, Catch2, or similar\n"
+                   "int main() {\n"
+                   "    std::cout << \"Running " << config_.className << " Tests...\" << std::endl;\n\n"
+                   "    " << config_.className << "Test test;\n"
+                   "    return test.runAllTests();\n"
+                   "}\n";
     }
     
     void generateHeaderFile() {
-        std::string guard = StringUtils::toUpper(config_.name) + "_H";
         std::string filename = config_.name + "/include/" + config_.name + ".h";
         
-        std::string content = "#ifndef " + guard + "\n"
-                             "#define " + guard + "\n\n"
-                             "#include <string>\n"
-                             "#include <vector>\n"
-                             "#include <memory>\n\n";
+        TextBuilder content = arena_.builder(sizeHint(1024, 4));
+        content << "#ifndef ";
+        content.appendUpper(config_.name) << "_H\n"
+                   "#define ";
+        content.appendUpper(config_.name) << "_H\n\n"
+                   "#include <string>\n"
+                   "#include <vector>\n"
+                   "#include <memory>\n\n";
         
         if (!config_.description.empty()) {
-            content += "/**\n * " + config_.description + "\n";
+            content << "/**\n * " << config_.description << "\n";
             if (!config_.author.empty()) {
-                content += " * @author " + config_.author + "\n";
+                content << " * @author " << config_.author << "\n";
             }
             if (!config_.version.empty()) {
-                content += " * @version " + config_.version + "\n";
+                content << " * @version " << config_.version << "\n";
             }
-            content += " */\n";
+            content << " */\n";
         }
         
         switch (config_.type) {
             case ProjectType::CONSOLE_APP:
             case ProjectType::GUI_APP:
-                content += generateAppClass();
+                generateAppClass(content);
                 break;
             case ProjectType::STATIC_LIBRARY:
             case ProjectType::SHARED_LIBRARY:
             case ProjectType::HEADER_ONLY:
-                content += generateLibraryClass();
+                generateLibraryClass(content);
                 break;
             case ProjectType::UNIT_TEST:
-                content += generateTestClass();
+                generateTestClass(content);
                 break;
         }
         
-        content += "\n#endif // " + guard + "\n";
+        content << "\n#endif // ";
+        content.appendUpper(config_.name) << "_H\n";
         writeFile(filename, content);
     }
     
-    std::string generateAppClass() {
-        return "class " + config_.className + " {\n"
-               "private:\n"
-               "    std::string appName;\n"
-               "    bool isRunning;\n\n"
-               "public:\n"
-               "    " + config_.className + "();\n"
-               "    ~" + config_.className + "();\n\n"
-               "    int run();\n"
-               "    void shutdown();\n"
-               "    \n"
-               "    // Core functionality\n"
-               "    void initialize();\n"
-               "    void update();\n"
-               "    void cleanup();\n"
-               "};\n";
+    void generateAppClass(TextBuilder& content) {
+        content << "class " << config_.className << " {\n"
+                   "private:\n"
+                   "    std::string appName;\n"
+                   "    bool isRunning;\n\n"
+                   "public:\n"
+                   "    " << config_.className << "();\n"
+                   "    ~" << config_.className << "();\n\n"
+                   "    int run();\n"
+                   "    void shutdown();\n"
+                   "    \n"
+                   "    // Core functionality\n"
+                   "    void initialize();\n"
+                   "    void update();\n"
+                   "    void cleanup();\n"
+                   "};\n";
     }
     
-    std::string generateLibraryClass() {
-        return "class " + config_.className + " {\n"
-               "private:\n"
-               "    // Private members\n\n"
-               "public:\n"
-               "    " + config_.className + "();\n"
-               "    ~" + config_.className + "();\n\n"
-               "    // Public API\n"
-               "    void process();\n"
-               "    std::string getVersion() const;\n"
-               "};\n\n"
-               "// Utility functions\n"
-               "namespace " + StringUtils::toLower(config_.className) + "_utils {\n"
-               "    void helperFunction();\n"
-               "}\n";
+    void generateLibraryClass(TextBuilder& content) {
+        content << "class " << config_.className << " {\n"
+                   "private:\n"
+                   "    // Private members\n\n"
+                   "public:\n"
+                   "    " << config_.className << "();\n"
+                   "    ~" << config_.className << "();\n\n"
+                   "    // Public API\n"
+                   "    void process();\n"
+                   "    std::string getVersion() const;\n"
+                   "};\n\n"
+                   "// Utility functions\n"
+                   "namespace ";
+        content.appendLower(config_.className) << "_utils {\n"
+                   "    void helperFunction();\n"
+                   "}\n";
     }
     
-    std::string generateTestClass() {
-        return "class " + config_.className + "Test {\n"
-               "private:\n"
-               "    int passedTests;\n"
-               "    int failedTests;\n\n"
-               "    void assert(bool condition, const std::string& testName);\n\n"
-               "public:\n"
-               "    " + config_.className + "Test();\n"
-               "    ~" + config_.className + "Test();\n\n"
-               "    int runAllTests();\n"
-               "    void testBasicFunctionality();\n"
-               "    void testEdgeCases();\n"
-               "    void printResults();\n"
-               "};\n";
+    void generateTestClass(TextBuilder& content) {
+        content << "class " << config_.className << "Test {\n"
+                   "private:\n"
+                   "    int passedTests;\n"
+                   "    int failedTests;\n\n"
+                   "    void assert(bool condition, const std::string& testName);\n\n"
+                   "public:\n"
+                   "    " << config_.className << "Test();\n"
+                   "    ~" << config_.className << "Test();\n\n"
+                   "    int runAllTests();\n"
+                   "    void testBasicFunctionality();\n"
+                   "    void testEdgeCases();\n"
+                   "    void printResults();\n"
+                   "};\n";
     }
     
     void generateImplementationFile() {
         std::string filename = config_.name + "/src/" + config_.name + ".cpp";
-        std::string content = "#include \"../include/" + config_.name + ".h\"\n"
-                             "#include <iostream>\n"
-                             "#include <stdexcept>\n\n";
+        TextBuilder content = arena_.builder(sizeHint(1536, 12));
+        content << "#include \"../include/" << config_.name << ".h\"\n"
+                   "#include <iostream>\n"
+                   "#include <stdexcept>\n\n";
         
         switch (config_.type) {
             case ProjectType::CONSOLE_APP:
             case ProjectType::GUI_APP:
-                content += generateAppImplementation();
+                generateAppImplementation(content);
                 break;
             case ProjectType::STATIC_LIBRARY:
             case ProjectType::SHARED_LIBRARY:
-                content += generateLibraryImplementation();
+                generateLibraryImplementation(content);
                 break;
             case ProjectType::UNIT_TEST:
-                content += generateTestImplementation();
+                generateTestImplementation(content);
                 break;
         }
         
         writeFile(filename, content);
     }
     
-    std::string generateAppImplementation() {
-        return config_.className + "::" + config_.className + "()\n"
-               "    : appName(\"" + config_.className + "\"), isRunning(false) {\n"
-               "    // Constructor implementation\n"
-               "}\n\n"
-               + config_.className + "::~" + config_.className + "() {\n"
-               "    cleanup();\n"
-               "}\n\n"
-               "int " + config_.className + "::run() {\n"
-               "    try {\n"
-               "        initialize();\n"
-               "        isRunning = true;\n"
-               "        \n"
-               "        std::cout << \"Running " + config_.description + "...\" << std::endl;\n"
-               "        \n"
-               "        // Main application loop\n"
-               "        while (isRunning) {\n"
-               "            update();\n"
-               "            // TODO: Implement main logic: " + config_.goal + "\n"
-               "            break; // Remove this for continuous running\n"
-               "        }\n"
-               "        \n"
-               "        return 0;\n"
-               "    } catch (const std::exception& e) {\n"
-               "        std::cerr << \"Error: \" << e.what() << std::endl;\n"
-               "        return 1;\n"
-               "    }\n"
-               "}\n\n"
-               "void " + config_.className + "::initialize() {\n"
-               "    std::cout << \"Initializing \" << appName << \"...\" << std::endl;\n"
-               "    // TODO: Add initialization logic\n"
-               "}\n\n"
-               "void " + config_.className + "::update() {\n"
-               "    // TODO: Add update logic\n"
-               "}\n\n"
-               "void " + config_.className + "::cleanup() {\n"
-               "    std::cout << \"Cleaning up \" << appName << \"...\" << std::endl;\n"
-               "    // TODO: Add cleanup logic\n"
-               "}\n\n"
-               "void " + config_.className + "::shutdown() {\n"
-               "    isRunning = false;\n"
-               "}\n";
+    void generateAppImplementation(TextBuilder& content) {
+        content << config_.className << "::" << config_.className << "()\n"
+                   "    : appName(\"" << config_.className << "\"), isRunning(false) {\n"
+                   "    // Constructor implementation\n"
+                   "}\n\n"
+                << config_.className << "::~" << config_.className << "() {\n"
+                   "    cleanup();\n"
+                   "}\n\n"
+                   "int " << config_.className << "::run() {\n"
+                   "    try {\n"
+                   "        initialize();\n"
+                   "        isRunning = true;\n"
+                   "        \n"
+                   "        std::cout << \"Running " << config_.description << "...\" << std::endl;\n"
+                   "        \n"
+                   "        // Main application loop\n"
+                   "        while (isRunning) {\n"
+                   "            update();\n"
+                   "            // TODO: Implement main logic: " << config_.goal << "\n"
+                   "            break; // Remove this for continuous running\n"
+                   "        }\n"
+                   "        \n"
+                   "        return 0;\n"
+                   "    } catch (const std::exception& e) {\n"
+                   "        std::cerr << \"Error: \" << e.what() << std::endl;\n"
+                   "        return 1;\n"
+                   "    }\n"
+                   "}\n\n"
+                   "void " << config_.className << "::initialize() {\n"
+                   "    std::cout << \"Initializing \" << appName << \"...\" << std::endl;\n"
+                   "    // TODO: Add initialization logic\n"
+                   "}\n\n"
+                   "void " << config_.className << "::update() {\n"
+                   "    // TODO: Add update logic\n"
+                   "}\n\n"
+                   "void " << config_.className << "::cleanup() {\n"
+                   "    std::cout << \"Cleaning up \" << appName << \"...\" << std::endl;\n"
+                   "    // TODO: Add cleanup logic\n"
+                   "}\n\n"
+                   "void " << config_.className << "::shutdown() {\n"
+                   "    isRunning = false;\n"
+                   "}\n";
     }
     
-    std::string generateLibraryImplementation() {
-        return config_.className + "::" + config_.className + "() {\n"
-               "    // Constructor implementation\n"
-               "}\n\n"
-               + config_.className + "::~" + config_.className + "() {\n"
-               "    // Destructor implementation\n"
-               "}\n\n"
-               "void " + config_.className + "::process() {\n"
-               "    std::cout << \"Processing with " + config_.className + "...\" << std::endl;\n"
-               "    // TODO: Implement core functionality: " + config_.goal + "\n"
-               "}\n\n"
-               "std::string " + config_.className + "::getVersion() const {\n"
-               "    return \"" + config_.version + "\";\n"
-               "}\n\n"
-               "// Utility functions implementation\n"
-               "namespace " + StringUtils::toLower(config_.className) + "_utils {\n"
-               "    void helperFunction() {\n"
-               "        // TODO: Implement helper functionality\n"
-               "    }\n"
-               "}\n";
+    void generateLibraryImplementation(TextBuilder& content) {
+        content << config_.className << "::" << config_.className << "() {\n"
+                   "    // Constructor implementation\n"
+                   "}\n\n"
+                << config_.className << "::~" << config_.className << "() {\n"
+                   "    // Destructor implementation\n"
+                   "}\n\n"
+                   "void " << config_.className << "::process() {\n"
+                   "    std::cout << \"Processing with " << config_.className << "...\" << std::endl;\n"
+                   "    // TODO: Implement core functionality: " << config_.goal << "\n"
+                   "}\n\n"
+                   "std::string " << config_.className << "::getVersion() const {\n"
+                   "    return \"" << config_.version << "\";\n"
+                   "}\n\n"
+                   "// Utility functions implementation\n"
+                   "namespace ";
+        content.appendLower(config_.className) << "_utils {\n"
+                   "    void helperFunction() {\n"
+                   "        // TODO: Implement helper functionality\n"
+                   "    }\n"
+                   "}\n";
     }
     
-    std::string generateTestImplementation() {
-        return config_.className + "Test::" + config_.className + "Test()\n"
-               "    : passedTests(0), failedTests(0) {\n"
-               "    // Test constructor\n"
-               "}\n\n"
-               + config_.className + "Test::~" + config_.className + "Test() {\n"
-               "    // Test destructor\n"
-               "}\n\n"
-               "int " + config_.className + "Test::runAllTests() {\n"
-               "    std::cout << \"Running all tests for " + config_.className + "...\" << std::endl;\n"
-               "    \n"
-               "    testBasicFunctionality();\n"
-               "    testEdgeCases();\n"
-               "    \n"
-               "    printResults();\n"
-               "    return (failedTests == 0) ? 0 : 1;\n"
-               "}\n\n"
-               "void " + config_.className + "Test::testBasicFunctionality() {\n"
-               "    // TODO: Implement basic functionality tests\n"
-               "    assert(true, \"Basic functionality test\");\n"
-               "}\n\n"
-               "void " + config_.className + "Test::testEdgeCases() {\n"
-               "    // TODO: Implement edge case tests\n"
-               "    assert(true, \"Edge cases test\");\n"
-               "}\n\n"
-               "void " + config_.className + "Test::assert(bool condition, const std::string& testName) {\n"
-               "    if (condition) {\n"
-               "        std::cout << \"[PASS] \" << testName << std::endl;\n"
-               "        passedTests++;\n"
-               "    } else {\n"
-               "        std::cout << \"[FAIL] \" << testName << std::endl;\n"
-               "        failedTests++;\n"
-               "    }\n"
-               "}\n\n"
-               "void " + config_.className + "Test::printResults() {\n"
-               "    std::cout << \"\\nTest Results:\" << std::endl;\n"
-               "    std::cout << \"Passed: \" << passedTests << std::endl;\n"
-               "    std::cout << \"Failed: \" << failedTests << std::endl;\n"
-               "    std::cout << \"Total: \" << (passedTests + failedTests) << std::endl;\n"
-               "}\n";
+    void generateTestImplementation(TextBuilder& content) {
+        content << config_.className << "Test::" << config_.className << "Test()\n"
+                   "    : passedTests(0), failedTests(0) {\n"
+                   "    // Test constructor\n"
+                   "}\n\n"
+                << config_.className << "Test::~" << config_.className << "Test() {\n"
+                   "    // Test destructor\n"
+                   "}\n\n"
+                   "int " << config_.className << "Test::runAllTests() {\n"
+                   "    std::cout << \"Running all tests for " << config_.className << "...\" << std::endl;\n"
+                   "    \n"
+                   "    testBasicFunctionality();\n"
+                   "    testEdgeCases();\n"
+                   "    \n"
+                   "    printResults();\n"
+                   "    return (failedTests == 0) ? 0 : 1;\n"
+                   "}\n\n"
+                   "void " << config_.className << "Test::testBasicFunctionality() {\n"
+                   "    // TODO: Implement basic functionality tests\n"
+                   "    assert(true, \"Basic functionality test\");\n"
+                   "}\n\n"
+                   "void " << config_.className << "Test::testEdgeCases() {\n"
+                   "    // TODO: Implement edge case tests\n"
+                   "    assert(true, \"Edge cases test\");\n"
+                   "}\n\n"
+                   "void " << config_.className << "Test::assert(bool condition, const std::string& testName) {\n"
+                   "    if (condition) {\n"
+                   "        std::cout << \"[PASS] \" << testName << std::endl;\n"
+                   "        passedTests++;\n"
+                   "    } else {\n"
+                   "        std::cout << \"[FAIL] \" << testName << std::endl;\n"
+                   "        failedTests++;\n"
+                   "    }\n"
+                   "}\n\n"
+                   "void " << config_.className << "Test::printResults() {\n"
+                   "    std::cout << \"\\nTest Results:\" << std::endl;\n"
+                   "    std::cout << \"Passed: \" << passedTests << std::endl;\n"
+                   "    std::cout << \"Failed: \" << failedTests << std::endl;\n"
+                   "    std::cout << \"Total: \" << (passedTests + failedTests) << std::endl;\n"
+                   "}\n";
     }
     
     void generateCMakeFile() {
-        std::string filename = config_.name + "/CMakeLists.txt";
-        std::string content = "cmake_minimum_required(VERSION 3.12)\n"
-                             "project(" + config_.name + " VERSION " + config_.version + ")\n\n"
-                             "set(CMAKE_CXX_STANDARD 17)\n"
-                             "set(CMAKE_CXX_STANDARD_REQUIRED ON)\n\n"
-                             "# Include directories\n"
-                             "include_directories(include)\n\n";
-        
-        std::string sources;
-        if (config_.type == ProjectType::CONSOLE_APP || config_.type == ProjectType::GUI_APP) {
-            sources = "    src/main.cpp\n    src/" + config_.name + ".cpp\n";
-            if (config_.includeLikertScale) {
-                sources += "    src/LikertScale.cpp\n";
-            }
-            content += "# Executable\n"
-                      "add_executable(" + config_.name + "\n" + sources + ")\n\n";
-        } else if (config_.type == ProjectType::STATIC_LIBRARY) {
-            sources = "    src/" + config_.name + ".cpp\n";
-            if (config_.includeLikertScale) {
-                sources += "    src/LikertScale.cpp\n";
-            }
-            content += "# Static Library\n"
-                      "add_library(" + config_.name + " STATIC\n" + sources + ")\n\n";
-        } else if (config_.type == ProjectType::SHARED_LIBRARY) {
-            sources = "    src/" + config_.name + ".cpp\n";
-            if (config_.includeLikertScale) {
-                sources += "    src/LikertScale.cpp\n";
-            }
-            content += "# Shared Library\n"
-                      "add_library(" + config_.name + " SHARED\n" + sources + ")\n\n";
-        }
-        
-        if (config_.includeTests) {
-            content += "# Tests\n"
-                      "enable_testing()\n"
-                      "add_executable(" + config_.name + "_tests\n"
-                      "    tests/test_" + config_.name + ".cpp\n"
-                      ")\n"
-                      "add_test(NAME " + config_.name + "_tests COMMAND " + config_.name + "_tests)\n\n";
-        }
-        
-        content += "# Compiler flags\n"
-                  "target_compile_options(" + config_.name + " PRIVATE\n"
-                  "    -Wall -Wextra -Wpedantic\n"
-                  ")\n\n"
-                  "# Installation\n"
-                  "install(TARGETS " + config_.name + " DESTINATION bin)\n"
-                  "install(FILES include/" + config_.name + ".h DESTINATION include)\n";
-        
-        writeFile(filename, content);
+        writeTemplate(config_.name + "/CMakeLists.txt", "CMakeLists.txt");
+        writeTemplate(config_.name + "/CMakePresets.json", "CMakePresets.json");
     }
     
     void generateMakefile() {
-        std::string filename = config_.name + "/Makefile";
-        std::string content = "# Makefile for " + config_.name + "\n\n"
-                             "CXX = g++\n"
-                             "CXXFLAGS = -std=c++17 -Wall -Wextra -Wpedantic -Iinclude\n"
-                             "SRCDIR = src\n"
-                             "OBJDIR = obj\n"
-                             "SOURCES = $(wildcard $(SRCDIR)/*.cpp)\n"
-                             "OBJECTS = $(SOURCES:$(SRCDIR)/%.cpp=$(OBJDIR)/%.o)\n"
-                             "TARGET = " + config_.name + "\n\n"
-                             ".PHONY: all clean debug release\n\n"
-                             "all: $(TARGET)\n\n"
-                             "$(TARGET): $(OBJECTS)\n"
-                             "\t$(CXX) $(OBJECTS) -o $@\n\n"
-                             "$(OBJDIR)/%.o: $(SRCDIR)/%.cpp | $(OBJDIR)\n"
-                             "\t$(CXX) $(CXXFLAGS) -c $< -o $@\n\n"
-                             "$(OBJDIR):\n"
-                             "\tmkdir -p $(OBJDIR)\n\n"
-                             "debug: CXXFLAGS += -g -DDEBUG\n"
-                             "debug: $(TARGET)\n\n"
-                             "release: CXXFLAGS += -O3 -DNDEBUG\n"
-                             "release: $(TARGET)\n\n"
-                             "clean:\n"
-                             "\trm -rf $(OBJDIR) $(TARGET)\n\n"
-                             "install: $(TARGET)\n"
-                             "\tcp $(TARGET) /usr/local/bin/\n";
-        
-        writeFile(filename, content);
+        writeTemplate(config_.name + "/Makefile", "Makefile");
     }
     
     void generateTestFile() {
         if (config_.type == ProjectType::UNIT_TEST) return; // Already handled in main files
         
         std::string filename = config_.name + "/tests/test_" + config_.name + ".cpp";
-        std::string content = "#include \"../include/" + config_.name + ".h\"\n"
-                             "#include <iostream>\n"
-                             "#include <cassert>\n\n"
-                             "// Simple test framework - consider using Google Test, Catch2, or similar\n\n"
-                             "void test_" + StringUtils::toLower(config_.className) + "_creation() {\n"
-                             "    " + config_.className + " obj;\n"
-                             "    std::cout << \"[PASS] " + config_.className + " creation test\" << std::endl;\n"
-                             "}\n\n"
-                             "void test_" + StringUtils::toLower(config_.className) + "_functionality() {\n"
-                             "    " + config_.className + " obj;\n"
-                             "    // TODO: Add specific functionality tests\n"
-                             "    std::cout << \"[PASS] " + config_.className + " functionality test\" << std::endl;\n"
-                             "}\n\n"
-                             "int main() {\n"
-                             "    std::cout << \"Running tests for " + config_.className + "...\" << std::endl;\n\n"
-                             "    test_" + toLower(config_.className) + "_creation();\n"
-                             "    test_" + toLower(config_.className) + "_functionality();\n\n"
-                             "    std::cout << \"All tests passed!\" << std::endl;\n"
-                             "    return 0;\n"
-                             "}\n";
+        TextBuilder content = arena_.builder(sizeHint(1024, 10));
+        content << "#include \"../include/" << config_.name << ".h\"\n"
+                   "#include <iostream>\n"
+                   "#include <cassert>\n\n"
+                   "// Simple test framework - consider using Google Test, Catch2, or similar\n\n"
+                   "void test_";
+        content.appendLower(config_.className) << "_creation() {\n"
+                   "    " << config_.className << " obj;\n"
+                   "    std::cout << \"[PASS] " << config_.className << " creation test\" << std::endl;\n"
+                   "}\n\n"
+                   "void test_";
+        content.appendLower(config_.className) << "_functionality() {\n"
+                   "    " << config_.className << " obj;\n"
+                   "    // TODO: Add specific functionality tests\n"
+                   "    std::cout << \"[PASS] " << config_.className << " functionality test\" << std::endl;\n"
+                   "}\n\n"
+                   "int main() {\n"
+                   "    std::cout << \"Running tests for " << config_.className << "...\" << std::endl;\n\n"
+                   "    test_";
+        content.appendLower(config_.className) << "_creation();\n"
+                   "    test_";
+        content.appendLower(config_.className) << "_functionality();\n\n"
+                   "    std::cout << \"All tests passed!\" << std::endl;\n"
+                   "    return 0;\n"
+                   "}\n";
         
         writeFile(filename, content);
     }
     
     void generateGitIgnore() {
-        std::string filename = config_.name + "/.gitignore";
-        std::string content = "# Compiled Object files\n"
-                             "*.slo\n*.lo\n*.o\n*.obj\n\n"
-                             "# Precompiled Headers\n"
-                             "*.gch\n*.pch\n\n"
-                             "# Compiled Dynamic libraries\n"
-                             "*.so\n*.dylib\n*.dll\n\n"
-                             "# Fortran module files\n"
-                             "*.mod\n*.smod\n\n"
-                             "# Compiled Static libraries\n"
-                             "*.lai\n*.la\n*.a\n*.lib\n\n"
-                             "# Executables\n"
-                             "*.exe\n*.out\n*.app\n\n"
-                             "# Build directories\n"
-                             "build/\n"
-                             "obj/\n"
-                             "bin/\n\n"
-                             "# IDE files\n"
-                             ".vscode/\n"
-                             ".vs/\n"
-                             "*.vcxproj*\n"
-                             "*.sln\n\n"
-                             "# CMake\n"
-                             "CMakeCache.txt\n"
-                             "CMakeFiles/\n"
-                             "cmake_install.cmake\n"
-                             "Makefile\n\n"
-                             "# Debug files\n"
-                             "*.dSYM/\n"
-                             "*.su\n"
-                             "*.idb\n"
-                             "*.pdb\n\n"
-                             "# Project specific\n"
-                             + config_.name + "\n"
-                             + config_.name + "_tests\n";
-        
-        writeFile(filename, content);
+        writeTemplate(config_.name + "/.gitignore", ".gitignore");
     }
     
     void generateLicense() {
-        std::string filename = config_.name + "/LICENSE";
-        std::map<std::string, std::string> substitutions = {
-            {"{{author}}", config_.author}
-        };
-        std::string content = loader_.getAndSubstitute("LICENSE", substitutions);
-        writeFile(filename, content);
+        writeTemplate(config_.name + "/LICENSE", "LICENSE");
     }
     
     void generateReadme() {
-        std::string filename = config_.name + "/README.md";
-        std::map<std::string, std::string> substitutions = {
-            {"{{project_name}}", config_.className},
-            {"{{description}}", config_.description},
-            {"{{goal}}", config_.goal},
-            {"{{author}}", config_.author}
-        };
-        // For now, we only load the README from the template loader.
-        // The rest of the README is still hardcoded to avoid having to create
-        // an extremely complex template for it.
-        std::string content = loader_.getAndSubstitute("README.md", substitutions);
-        
-        // The rest of the README generation can be added here if needed,
-        // for example, to append the project structure dynamically.
-        
-        writeFile(filename, content);
+        writeTemplate(config_.name + "/README.md", "README.md");
     }
 
 private:
-    std::string generateLikertScaleHeader() {
-        return "#ifndef LIKERT_SCALE_H\n"
-               "#define LIKERT_SCALE_H\n\n"
-               "#include <string>\n"
-               "#include <vector>\n\n"
-               "/**\n"
-               " * @class LikertScale\n"
-               " * @brief A simple class to display a Likert scale question and get a response.\n"
-               " */\n"
-               "class LikertScale {\n"
-               "public:\n"
-               "    /**\n"
-               "     * @brief Construct a new Likert Scale object\n"
-               "     * @param question The question to ask the user.\n"
-               "     * @param options The list of options for the scale (e.g., \"Strongly Disagree\" to \"Strongly Agree\").\n"
-               "     */\n"
-               "    LikertScale(const std::string& question, const std::vector<std::string>& options);\n\n"
-               "    /**\n"
-               "     * @brief Displays the question and options, then waits for and validates user input.\n"
-               "     * @return The user's choice as an integer (1-based index).\n"
-               "     */\n"
-               "    int displayAndGetResponse();\n\n"
-               "private:\n"
-               "    std::string question_;\n"
-               "    std::vector<std::string> options_;\n"
-               "};\n\n"
-               "#endif // LIKERT_SCALE_H\n";
-    }
-
-    std::string generateLikertScaleImplementation() {
-        return "#include \"../include/LikertScale.h\"\n"
-               "#include <iostream>\n"
-               "#include <limits>\n\n"
-               "LikertScale::LikertScale(const std::string& question, const std::vector<std::string>& options)\n"
-               "    : question_(question), options_(options) {}\n\n"
-               "int LikertScale::displayAndGetResponse() {\n"
-               "    std::cout << \"\\n\" << question_ << std::endl;\n"
-               "    for (size_t i = 0; i < options_.size(); ++i) {\n"
-               "        std::cout << \"  \" << (i + 1) << \". \" << options_[i] << std::endl;\n"
-               "    }\n\n"
-               "    int response = 0;\n"
-               "    while (true) {\n"
-               "        std::cout << \"Enter your choice (1-\" << options_.size() << \"): \";\n"
-               "        std::cin >> response;\n\n"
-               "        if (std::cin.good() && response >= 1 && response <= static_cast<int>(options_.size())) {\n"
-               "            // Clear the input buffer\n"
-               "            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\\n');\n"
-               "            return response;\n"
-               "        } else {\n"
-               "            std::cin.clear();\n"
-               "            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\\n');\n"
-               "            std::cout << \"Invalid input. Please enter a number between 1 and \" << options_.size() << \".\" << std::endl;\n"
-               "        }\n"
-               "    }\n"
-               "}\n";
-    }
-
-    std::string generateDataDictionary() {
-        return "# Data Dictionary for " + config.name + "\n\n"
-               "This document describes the format of the data files generated by this application.\n\n"
-               "## File Naming Convention\n\n"
-               "Data files are named using the following convention:\n"
-               "`<participant_id>_<session_id>_<timestamp>.csv`\n\n"
-               "## Data Columns\n\n"
-               "| Column Name      | Data Type | Description                                        |\n"
-               "|------------------|-----------|----------------------------------------------------|\n"
-               "| `participant_id` | string    | Unique identifier for the participant.             |\n"
-               "| `timestamp`      | string    | ISO 8601 timestamp of the event.                   |\n"
-               "| `event_type`     | string    | The type of event being logged (e.g., 'response'). |\n"
-               "| `event_data`     | JSON      | A JSON object containing event-specific data.      |\n\n"
-               "--- \n"
-               "*This is a template. Please update it to reflect the actual data your application will generate.*";
-    }
-
-    std::string generatePrivacyPolicy() {
-        return "# Privacy Policy for " + config.name + "\n\n"
-               "**Last Updated:** [Date]\n\n"
-               "This privacy policy explains how " + config.author + " collects, uses, and protects your data in relation to the " + config.name + " application.\n\n"
-               "## 1. Data We Collect\n\n"
-               "This application collects the following data:\n"
-               "- **[List of data collected, e.g., survey responses, reaction times, etc.]**\n"
-               "- **[Specify if any personally identifiable information (PII) is collected]**\n\n"
-               "## 2. How We Use Your Data\n\n"
-               "Your data is used for the following research purposes:\n"
-               "- **[Primary research goal, e.g., To study the effects of X on Y]**\n"
-               "- **[Secondary research goals]**\n\n"
-               "## 3. Data Storage and Security\n\n"
-               "All data is stored locally on your device in the following location: `[Specify data storage path]`. "
-               "We take reasonable measures to protect your data, including **[mention any security measures like encryption, if applicable]**.\n\n"
-               "## 4. Data Sharing\n\n"
-               "We will not share your personally identifiable data with third parties without your explicit consent. Anonymized, aggregated data may be shared with the broader scientific community or published in academic journals.\n\n"
-               "## 5. Your Rights\n\n"
-               "You have the right to:\n"
-               "- Access your data at any time.\n"
-               "- Request the deletion of your data.\n"
-               "- Withdraw from the study at any time without penalty.\n\n"
-               "## 6. Contact Us\n\n"
-               "If you have any questions about this privacy policy, please contact us at **[Your Contact Email or Information]**.\n";
+    void generateLikertScaleImplementation() {
+        TextBuilder content = arena_.builder(sizeHint(1152, 0));
+        content << "#include \"../include/LikertScale.h\"\n"
+                   "#include <iostream>\n"
+                   "#include <limits>\n\n"
+                   "LikertScale::LikertScale(const std::string& question, const std::vector<std::string>& options)\n"
+                   "    : question_(question), options_(options) {}\n\n"
+                   "int LikertScale::displayAndGetResponse() {\n"
+                   "    std::cout << \"\\n\" << question_ << std::endl;\n"
+                   "    for (size_t i = 0; i < options_.size(); ++i) {\n"
+                   "        std::cout << \"  \" << (i + 1) << \". \" << options_[i] << std::endl;\n"
+                   "    }\n\n"
+                   "    int response = 0;\n"
+                   "    while (true) {\n"
+                   "        std::cout << \"Enter your choice (1-\" << options_.size() << \"): \";\n"
+                   "        std::cin >> response;\n\n"
+                   "        if (std::cin.good() && response >= 1 && response <= static_cast<int>(options_.size())) {\n"
+                   "            // Clear the input buffer\n"
+                   "            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\\n');\n"
+                   "            return response;\n"
+                   "        } else {\n"
+                   "            std::cin.clear();\n"
+                   "            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\\n');\n"
+                   "            std::cout << \"Invalid input. Please enter a number between 1 and \" << options_.size() << \".\" << std::endl;\n"
+                   "        }\n"
+                   "    }\n"
+                   "}\n";
+        writeFile(config_.name + "/src/LikertScale.cpp", content);
+    }
+
+    void generateDataDictionary() {
+        TextBuilder content = arena_.builder(sizeHint(1024, 0));
+        content << "# Data Dictionary for " << config_.name << "\n\n"
+                   "This document describes the format of the data files generated by this application.\n\n"
+                   "## File Naming Convention\n\n"
+                   "Data files are named using the following convention:\n"
+                   "`<participant_id>_<session_id>_<timestamp>.csv`\n\n"
+                   "## Data Columns\n\n"
+                   "| Column Name      | Data Type | Description                                        |\n"
+                   "|------------------|-----------|----------------------------------------------------|\n"
+                   "| `participant_id` | string    | Unique identifier for the participant.             |\n"
+                   "| `timestamp`      | string    | ISO 8601 timestamp of the event.                   |\n"
+                   "| `event_type`     | string    | The type of event being logged (e.g., 'response'). |\n"
+                   "| `event_data`     | JSON      | A JSON object containing event-specific data.      |\n\n"
+                   "--- \n"
+                   "*This is a template. Please update it to reflect the actual data your application will generate.*";
+        writeFile(config_.name + "/data_dictionary.md", content);
+    }
+
+    void generatePrivacyPolicy() {
+        TextBuilder content = arena_.builder(sizeHint(1536, 0));
+        content << "# Privacy Policy for " << config_.name << "\n\n"
+                   "**Last Updated:** [Date]\n\n"
+                   "This privacy policy explains how " << config_.author << " collects, uses, and protects your data in relation to the " << config_.name << " application.\n\n"
+                   "## 1. Data We Collect\n\n"
+                   "This application collects the following data:\n"
+                   "- **[List of data collected, e.g., survey responses, reaction times, etc.]**\n"
+                   "- **[Specify if any personally identifiable information (PII) is collected]**\n\n"
+                   "## 2. How We Use Your Data\n\n"
+                   "Your data is used for the following research purposes:\n"
+                   "- **[Primary research goal, e.g., To study the effects of X on Y]**\n"
+                   "- **[Secondary research goals]**\n\n"
+                   "## 3. Data Storage and Security\n\n"
+                   "All data is stored locally on your device in the following location: `[Specify data storage path]`. "
+                   "We take reasonable measures to protect your data, including **[mention any security measures like encryption, if applicable]**.\n\n"
+                   "## 4. Data Sharing\n\n"
+                   "We will not share your personally identifiable data with third parties without your explicit consent. Anonymized, aggregated data may be shared with the broader scientific community or published in academic journals.\n\n"
+                   "## 5. Your Rights\n\n"
+                   "You have the right to:\n"
+                   "- Access your data at any time.\n"
+                   "- Request the deletion of your data.\n"
+                   "- Withdraw from the study at any time without penalty.\n\n"
+                   "## 6. Contact Us\n\n"
+                   "If you have any questions about this privacy policy, please contact us at **[Your Contact Email or Information]**.\n";
+        writeFile(config_.name + "/PRIVACY_POLICY.md", content);
     }
 };
 
@@ -847,17 +776,294 @@ ProjectConfig getProjectConfig() {
     return config;
 }
 
+namespace {
+
+// What happened to one project of a manifest.
+struct ManifestOutcome {
+    std::size_t files = 0;
+    std::size_t unchanged = 0;
+    std::string error;
+};
+
+// "could not create a/b: reason (and 2 more)"
+std::string describeFailures(const std::vector<std::pair<std::string, std::string>>& failures) {
+    std::string error = "could not create " + failures[0].first + ": " + failures[0].second;
+    if (failures.size() > 1) {
+        error += " (and " + std::to_string(failures.size() - 1) + " more)";
+    }
+    return error;
+}
+
+// One task per project on `jobs` threads; each task writes its own project's
+// files, since the projects already keep the cores busy. Files are renamed
+// into place and the filesystem is synced once after the last project.
+// Returns the bytes written.
+std::size_t writeManifestProjects(const std::vector<ManifestProject>& projects, std::vector<ManifestOutcome>& outcomes,
+                                  const TemplateLoader& loader, std::size_t jobs, double& sync_ms) {
+    std::vector<std::size_t> bytes(projects.size(), 0);
+    ThreadPool pool(jobs);
+    std::vector<std::future<void>> done;
+    for (std::size_t i = 0; i < projects.size(); ++i) {
+        if (!outcomes[i].error.empty()) {
+            continue;
+        }
+        done.push_back(pool.submit([&projects, &outcomes, &bytes, &loader, i]() {
+            ManifestOutcome& outcome = outcomes[i];
+            try {
+                TemplateGenerator generator(projects[i].config, loader);
+                OutputPlan plan = generator.planProject();
+                plan.setWriteMode(OutputPlan::WriteMode::Atomic);
+                OutputPlan::Report report = plan.writeIncremental(projects[i].config.name, 1);
+                outcome.files = report.written.size();
+                outcome.unchanged = report.unchanged.size();
+                bytes[i] = report.bytes;
+                if (!report.failures.empty()) {
+                    outcome.error = describeFailures(report.failures);
+                }
+            } catch (const std::exception& e) {
+                outcome.error = e.what();
+            }
+        }));
+    }
+    for (std::future<void>& project : done) {
+        project.get();
+    }
+
+    std::size_t total = 0;
+    for (std::size_t size : bytes) {
+        total += size;
+    }
+    auto first_written = std::find_if(outcomes.begin(), outcomes.end(), [](const ManifestOutcome& outcome) {
+        return outcome.error.empty() && outcome.files > 0;
+    });
+    if (first_written != outcomes.end()) {
+        auto started = std::chrono::steady_clock::now();
+        try {
+            OutputPlan::syncFilesystem(projects[first_written - outcomes.begin()].config.name);
+        } catch (const std::exception& e) {
+            for (ManifestOutcome& outcome : outcomes) {
+                if (outcome.error.empty() && outcome.files > 0) {
+                    outcome.error = std::string("sync failed: ") + e.what();
+                }
+            }
+        }
+        sync_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    }
+    return total;
+}
+
+// Plans every project, then renders the combined plan on `jobs` threads and
+// streams it into the archive in manifest order. Returns the bytes archived.
+std::size_t archiveManifestProjects(const std::vector<ManifestProject>& projects, std::vector<ManifestOutcome>& outcomes,
+                                    const TemplateLoader& loader, std::size_t jobs, TarWriter& archive) {
+    std::vector<std::unique_ptr<TemplateGenerator>> generators;
+    std::map<std::string, std::size_t> owner;  // Project name, i.e. first path component -> index
+    OutputPlan combined;
+    for (std::size_t i = 0; i < projects.size(); ++i) {
+        if (!outcomes[i].error.empty()) {
+            continue;
+        }
+        // readProjectManifest rejects duplicate names; a second project with
+        // the same name would add duplicate entries to the archive.
+        auto claimed = owner.emplace(projects[i].config.name, i);
+        if (!claimed.second) {
+            outcomes[i].error = "project name '" + projects[i].config.name + "' is already used on line " +
+                                std::to_string(projects[claimed.first->second].line);
+            continue;
+        }
+        try {
+            generators.push_back(std::make_unique<TemplateGenerator>(projects[i].config, loader));
+            combined.append(generators.back()->planProject());
+        } catch (const std::exception& e) {
+            outcomes[i].error = e.what();
+            owner.erase(claimed.first);
+        }
+    }
+
+    OutputPlan::Report report = combined.writeArchive(archive, jobs);
+    // Every planned path lies in its project's directory; a path that does
+    // not is reported on its own rather than credited to some project.
+    auto ownerOf = [&owner](const std::string& path) -> const std::size_t* {
+        auto found = owner.find(path.substr(0, path.find('/')));
+        return found != owner.end() ? &found->second : nullptr;
+    };
+    for (const std::string& path : report.written) {
+        if (const std::size_t* project = ownerOf(path)) {
+            ++outcomes[*project].files;
+        }
+    }
+    std::map<std::size_t, std::vector<std::pair<std::string, std::string>>> failures;
+    for (const auto& failure : report.failures) {
+        if (const std::size_t* project = ownerOf(failure.first)) {
+            failures[*project].push_back(failure);
+        } else {
+            std::cerr << "Error: Could not archive " << failure.first << ": " << failure.second << std::endl;
+        }
+    }
+    for (const auto& project : failures) {
+        outcomes[project.first].error = describeFailures(project.second);
+    }
+    return report.bytes;
+}
+
+} // namespace
+
+// Generates every project of a manifest with one shared loader, spread over
+// `jobs` threads, into the filesystem or, if given, into one archive.
+// Returns the number of projects that could not be generated.
+std::size_t generateFromManifest(const std::string& manifest_path, const TemplateLoader& loader, std::size_t jobs,
+                                 TarWriter* archive) {
+    auto started = std::chrono::steady_clock::now();
+    std::vector<ManifestProject> projects = readProjectManifest(manifest_path);
+    // Threads beyond one per project would only sit idle.
+    jobs = std::max<std::size_t>(1, std::min(jobs, projects.size()));
+    std::vector<ManifestOutcome> outcomes(projects.size());
+    for (std::size_t i = 0; i < projects.size(); ++i) {
+        outcomes[i].error = projects[i].error;
+    }
+    double sync_ms = 0.0;
+    const std::size_t bytes = archive ? archiveManifestProjects(projects, outcomes, loader, jobs, *archive)
+                                      : writeManifestProjects(projects, outcomes, loader, jobs, sync_ms);
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    std::size_t generated = 0;
+    std::size_t files = 0;
+    std::size_t unchanged = 0;
+    for (const ManifestOutcome& outcome : outcomes) {
+        generated += outcome.error.empty() ? 1 : 0;
+        files += outcome.files;
+        unchanged += outcome.unchanged;
+    }
+    std::cout << (archive ? "Archived " : "Generated ") << generated << " of " << projects.size()
+              << " project(s) from " << manifest_path << ": " << files << " files, " << bytes << " bytes"
+              << (unchanged ? ", " + std::to_string(unchanged) + " files unchanged" : std::string()) << " in "
+              << seconds * 1000.0 << " ms" << (archive ? "" : " (sync " + std::to_string(sync_ms) + " ms)") << "\n";
+    if (seconds > 0.0) {
+        std::cout << "Throughput: " << generated / seconds << " projects/s, " << files / seconds << " files/s on "
+                  << jobs << " thread(s)\n";
+    }
+    if (generated < projects.size()) {
+        std::cerr << "\nFailed projects:\n";
+        for (std::size_t i = 0; i < projects.size(); ++i) {
+            if (!outcomes[i].error.empty()) {
+                const std::string& name = projects[i].config.name;
+                std::cerr << "  line " << projects[i].line << (name.empty() ? "" : " (" + name + ")") << ": "
+                          << outcomes[i].error << "\n";
+            }
+        }
+    }
+    return projects.size() - generated;
+}
+
+// Parses the value of --jobs: decimal digits and nothing else, so that "-1"
+// cannot wrap around to a huge thread count. 0 means one thread per core.
+bool parseJobs(std::string_view text, std::size_t& jobs) {
+    if (text.empty() || text.front() == '-') {
+        return false;
+    }
+    const char* end = text.data() + text.size();
+    auto [stop, error] = std::from_chars(text.data(), end, jobs);
+    return error == std::errc() && stop == end;
+}
+
+// Archive entries carry one timestamp: SOURCE_DATE_EPOCH when set, for
+// reproducible archives, and otherwise the current time.
+std::int64_t archiveTime() {
+    if (const char* epoch = std::getenv("SOURCE_DATE_EPOCH")) {
+        try {
+            return std::stoll(epoch);
+        } catch (const std::exception&) {
+            std::cerr << "Warning: ignoring invalid SOURCE_DATE_EPOCH '" << epoch << "'" << std::endl;
+        }
+    }
+    return static_cast<std::int64_t>(std::time(nullptr));
+}
+
 #ifndef TEMPLATE_GENERATOR_TEST
-int main() {
+int main(int argc, char* argv[]) {
     try {
+        // The default templates are compiled in (see template_embedder);
+        // --templates loads a custom SQL file, directory or pattern instead.
+        // --manifest generates every project listed in a CSV or JSON Lines
+        // file instead of asking for one. --archive writes one tar stream
+        // instead of files; with "-" the archive goes to stdout, and every
+        // message, prompts included, to stderr.
+        std::string template_path;
+        std::string manifest_path;
+        std::string archive_path;
+        std::size_t jobs = 0;
+        auto usage = [&argv]() {
+            std::cerr << "Usage: " << argv[0] << " [--templates <file.sql|directory|pattern>]"
+                      << " [--manifest <projects.csv|projects.jsonl> [--jobs <n>]]"
+                      << " [--archive <file.tar|->]" << std::endl;
+            return 1;
+        };
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--templates" && i + 1 < argc) {
+                template_path = argv[++i];
+            } else if (arg.rfind("--templates=", 0) == 0) {
+                template_path = arg.substr(std::string("--templates=").size());
+            } else if (arg == "--manifest" && i + 1 < argc) {
+                manifest_path = argv[++i];
+            } else if (arg.rfind("--manifest=", 0) == 0) {
+                manifest_path = arg.substr(std::string("--manifest=").size());
+            } else if (arg == "--archive" && i + 1 < argc) {
+                archive_path = argv[++i];
+            } else if (arg.rfind("--archive=", 0) == 0) {
+                archive_path = arg.substr(std::string("--archive=").size());
+            } else if ((arg == "--jobs" && i + 1 < argc) || arg.rfind("--jobs=", 0) == 0) {
+                std::string value = arg == "--jobs" ? argv[++i] : arg.substr(std::string("--jobs=").size());
+                if (!parseJobs(value, jobs)) {
+                    std::cerr << "Error: --jobs takes a number of threads, not '" << value << "'" << std::endl;
+                    return usage();
+                }
+            } else {
+                return usage();
+            }
+        }
+
+        // A run only renders a few templates, so SQL bodies are decoded on first use.
+        std::unique_ptr<TemplateLoader> loader = template_path.empty()
+            ? std::make_unique<TemplateLoader>(kDefaultTemplates)
+            : std::make_unique<TemplateLoader>(template_path, LoadMode::Lazy);
+
+        std::unique_ptr<std::ostream> archive_stream;
+        if (archive_path == "-") {
+            archive_stream = std::make_unique<std::ostream>(std::cout.rdbuf(std::cerr.rdbuf()));
+        } else if (!archive_path.empty()) {
+            archive_stream = std::make_unique<std::ofstream>(archive_path, std::ios::binary);
+            if (!*archive_stream) {
+                throw std::runtime_error("Could not create archive: " + archive_path);
+            }
+        }
+        std::unique_ptr<OstreamSink> archive_sink;
+        std::unique_ptr<TarWriter> archive;
+        if (archive_stream) {
+            archive_sink = std::make_unique<OstreamSink>(*archive_stream);
+            archive = std::make_unique<TarWriter>(*archive_sink, archiveTime());
+        }
+
+        if (!manifest_path.empty()) {
+            std::size_t failed = generateFromManifest(
+                manifest_path, *loader, jobs == 0 ? ThreadPool::defaultThreadCount() : jobs, archive.get());
+            if (archive) {
+                archive->finish();
+            }
+            return failed == 0 ? 0 : 1;
+        }
+
         ProjectConfig config = getProjectConfig();
-        
-        // Load templates from the SQL data file
-        TemplateLoader loader("SQL/data.sql");
 
         // Create the generator and run it
-        TemplateGenerator generator(config, loader);
+        TemplateGenerator generator(config, *loader, archive.get());
         generator.generateProject();
+        if (archive) {
+            archive->finish();
+            std::cout << "\nArchive written to " << (archive_path == "-" ? "stdout" : archive_path) << " ("
+                      << archive->bytesWritten() << " bytes); extract it with tar -xf\n";
+        }
         
         std::cout << "\n=== Generation Complete ===\n";
         std::cout << "Your '" << config.description << "' project is ready!\n";
@@ -0,0 +1,51 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "TemplateLoader.h"
+#include "TemplateBundle.h"
+#include "TemplatePrecompiler.h"
+
+/**
+ * Template Precompiler
+ *
+ * Compiles templates into C++ render functions over ProjectConfig, so the
+ * hottest templates render without any placeholder lookup:
+ *
+ *   template_precompiler [input.sql] [output.h] [file_path ...]
+ *
+ * Defaults to SQL/data.sql -> src/PrecompiledTemplates.h, defining
+ * kPrecompiledTemplates. When file paths are given, only templates with
+ * those paths are compiled (list the partials they include as well);
+ * otherwise every template is. Placeholders that name no ProjectConfig
+ * field are reported and kept as literal text. Branches and loops are
+ * compiled too, so every selected template is precompiled.
+ */
+
+int main(int argc, char* argv[]) {
+    try {
+        std::string input = argc > 1 ? argv[1] : "SQL/data.sql";
+        std::string output = argc > 2 ? argv[2] : "src/PrecompiledTemplates.h";
+        std::vector<std::string> selected(argv + std::min(argc, 3), argv + argc);
+
+        TemplateLoader loader(input);
+        std::vector<BundleRecord> records;
+        loader.forEachTemplate([&](std::string_view project_name, std::string_view file_path, std::string_view content) {
+            if (selected.empty() || std::find(selected.begin(), selected.end(), file_path) != selected.end()) {
+                records.push_back({std::string(project_name), std::string(file_path), std::string(content)});
+            }
+        });
+
+        PrecompileReport report = writePrecompiledTemplates(output, records, "kPrecompiledTemplates", input);
+        for (const std::string& placeholder : report.unresolved) {
+            std::cerr << "Warning: No ProjectConfig field for " << placeholder << "; kept as text" << std::endl;
+        }
+        std::cout << "Precompiled " << records.size() << " template(s) from " << input
+                  << " into " << output << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}